@@ -0,0 +1,33 @@
+include(FindPackageHandleStandardArgs)
+
+find_library(FFmpeg_avformat_LIBRARY NAMES avformat)
+find_library(FFmpeg_avcodec_LIBRARY NAMES avcodec)
+find_library(FFmpeg_avutil_LIBRARY NAMES avutil)
+find_path(FFmpeg_INCLUDE_DIR NAMES libavformat/avformat.h)
+
+find_package_handle_standard_args(
+    FFmpeg
+    REQUIRED_VARS
+        FFmpeg_avformat_LIBRARY
+        FFmpeg_avcodec_LIBRARY
+        FFmpeg_avutil_LIBRARY
+        FFmpeg_INCLUDE_DIR
+)
+
+if(FFmpeg_FOUND)
+    mark_as_advanced(FFmpeg_avformat_LIBRARY)
+    mark_as_advanced(FFmpeg_avcodec_LIBRARY)
+    mark_as_advanced(FFmpeg_avutil_LIBRARY)
+    mark_as_advanced(FFmpeg_INCLUDE_DIR)
+endif()
+
+foreach(component avformat avcodec avutil)
+    if(FFmpeg_FOUND AND NOT TARGET FFmpeg::${component})
+        add_library(FFmpeg::${component} UNKNOWN IMPORTED)
+        set_target_properties(
+            FFmpeg::${component} PROPERTIES
+            IMPORTED_LOCATION "${FFmpeg_${component}_LIBRARY}"
+            INTERFACE_INCLUDE_DIRECTORIES "${FFmpeg_INCLUDE_DIR}"
+        )
+    endif()
+endforeach()
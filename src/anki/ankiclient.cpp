@@ -1325,23 +1325,27 @@ void AnkiClient::buildCommonNote(
     /* Add Card Tags */
     note[ANKI_NOTE_TAGS] = m_currentConfig->tags;
 
+    /* Terms searched for without adding them have no player state */
+    static const NoteContext emptyNote;
+    const NoteContext &ctx = exp.note ? *exp.note : emptyNote;
+
     /* Find and replace markers with processed data */
     QString clipboard =
-        QString(exp.clipboard).replace('\n', m_currentConfig->newlineReplacer);
+        QString(ctx.clipboard).replace('\n', m_currentConfig->newlineReplacer);
     QString clozeBody =
-        QString(exp.clozeBody).replace('\n', m_currentConfig->newlineReplacer);
+        exp.clozeBody().replace('\n', m_currentConfig->newlineReplacer);
     QString clozePrefix =
-        QString(exp.clozePrefix).replace('\n', m_currentConfig->newlineReplacer);
+        exp.clozePrefix().replace('\n', m_currentConfig->newlineReplacer);
     QString clozeSuffix =
-        QString(exp.clozeSuffix).replace('\n', m_currentConfig->newlineReplacer);
+        exp.clozeSuffix().replace('\n', m_currentConfig->newlineReplacer);
     QString sentence =
-        QString(exp.sentence).replace('\n', m_currentConfig->newlineReplacer);
+        QString(ctx.sentence).replace('\n', m_currentConfig->newlineReplacer);
     QString sentence2 =
-        QString(exp.sentence2).replace('\n', m_currentConfig->newlineReplacer);
+        QString(ctx.sentence2).replace('\n', m_currentConfig->newlineReplacer);
     QString context =
-        QString(exp.context).replace('\n', m_currentConfig->newlineReplacer);
+        QString(ctx.context).replace('\n', m_currentConfig->newlineReplacer);
     QString context2 =
-        QString(exp.context2).replace('\n', m_currentConfig->newlineReplacer);
+        QString(ctx.context2).replace('\n', m_currentConfig->newlineReplacer);
 
     QString frequencies = buildFrequencies(exp.frequencies);
     const int frequencyHarmonic = getFrequencyHarmonic(exp.frequencies);
@@ -1380,7 +1384,7 @@ void AnkiClient::buildCommonNote(
         }
         value.replace(REPLACE_SCREENSHOT_VIDEO, "");
 
-        value.replace(REPLACE_TITLE,        exp.title);
+        value.replace(REPLACE_TITLE,        ctx.title);
         value.replace(REPLACE_CLIPBOARD,    clipboard);
         value.replace(REPLACE_CLOZE_BODY,   clozeBody);
         value.replace(REPLACE_CLOZE_PREFIX, clozePrefix);
@@ -1423,8 +1427,8 @@ void AnkiClient::buildCommonNote(
             PlayerAdapter *player =
                 GlobalMediator::getGlobalMediator()->getPlayerAdapter();
 
-            double startTime = exp.startTime - m_currentConfig->audioPadStart;
-            double endTime = exp.endTime + m_currentConfig->audioPadEnd;
+            double startTime = ctx.startTime - m_currentConfig->audioPadStart;
+            double endTime = ctx.endTime + m_currentConfig->audioPadEnd;
 
             QString path;
             if (startTime >= 0 && endTime >= 0 && startTime < endTime)
@@ -1454,8 +1458,8 @@ void AnkiClient::buildCommonNote(
                 GlobalMediator::getGlobalMediator()->getPlayerAdapter();
 
             double startTime =
-                exp.startTimeContext - m_currentConfig->audioPadStart;
-            double endTime = exp.endTimeContext + m_currentConfig->audioPadEnd;
+                ctx.startTimeContext - m_currentConfig->audioPadStart;
+            double endTime = ctx.endTimeContext + m_currentConfig->audioPadEnd;
 
             QString path;
             if (startTime >= 0 && endTime >= 0 && startTime < endTime)
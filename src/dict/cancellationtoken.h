@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <QAtomicInt>
+
+#include <memory>
+
+class CancellationSource;
+
+/**
+ * A handle a worker thread can check to see if the work it is doing has been
+ * superseded. Cheap to copy and safe to check from any thread.
+ */
+class CancellationToken
+{
+public:
+    /**
+     * Constructs a token that is never cancelled.
+     */
+    CancellationToken() = default;
+
+    /**
+     * Returns if the work this token belongs to has been cancelled.
+     * @return true if cancelled, false otherwise.
+     */
+    [[nodiscard]]
+    inline bool isCancelled() const
+    {
+        return m_generation && m_generation->loadAcquire() != m_expected;
+    }
+
+private:
+    friend class CancellationSource;
+
+    /**
+     * Constructs a token belonging to a source.
+     * @param generation The generation counter of the source.
+     * @param expected   The generation the token was created at.
+     */
+    CancellationToken(
+        std::shared_ptr<const QAtomicInt> generation,
+        int expected)
+        : m_generation(std::move(generation)),
+          m_expected(expected) {}
+
+    /* The generation counter of the source. nullptr if never cancelled. */
+    std::shared_ptr<const QAtomicInt> m_generation;
+
+    /* The generation this token was created at */
+    int m_expected{0};
+};
+
+/**
+ * Hands out cancellation tokens. Cancelling bumps an atomic generation
+ * counter, which cancels every token handed out before it.
+ */
+class CancellationSource
+{
+public:
+    CancellationSource() : m_generation(std::make_shared<QAtomicInt>(0)) {}
+
+    /**
+     * Gets a token for the current generation.
+     * @return A token that is cancelled by the next call to cancel().
+     */
+    [[nodiscard]]
+    inline CancellationToken token() const
+    {
+        return CancellationToken(m_generation, m_generation->loadAcquire());
+    }
+
+    /**
+     * Cancels every token handed out so far.
+     */
+    inline void cancel()
+    {
+        m_generation->fetchAndAddOrdered(1);
+    }
+
+private:
+    /* The current generation. Shared with tokens so they outlive the source. */
+    std::shared_ptr<QAtomicInt> m_generation;
+};
+
+#endif // CANCELLATIONTOKEN_H
@@ -21,20 +21,88 @@
 #include "databasemanager.h"
 
 #include <QApplication>
+#include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QMessageBox>
+#include <QReadLocker>
 #include <QVector>
+#include <QWriteLocker>
+#include <QtConcurrent>
 
+#include "termpack.h"
 #include "yomidbbuilder.h"
 
+#include "util/textnormalizer.h"
 #include "util/utils.h"
 
+/* The number of virtual machine instructions between cancellation checks. */
+#define PROGRESS_HANDLER_OPS 1000
+
+/* The cancellation token of the query running on this thread, if any. SQLite
+ * calls the progress handler on the thread stepping the statement, so this
+ * lets lookups sharing one connection be cancelled independently. */
+static thread_local const CancellationToken *t_cancelToken = nullptr;
+
+/**
+ * Calls a function on every space separated word in a string. The words are
+ * not copied, so they are only valid for the duration of the call.
+ * @param str  The null terminated string to split. May be NULL.
+ * @param func Called with each nonempty word.
+ */
+template <typename Function>
+static inline void forEachWord(const char *str, Function func)
+{
+    if (str == NULL)
+    {
+        return;
+    }
+    const char *start = str;
+    for (const char *it = str; ; ++it)
+    {
+        if (*it != ' ' && *it != '\0')
+        {
+            continue;
+        }
+        if (it != start)
+        {
+            func(QByteArray::fromRawData(start, it - start));
+        }
+        if (*it == '\0')
+        {
+            break;
+        }
+        start = it + 1;
+    }
+}
+
+/**
+ * Gets the code point of a string containing a single character.
+ * @param ch The string to convert.
+ * @return The code point of the character, 0 if ch is not a single character.
+ */
+static inline char32_t toCodePoint(const QString &ch)
+{
+    if (ch.size() == 1)
+    {
+        return ch[0].unicode();
+    }
+    else if (ch.size() == 2 &&
+             ch[0].isHighSurrogate() &&
+             ch[1].isLowSurrogate())
+    {
+        return QChar::surrogateToUcs4(ch[0], ch[1]);
+    }
+    return 0;
+}
+
 /* Begin Constructor/Destructor */
 
-DatabaseManager::DatabaseManager(const QString &path)
-    : m_dbpath(path.toUtf8())
+DatabaseManager::DatabaseManager(const QString &path, StorageProfile profile)
+    : m_dbpath(path.toUtf8()),
+      m_profile(profile)
 {
     if (!sqlite3_threadsafe())
     {
@@ -58,6 +126,10 @@ DatabaseManager::DatabaseManager(const QString &path)
         m_db = nullptr;
         qDebug() << "Could not open dictionary database";
     }
+    else
+    {
+        configureConnection(m_db);
+    }
 
     m_moraSkipChar << "ぁ"
                    << "ぃ"
@@ -77,14 +149,186 @@ DatabaseManager::DatabaseManager(const QString &path)
                    << "ョ";
 
     initCache();
+
+    if (m_db && m_profile != StorageProfile::disk)
+    {
+        m_warmUp = QtConcurrent::run(&DatabaseManager::warmUp, this);
+    }
 }
 
 DatabaseManager::~DatabaseManager()
 {
+    m_stopWarmUp.storeRelease(1);
+    m_warmUp.waitForFinished();
     sqlite3_close_v2(m_db);
 }
 
 /* End Constructor/Destructor */
+/* Begin Storage */
+
+/* The page cache size in KiB used when the database is memory-mapped. */
+#define MAPPED_CACHE_KIB    (64 * 1024)
+
+/* The number of bytes read at a time while warming up the page cache. */
+#define WARM_UP_CHUNK_SIZE  (1024 * 1024)
+
+void DatabaseManager::configureConnection(sqlite3 *db) const
+{
+    sqlite3_progress_handler(
+        db, PROGRESS_HANDLER_OPS, &DatabaseManager::progressHandler, NULL
+    );
+
+    if (m_profile == StorageProfile::mapped)
+    {
+        /* SQLite clamps this to the largest size it was compiled to allow */
+        const qint64 size = QFileInfo(QString::fromUtf8(m_dbpath)).size();
+        const QByteArray mmap =
+            "PRAGMA mmap_size = " + QByteArray::number(size) + ";";
+        const QByteArray cache = "PRAGMA cache_size = " +
+            QByteArray::number(-MAPPED_CACHE_KIB) + ";";
+        if (sqlite3_exec(db, mmap, NULL, NULL, NULL) != SQLITE_OK ||
+            sqlite3_exec(db, cache, NULL, NULL, NULL) != SQLITE_OK)
+        {
+            qDebug() << "Could not memory-map the dictionary database";
+        }
+    }
+}
+
+sqlite3 *DatabaseManager::copyToMemory() const
+{
+    sqlite3 *source = nullptr;
+    sqlite3 *memory = nullptr;
+    sqlite3_backup *backup = nullptr;
+    int step = SQLITE_OK;
+
+    if (sqlite3_open_v2(
+            m_dbpath, &source, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK ||
+        sqlite3_open_v2(
+            ":memory:",
+            &memory,
+            SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX,
+            NULL) != SQLITE_OK)
+    {
+        goto error;
+    }
+
+    backup = sqlite3_backup_init(memory, "main", source, "main");
+    if (backup == nullptr)
+    {
+        goto error;
+    }
+    step = sqlite3_backup_step(backup, -1);
+    sqlite3_backup_finish(backup);
+    if (step != SQLITE_DONE ||
+        sqlite3_exec(memory, "PRAGMA query_only = 1;", NULL, NULL, NULL) !=
+            SQLITE_OK)
+    {
+        goto error;
+    }
+    sqlite3_close_v2(source);
+
+    configureConnection(memory);
+    return memory;
+
+error:
+    qDebug() << "Could not copy the dictionary database into memory";
+    sqlite3_close_v2(source);
+    sqlite3_close_v2(memory);
+    return nullptr;
+}
+
+void DatabaseManager::refreshStorage()
+{
+    if (m_db == nullptr)
+    {
+        return;
+    }
+
+    switch (m_profile)
+    {
+    case StorageProfile::disk:
+        break;
+
+    case StorageProfile::mapped:
+        /* The database may have grown past the old mapping */
+        configureConnection(m_db);
+        break;
+
+    case StorageProfile::memory:
+    {
+        sqlite3 *memory = copyToMemory();
+        if (memory)
+        {
+            sqlite3_close_v2(m_db);
+            m_db = memory;
+            m_inMemory = true;
+        }
+        break;
+    }
+    }
+}
+
+void DatabaseManager::warmUp()
+{
+    switch (m_profile)
+    {
+    case StorageProfile::disk:
+        break;
+
+    case StorageProfile::mapped:
+    {
+        /* Reading the file pulls it into the OS page cache backing the map */
+        QFile file(QString::fromUtf8(m_dbpath));
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            break;
+        }
+        QByteArray buffer(WARM_UP_CHUNK_SIZE, Qt::Uninitialized);
+        while (!m_stopWarmUp.loadAcquire() &&
+               file.read(buffer.data(), buffer.size()) > 0)
+        {
+        }
+        break;
+    }
+
+    case StorageProfile::memory:
+    {
+        /* Hold the read lock so the database can't change during the copy.
+         * Lookups keep using the on disk connection until the copy is done.
+         */
+        sqlite3 *memory = nullptr;
+        {
+            QReadLocker lock(&m_dbLock);
+            if (m_stopWarmUp.loadAcquire() || m_inMemory)
+            {
+                break;
+            }
+            memory = copyToMemory();
+        }
+        if (memory == nullptr)
+        {
+            break;
+        }
+
+        QWriteLocker lock(&m_dbLock);
+        if (m_inMemory)
+        {
+            /* A modification already replaced the connection */
+            sqlite3_close_v2(memory);
+            break;
+        }
+        sqlite3_close_v2(m_db);
+        m_db = memory;
+        m_inMemory = true;
+        break;
+    }
+    }
+}
+
+#undef MAPPED_CACHE_KIB
+#undef WARM_UP_CHUNK_SIZE
+
+/* End Storage */
 /* Begin Initializers */
 
 #define QUERY_DICTIONARY    "SELECT dic_id, title FROM directory;"
@@ -137,7 +381,7 @@ int DatabaseManager::initCache()
     while ((step = sqlite3_step(stmt)) == SQLITE_ROW)
     {
         uint64_t id = sqlite3_column_int64(stmt, COLUMN_DIC_ID);
-        QHash<QString, Tag> &tags = m_tagCache[id];
+        QHash<QByteArray, Tag> &tags = m_tagCache[id];
 
         Tag tag;
         tag.dictionary = m_dictionaryCache[id],
@@ -146,15 +390,22 @@ int DatabaseManager::initCache()
         tag.notes = (const char *)sqlite3_column_text(stmt, COLUMN_NOTES),
         tag.order = sqlite3_column_int(stmt, COLUMN_ORDER),
         tag.score = sqlite3_column_int(stmt, COLUMN_SCORE),
-        tags.insert(tag.name, tag);
-
-        m_tagCache[id] = tags;
+        tags.insert(tag.name.toUtf8(), tag);
     }
     if (isStepError(step))
     {
         ret = -1;
         goto cleanup;
     }
+    sqlite3_finalize(stmt);
+    stmt = NULL;
+
+    /* Build kanji cache. Depends on the dictionary and tag caches. */
+    if (initKanjiCache())
+    {
+        ret = -1;
+        goto cleanup;
+    }
 
 cleanup:
     sqlite3_finalize(stmt);
@@ -172,15 +423,187 @@ cleanup:
 #undef COLUMN_NOTES
 #undef COLUMN_SCORE
 
+#define QUERY_FREQUENCIES   "SELECT dic_id, data, type, expression "\
+                                "FROM kanji_meta_bank "\
+                                "WHERE dic_id NOT IN (SELECT dic_id FROM dict_disabled) AND " \
+                                    "mode = 'freq';"
+#define QUERY_DEFINITIONS   "SELECT dic_id, onyomi, kunyomi, tags, meanings, stats, char "\
+                                "FROM kanji_bank "\
+                                "WHERE dic_id NOT IN (SELECT dic_id FROM dict_disabled);"
+
+#define COLUMN_FREQ_DIC_ID  0
+#define COLUMN_FREQ_CHAR    3
+
+#define COLUMN_DIC_ID       0
+#define COLUMN_ONYOMI       1
+#define COLUMN_KUNYOMI      2
+#define COLUMN_TAGS         3
+#define COLUMN_MEANINGS     4
+#define COLUMN_STATS        5
+#define COLUMN_CHAR         6
+
+#define TAG_NAME_STATS      "misc"
+#define TAG_NAME_CLAS       "class"
+#define TAG_NAME_CODE       "code"
+#define TAG_NAME_INDEX      "index"
+
+int DatabaseManager::initKanjiCache()
+{
+    int           ret  = 0;
+    sqlite3_stmt *stmt = NULL;
+    int           step = 0;
+
+    m_kanjiCache.clear();
+
+    /* Add frequencies */
+    if (sqlite3_prepare_v2(m_db, QUERY_FREQUENCIES, -1, &stmt, NULL) != SQLITE_OK)
+    {
+        ret = -1;
+        goto cleanup;
+    }
+    while ((step = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        QString freqStr;
+        if (!parseFrequency(stmt, QString(), freqStr))
+        {
+            continue;
+        }
+        const char32_t ch = toCodePoint(QString::fromUtf8(
+            (const char *)sqlite3_column_text(stmt, COLUMN_FREQ_CHAR)
+        ));
+        const uint64_t id = sqlite3_column_int64(stmt, COLUMN_FREQ_DIC_ID);
+        m_kanjiCache[ch].frequencies.append(
+            Frequency {getDictionary(id), freqStr, id}
+        );
+    }
+    if (isStepError(step))
+    {
+        ret = -1;
+        goto cleanup;
+    }
+    sqlite3_finalize(stmt);
+    stmt = NULL;
+
+    /* Add definitions */
+    if (sqlite3_prepare_v2(m_db, QUERY_DEFINITIONS, -1, &stmt, NULL) != SQLITE_OK)
+    {
+        ret = -1;
+        goto cleanup;
+    }
+    while ((step = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        const uint64_t id = sqlite3_column_int64(stmt, COLUMN_DIC_ID);
+
+        KanjiDefinition def;
+        def.dictionary = getDictionary(id);
+        def.dictionaryId = id;
+        def.onyomi = QString(
+                (const char *)sqlite3_column_text(stmt, COLUMN_ONYOMI)
+            ).split(' '),
+        def.kunyomi = QString(
+                (const char *)sqlite3_column_text(stmt, COLUMN_KUNYOMI)
+            ).split(' '),
+        def.glossary = jsonArrayToStringList(
+                (const char *)sqlite3_column_text(stmt, COLUMN_MEANINGS)
+            );
+        addTags(
+            id, (const char *)sqlite3_column_text(stmt, COLUMN_TAGS), def.tags
+        );
+
+        const QHash<QByteArray, Tag> tags = m_tagCache.value(id);
+        QVariantMap map = QJsonDocument::fromJson(
+                (const char *)sqlite3_column_text(stmt, COLUMN_STATS)
+            ).toVariant().toMap();
+        for (auto it = map.constKeyValueBegin();
+             it != map.constKeyValueEnd();
+             ++it)
+        {
+            Tag tag = tags.value(it->first.toUtf8());
+            QList<QPair<Tag, QString>> *list = nullptr;
+            if (tag.category == TAG_NAME_INDEX)
+            {
+                list = &def.index;
+            }
+            else if (tag.category == TAG_NAME_STATS)
+            {
+                list = &def.stats;
+            }
+            else if (tag.category == TAG_NAME_CLAS)
+            {
+                list = &def.clas;
+            }
+            else if (tag.category == TAG_NAME_CODE)
+            {
+                list = &def.code;
+            }
+            else
+            {
+                continue;
+            }
+            list->append(
+                QPair<Tag, QString>(std::move(tag), it->second.toString())
+            );
+        }
+
+        const QString character = QString::fromUtf8(
+            (const char *)sqlite3_column_text(stmt, COLUMN_CHAR)
+        );
+        Kanji &kanji = m_kanjiCache[toCodePoint(character)];
+        kanji.character = character;
+        kanji.definitions.append(def);
+    }
+    if (isStepError(step))
+    {
+        ret = -1;
+        goto cleanup;
+    }
+
+    /* Kanji that only have frequencies are never shown */
+    for (auto it = m_kanjiCache.begin(); it != m_kanjiCache.end(); )
+    {
+        it = it->definitions.isEmpty() ? m_kanjiCache.erase(it) : ++it;
+    }
+
+cleanup:
+    sqlite3_finalize(stmt);
+    if (ret)
+    {
+        m_kanjiCache.clear();
+    }
+
+    return ret;
+}
+
+#undef QUERY_FREQUENCIES
+#undef QUERY_DEFINITIONS
+
+#undef COLUMN_FREQ_DIC_ID
+#undef COLUMN_FREQ_CHAR
+
+#undef COLUMN_DIC_ID
+#undef COLUMN_ONYOMI
+#undef COLUMN_KUNYOMI
+#undef COLUMN_TAGS
+#undef COLUMN_MEANINGS
+#undef COLUMN_STATS
+#undef COLUMN_CHAR
+
+#undef TAG_NAME_STATS
+#undef TAG_NAME_CLAS
+#undef TAG_NAME_CODE
+#undef TAG_NAME_INDEX
+
 /* End Initializers */
 /* Begin Dictionary Database Modifiers */
 
 int DatabaseManager::addDictionary(const QString &path)
 {
+    interruptReaders();
     m_dbLock.lockForWrite();
     QByteArray cpath = path.toUtf8();
     QByteArray respath = DirectoryUtils::getDictionaryResourceDir().toUtf8();
     int ret = yomi_process_dictionary(cpath, m_dbpath, respath);
+    refreshStorage();
     initCache();
     m_dbLock.unlock();
     return ret;
@@ -188,10 +611,12 @@ int DatabaseManager::addDictionary(const QString &path)
 
 int DatabaseManager::deleteDictionary(const QString &name)
 {
+    interruptReaders();
     m_dbLock.lockForWrite();
     QByteArray cname = name.toUtf8();
     QByteArray respath = DirectoryUtils::getDictionaryResourceDir().toUtf8();
     int ret = yomi_delete_dictionary(cname, m_dbpath, respath);
+    refreshStorage();
     initCache();
     m_dbLock.unlock();
     return ret;
@@ -210,8 +635,11 @@ int DatabaseManager::disableDictionaries(const QStringList &dicts)
         cDicts << dict.data();
     }
 
+    interruptReaders();
     m_dbLock.lockForWrite();
     int ret = yomi_disable_dictionaries(cDicts.data(), cDicts.size(), m_dbpath);
+    refreshStorage();
+    initKanjiCache();
     m_dbLock.unlock();
     return ret;
 }
@@ -276,21 +704,41 @@ cleanup:
 
 #undef QUERY
 
-#define QUERY               "SELECT DISTINCT expression, reading "\
+QHash<uint64_t, QString> DatabaseManager::getDictionaryIds() const
+{
+    QHash<uint64_t, QString> ids;
+    m_dbLock.lockForRead();
+    for (auto it = m_dictionaryCache.constKeyValueBegin();
+         it != m_dictionaryCache.constKeyValueEnd();
+         ++it)
+    {
+        ids.insert(it->first, it->second);
+    }
+    m_dbLock.unlock();
+    return ids;
+}
+
+#define QUERY               "SELECT expression, reading, SUM(score), "\
+                                    "GROUP_CONCAT(rules, ' ') "\
                                 "FROM term_bank "\
                                 "WHERE dic_id NOT IN (SELECT dic_id FROM dict_disabled) AND " \
-                                    "(expression = ? OR reading = ?);"
-#define QUERY_WITH_KATAKANA "SELECT DISTINCT expression, reading "\
+                                    "(expression = ? OR reading = ?) "\
+                                "GROUP BY expression, reading;"
+#define QUERY_WITH_KATAKANA "SELECT expression, reading, SUM(score), "\
+                                    "GROUP_CONCAT(rules, ' ') "\
                                 "FROM term_bank "\
                                 "WHERE dic_id NOT IN (SELECT dic_id FROM dict_disabled) AND " \
                                     "(expression = ? OR reading = ? OR " \
-                                     "expression = ? OR reading = ?);"
-#define QUERY_WITH_HALFWIDTH "SELECT DISTINCT expression, reading "\
+                                     "expression = ? OR reading = ?) "\
+                                "GROUP BY expression, reading;"
+#define QUERY_WITH_HALFWIDTH "SELECT expression, reading, SUM(score), "\
+                                    "GROUP_CONCAT(rules, ' ') "\
                                 "FROM term_bank "\
                                 "WHERE dic_id NOT IN (SELECT dic_id FROM dict_disabled) AND " \
                                     "(expression = ? OR reading = ? OR " \
                                      "expression = ? OR reading = ? OR " \
-                                     "expression = ? OR reading = ?);"
+                                     "expression = ? OR reading = ?) "\
+                                "GROUP BY expression, reading;"
 
 #define QUERY_RAW_EXPRESSION_IDX    1
 #define QUERY_RAW_READING_IDX       2
@@ -301,8 +749,14 @@ cleanup:
 
 #define COLUMN_EXPRESSION       0
 #define COLUMN_READING          1
-
-QString DatabaseManager::queryTerms(const QString &query, QList<SharedTerm> &terms) const
+#define COLUMN_SCORE            2
+#define COLUMN_RULES            3
+
+QString DatabaseManager::queryTerms(
+    const QString &query,
+    const QSet<QString> &ruleFilter,
+    QList<SharedTerm> &terms,
+    const CancellationToken &token) const
 {
     if (m_db == nullptr)
     {
@@ -310,22 +764,32 @@ QString DatabaseManager::queryTerms(const QString &query, QList<SharedTerm> &ter
     }
 
     /* Try to acquire the database lock, early return if we can't */
+    const int interrupts = m_interrupts.loadAcquire();
     if (!m_dbLock.tryLockForRead())
     {
         return "";
     }
 
-    QString       ret;
-    QByteArray    exp          = query.toUtf8();
-    QByteArray    katakana     = halfToFull(query).toUtf8();
-    bool          containsHalf = katakana != exp;
-    QByteArray    hiragana     = kataToHira(katakana).toUtf8();
-    bool          containsKata = hiragana != katakana;
-    sqlite3_stmt *stmt         = NULL;
-    const char   *sql_query    = NULL;
-    int           step         = 0;
+    /* Build the exact, full-width, and hiragana queries in one pass */
+    TextNormalizer::Variants variants;
+    TextNormalizer::normalize(query, variants);
+
+    QString           ret;
+    const QByteArray &exp          = variants.exact;
+    const QByteArray &katakana     = variants.katakana;
+    const QByteArray &hiragana     = variants.hiragana;
+    const bool        containsHalf = variants.containsHalfWidth;
+    const bool        containsKata = variants.containsKatakana;
+    sqlite3_stmt     *stmt         = NULL;
+    const char       *sql_query    = NULL;
+    int               step         = 0;
     QList<SharedTerm> termList;
 
+    /* Most rows share a handful of rule strings, so each is checked once */
+    QHash<QByteArray, bool> ruleMatches;
+
+    t_cancelToken = &token;
+
     if (containsHalf)
     {
         sql_query = QUERY_WITH_HALFWIDTH;
@@ -343,13 +807,13 @@ QString DatabaseManager::queryTerms(const QString &query, QList<SharedTerm> &ter
     if (sqlite3_prepare_v2(m_db, sql_query, -1, &stmt, NULL) != SQLITE_OK)
     {
         ret = "Could not prepare database query";
-        goto error;
+        goto cleanup;
     }
     if (sqlite3_bind_text(stmt, QUERY_RAW_EXPRESSION_IDX, exp, -1, NULL) != SQLITE_OK ||
         sqlite3_bind_text(stmt, QUERY_RAW_READING_IDX,    exp, -1, NULL) != SQLITE_OK)
     {
         ret = "Could not bind values to statement";
-        goto error;
+        goto cleanup;
     }
     if (containsKata &&
         (
@@ -358,7 +822,7 @@ QString DatabaseManager::queryTerms(const QString &query, QList<SharedTerm> &ter
         ))
     {
         ret = "Could not bind values to statement";
-        goto error;
+        goto cleanup;
     }
     if (containsHalf &&
         (
@@ -367,79 +831,291 @@ QString DatabaseManager::queryTerms(const QString &query, QList<SharedTerm> &ter
         ))
     {
         ret = "Could not bind values to statement";
-        goto error;
+        goto cleanup;
     }
 
     /* Create a term for each entry */
     while ((step = sqlite3_step(stmt)) == SQLITE_ROW)
     {
-        SharedTerm term(new Term);
+        if (!ruleFilter.isEmpty())
+        {
+            const char *rules =
+                (const char *)sqlite3_column_text(stmt, COLUMN_RULES);
+            const QByteArray key = QByteArray::fromRawData(
+                rules, rules ? qstrlen(rules) : 0
+            );
+            auto it = ruleMatches.constFind(key);
+            if (it == ruleMatches.constEnd())
+            {
+                bool matches = false;
+                forEachWord(rules,
+                    [&] (const QByteArray &rule)
+                    {
+                        matches = matches ||
+                            ruleFilter.contains(QString::fromUtf8(rule));
+                    }
+                );
+                /* key does not own its data, so deep copy it */
+                it = ruleMatches.insert(
+                    QByteArray(key.constData(), key.size()), matches
+                );
+            }
+            if (!*it)
+            {
+                continue;
+            }
+        }
+
+        /* One allocation for the term and its reference count */
+        SharedTerm term = SharedTerm::create();
         term->expression = (const char *)sqlite3_column_text(stmt, COLUMN_EXPRESSION);
         term->reading    = (const char *)sqlite3_column_text(stmt, COLUMN_READING);
-        if (addFrequencies(*term))
-            qDebug() << "Could not add frequencies for" << term->expression;
-        if (addPitches(*term))
-            qDebug() << "Could not add pitches for" << term->expression;
+        term->score      = sqlite3_column_int(stmt, COLUMN_SCORE);
         termList.append(term);
     }
-    if (isStepError(step))
+    if (step == SQLITE_INTERRUPT)
+    {
+        ret = "Query cancelled";
+        goto cleanup;
+    }
+    else if (isStepError(step))
     {
         ret = "Error when executing sqlite query. Code " + QString::number(step);
-        goto error;
+        goto cleanup;
     }
 
-    /* Add data to each term */
-    if (populateTerms(termList))
+    terms.append(termList);
+
+cleanup:
+    sqlite3_finalize(stmt);
+    t_cancelToken = nullptr;
+    m_dbLock.unlock();
+
+    if (!ret.isEmpty() && interruptedByWrite(interrupts, token))
     {
-        ret = "Error getting term information";
-        goto error;
+        return queryTerms(query, ruleFilter, terms, token);
+    }
+
+    return ret;
+}
+
+#undef QUERY
+#undef QUERY_WITH_KATAKANA
+#undef QUERY_WITH_HALFWIDTH
+
+#undef QUERY_RAW_EXPRESSION_IDX
+#undef QUERY_RAW_READING_IDX
+#undef QUERY_KATA_EXPRESSION_IDX
+#undef QUERY_KATA_READING_IDX
+#undef QUERY_HALF_EXPRESSION_IDX
+#undef QUERY_HALF_READING_IDX
+
+#undef COLUMN_EXPRESSION
+#undef COLUMN_READING
+#undef COLUMN_SCORE
+#undef COLUMN_RULES
+
+/* FTS5 ranks every match before the LIMIT applies, so the LIMIT only bounds
+ * how many rows are joined, grouped and loaded. Keeping the number of matches
+ * down is up to the caller. */
+#define QUERY   "SELECT expression, reading, SUM(score) "\
+                    "FROM ("\
+                        "SELECT term_bank.expression, term_bank.reading, "\
+                                "term_bank.score, term_glossary.rank "\
+                            "FROM term_glossary "\
+                            "JOIN term_bank "\
+                                "ON term_bank.rowid = term_glossary.rowid "\
+                            "WHERE term_glossary MATCH ? AND "\
+                                "term_bank.dic_id NOT IN "\
+                                    "(SELECT dic_id FROM dict_disabled) "\
+                            "ORDER BY term_glossary.rank "\
+                            "LIMIT ?"\
+                    ") "\
+                    "GROUP BY expression, reading "\
+                    "ORDER BY MIN(rank), SUM(score) DESC;"
+
+#define QUERY_MATCH_IDX     1
+#define QUERY_LIMIT_IDX     2
+
+#define COLUMN_EXPRESSION   0
+#define COLUMN_READING      1
+#define COLUMN_SCORE        2
+
+QString DatabaseManager::queryGlossary(
+    const QString &query,
+    const int limit,
+    QList<SharedTerm> &terms,
+    const CancellationToken &token) const
+{
+    if (m_db == nullptr)
+    {
+        return "Database is invalid";
+    }
+
+    /* Quote every word so user input can't be parsed as FTS5 syntax. The
+     * last word is matched as a prefix so results show up while typing.
+     * Single characters prefix most of the index and ranking that many
+     * matches takes hundreds of milliseconds, so they are matched whole. */
+    QStringList words;
+    QString word;
+    for (const QChar ch : query)
+    {
+        if (ch.isLetterOrNumber())
+        {
+            word += ch;
+        }
+        else if (!word.isEmpty())
+        {
+            words << QString("\"%1\"").arg(word);
+            word.clear();
+        }
+    }
+    if (word.size() > 1)
+    {
+        words << QString("\"%1\"*").arg(word);
+    }
+    else if (!word.isEmpty())
+    {
+        words << QString("\"%1\"").arg(word);
+    }
+    if (words.isEmpty())
+    {
+        return "";
+    }
+    const QByteArray match = words.join(' ').toUtf8();
+
+    /* Try to acquire the database lock, early return if we can't */
+    const int interrupts = m_interrupts.loadAcquire();
+    if (!m_dbLock.tryLockForRead())
+    {
+        return "";
     }
 
-    /* Return results on success */
+    QString           ret;
+    sqlite3_stmt     *stmt = NULL;
+    int               step = 0;
+    QList<SharedTerm> termList;
+
+    t_cancelToken = &token;
+
+    if (sqlite3_prepare_v2(m_db, QUERY, -1, &stmt, NULL) != SQLITE_OK)
+    {
+        ret = "Could not prepare database query. "
+            "Glossary search needs SQLite with FTS5.";
+        goto cleanup;
+    }
+    if (sqlite3_bind_text(stmt, QUERY_MATCH_IDX, match, -1, NULL) != SQLITE_OK ||
+        sqlite3_bind_int(stmt, QUERY_LIMIT_IDX, limit) != SQLITE_OK)
+    {
+        ret = "Could not bind values to statement";
+        goto cleanup;
+    }
+    while ((step = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        SharedTerm term = SharedTerm::create();
+        term->expression = (const char *)sqlite3_column_text(stmt, COLUMN_EXPRESSION);
+        term->reading    = (const char *)sqlite3_column_text(stmt, COLUMN_READING);
+        term->score      = sqlite3_column_int(stmt, COLUMN_SCORE);
+        termList.append(term);
+    }
+    if (step == SQLITE_INTERRUPT)
+    {
+        ret = "Query cancelled";
+        goto cleanup;
+    }
+    else if (isStepError(step))
+    {
+        ret = "Error when executing sqlite query. Code " + QString::number(step);
+        goto cleanup;
+    }
+
+    terms.append(termList);
+
+cleanup:
     sqlite3_finalize(stmt);
+    t_cancelToken = nullptr;
     m_dbLock.unlock();
-    terms.append(termList);
+
+    if (!ret.isEmpty() && interruptedByWrite(interrupts, token))
+    {
+        return queryGlossary(query, limit, terms, token);
+    }
 
     return ret;
+}
+
+#undef QUERY
+
+#undef QUERY_MATCH_IDX
+#undef QUERY_LIMIT_IDX
+
+#undef COLUMN_EXPRESSION
+#undef COLUMN_READING
+#undef COLUMN_SCORE
+
+#define QUERY   "SELECT expression, reading, SUM(score), "\
+                        "GROUP_CONCAT(rules, ' ') "\
+                    "FROM term_bank "\
+                    "WHERE dic_id NOT IN (SELECT dic_id FROM dict_disabled) "\
+                    "GROUP BY expression, reading;"
+
+#define COLUMN_EXPRESSION       0
+#define COLUMN_READING          1
+#define COLUMN_SCORE            2
+#define COLUMN_RULES            3
+
+QString DatabaseManager::compileTermPack(const QString &path) const
+{
+    if (m_db == nullptr)
+    {
+        return "Database is invalid";
+    }
+
+    QReadLocker lock(&m_dbLock);
+
+    TermPackWriter writer;
+    QString        ret;
+    sqlite3_stmt  *stmt = NULL;
+    int            step = 0;
+
+    if (sqlite3_prepare_v2(m_db, QUERY, -1, &stmt, NULL) != SQLITE_OK)
+    {
+        ret = "Could not prepare database query";
+        goto cleanup;
+    }
+    while ((step = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        writer.addTerm(
+            (const char *)sqlite3_column_text(stmt, COLUMN_EXPRESSION),
+            (const char *)sqlite3_column_text(stmt, COLUMN_READING),
+            sqlite3_column_int(stmt, COLUMN_SCORE),
+            (const char *)sqlite3_column_text(stmt, COLUMN_RULES)
+        );
+    }
+    if (isStepError(step))
+    {
+        ret = "Error when executing sqlite query. Code " + QString::number(step);
+        goto cleanup;
+    }
+
+    ret = writer.save(path, QString::fromUtf8(m_dbpath));
 
-error:
-    /* Free up memory on failure */
-    m_dbLock.unlock();
+cleanup:
     sqlite3_finalize(stmt);
 
     return ret;
 }
 
 #undef QUERY
-#undef QUERY_WITH_KATAKANA
-#undef QUERY_WITH_HALFWIDTH
-
-#undef QUERY_RAW_EXPRESSION_IDX
-#undef QUERY_RAW_READING_IDX
-#undef QUERY_KATA_EXPRESSION_IDX
-#undef QUERY_KATA_READING_IDX
-#undef QUERY_HALF_EXPRESSION_IDX
-#undef QUERY_HALF_READING_IDX
 
 #undef COLUMN_EXPRESSION
 #undef COLUMN_READING
+#undef COLUMN_SCORE
+#undef COLUMN_RULES
 
-#define QUERY   "SELECT dic_id, onyomi, kunyomi, tags, meanings, stats FROM kanji_bank "\
-                    "WHERE dic_id NOT IN (SELECT dic_id FROM dict_disabled) AND (char = ?);"
-
-#define COLUMN_DIC_ID       0
-#define COLUMN_ONYOMI       1
-#define COLUMN_KUNYOMI      2
-#define COLUMN_TAGS         3
-#define COLUMN_MEANINGS     4
-#define COLUMN_STATS        5
-
-#define TAG_NAME_STATS      "misc"
-#define TAG_NAME_CLAS       "class"
-#define TAG_NAME_CODE       "code"
-#define TAG_NAME_INDEX      "index"
-
-QString DatabaseManager::queryKanji(const QString &query, Kanji &kanji) const
+QString DatabaseManager::loadTerms(
+    const QList<SharedTerm> &terms,
+    const CancellationToken &token) const
 {
     if (m_db == nullptr)
     {
@@ -447,112 +1123,97 @@ QString DatabaseManager::queryKanji(const QString &query, Kanji &kanji) const
     }
 
     /* Try to acquire the database lock, early return if we can't */
+    const int interrupts = m_interrupts.loadAcquire();
     if (!m_dbLock.tryLockForRead())
     {
-        return "";
+        return "Database is busy";
     }
 
-    QString       ret;
-    QByteArray    ch   = query.toUtf8();
-    sqlite3_stmt *stmt = NULL;
-    int           step = 0;
+    QString ret;
+    bool    failed = false;
 
-    kanji.character = query;
-    addFrequencies(kanji);
+    t_cancelToken = &token;
 
-    /* Query for the database for the definitions */
-    if (sqlite3_prepare_v2(m_db, QUERY, -1, &stmt, NULL) != SQLITE_OK)
+    for (const SharedTerm &term : terms)
     {
-        ret = "Could not prepare database query";
-        goto cleanup;
+        if (token.isCancelled())
+        {
+            ret = "Query cancelled";
+            goto cleanup;
+        }
+        if (addFrequencies(*term))
+        {
+            qDebug() << "Could not add frequencies for" << term->expression;
+            failed = true;
+        }
+        if (addPitches(*term))
+        {
+            qDebug() << "Could not add pitches for" << term->expression;
+            failed = true;
+        }
     }
-    if (sqlite3_bind_text(stmt, 1, ch, -1, NULL) != SQLITE_OK)
+
+    /* Add data to each term */
+    if (populateTerms(terms))
     {
-        ret = "Could not bind values to statement";
+        ret = token.isCancelled() ?
+            "Query cancelled" : "Error getting term information";
         goto cleanup;
     }
-    while ((step = sqlite3_step(stmt)) != SQLITE_DONE)
+    for (const SharedTerm &term : terms)
     {
-        uint64_t id = sqlite3_column_int64(stmt, COLUMN_DIC_ID);
+        term->loaded = true;
+    }
 
-        KanjiDefinition def;
-        def.dictionary = getDictionary(id),
-        def.onyomi = QString(
-                (const char *)sqlite3_column_text(stmt, COLUMN_ONYOMI)
-            ).split(' '),
-        def.kunyomi = QString(
-                (const char *)sqlite3_column_text(stmt, COLUMN_KUNYOMI)
-            ).split(' '),
-        def.glossary = jsonArrayToStringList(
-                (const char *)sqlite3_column_text(stmt, COLUMN_MEANINGS)
-            );
-        addTags(
-            id, (const char *)sqlite3_column_text(stmt, COLUMN_TAGS), def.tags
-        );
+cleanup:
+    t_cancelToken = nullptr;
+    m_dbLock.unlock();
 
-        QVariantMap map = QJsonDocument::fromJson(
-                (const char *)sqlite3_column_text(stmt, COLUMN_STATS)
-            ).toVariant().toMap();
-        for (auto it = map.constKeyValueBegin();
-             it != map.constKeyValueEnd();
-             ++it)
+    /* Throw away anything half loaded before trying again */
+    if ((failed || !ret.isEmpty()) && interruptedByWrite(interrupts, token))
+    {
+        for (const SharedTerm &term : terms)
         {
-            Tag tag = m_tagCache[id][it->first];
-            QList<QPair<Tag, QString>> *list = nullptr;
-            if (tag.category == TAG_NAME_INDEX)
-            {
-                list = &def.index;
-            }
-            else if (tag.category == TAG_NAME_STATS)
-            {
-                list = &def.stats;
-            }
-            else if (tag.category == TAG_NAME_CLAS)
-            {
-                list = &def.clas;
-            }
-            else if (tag.category == TAG_NAME_CODE)
-            {
-                list = &def.code;
-            }
-            else
-            {
-                continue;
-            }
-            list->append(
-                QPair<Tag, QString>(std::move(tag), it->second.toString())
-            );
+            term->frequencies.clear();
+            term->pitches.clear();
+            term->tags.clear();
+            term->definitions.clear();
+            term->loaded = false;
         }
+        return loadTerms(terms, token);
+    }
 
-        kanji.definitions.append(def);
+    return ret;
+}
+
+QString DatabaseManager::queryKanji(const QString &query, Kanji &kanji) const
+{
+    if (m_db == nullptr)
+    {
+        return "Database is invalid";
     }
-    if (isStepError(step))
+
+    /* Try to acquire the database lock, early return if we can't */
+    if (!m_dbLock.tryLockForRead())
     {
-        ret = "Error while executing kanji query";
-        goto cleanup;
+        return "";
+    }
+
+    auto it = m_kanjiCache.constFind(toCodePoint(query));
+    if (it != m_kanjiCache.constEnd())
+    {
+        kanji = *it;
+    }
+    else
+    {
+        kanji.character = query;
     }
 
-cleanup:
-    sqlite3_finalize(stmt);
     m_dbLock.unlock();
 
-    return ret;
+    return "";
 }
 
-#undef QUERY
-
-#undef COLUMN_DIC_ID
-#undef COLUMN_ONYOMI
-#undef COLUMN_KUNYOMI
-#undef COLUMN_TAGS
-#undef COLUMN_MEANINGS
-#undef COLUMN_STATS
-
-#undef TAG_NAME_STATS
-#undef TAG_NAME_CLAS
-#undef TAG_NAME_CODE
-#undef TAG_NAME_INDEX
-
 /* End Database Getters */
 /* Begin Query Helpers */
 
@@ -579,8 +1240,18 @@ int DatabaseManager::populateTerms(const QList<SharedTerm> &terms) const
     QByteArray    exp;
     QByteArray    reading;
 
+    /* Maps rule strings to their interned rules, so the rule cache is only
+     * locked once per distinct rule string */
+    QHash<QByteArray, QSet<QString>> ruleSets;
+
     for (SharedTerm term : terms)
     {
+        if (t_cancelToken && t_cancelToken->isCancelled())
+        {
+            ret = -1;
+            goto cleanup;
+        }
+
         exp     = term->expression.toUtf8();
         reading = term->reading.toUtf8();
 
@@ -600,7 +1271,6 @@ int DatabaseManager::populateTerms(const QList<SharedTerm> &terms) const
         {
             const uint64_t id = sqlite3_column_int64(stmt, COLUMN_DIC_ID);
 
-            term->score += sqlite3_column_int(stmt, COLUMN_SCORE);
             addTags(
                 id,
                 (const char *)sqlite3_column_text(stmt, COLUMN_TERM_TAGS),
@@ -609,6 +1279,7 @@ int DatabaseManager::populateTerms(const QList<SharedTerm> &terms) const
 
             TermDefinition def;
             def.dictionary = getDictionary(id);
+            def.dictionaryId = id;
             def.glossary = QJsonDocument::fromJson(
                 (const char *)sqlite3_column_text(stmt, COLUMN_GLOSSARY)
             ).array();
@@ -618,13 +1289,27 @@ int DatabaseManager::populateTerms(const QList<SharedTerm> &terms) const
                 (const char *)sqlite3_column_text(stmt, COLUMN_DEF_TAGS),
                 def.tags
             );
-            QStringList rules = QString(
-                (const char *)sqlite3_column_text(stmt, COLUMN_RULES)
-            ).split(' ');
-            def.rules = {
-                std::move_iterator{std::begin(rules)},
-                std::move_iterator{std::end(rules)}
-            };
+            const char *rules =
+                (const char *)sqlite3_column_text(stmt, COLUMN_RULES);
+            const QByteArray key = QByteArray::fromRawData(
+                rules, rules ? qstrlen(rules) : 0
+            );
+            auto it = ruleSets.constFind(key);
+            if (it == ruleSets.constEnd())
+            {
+                QSet<QString> ruleSet;
+                forEachWord(rules,
+                    [&] (const QByteArray &rule)
+                    {
+                        ruleSet.insert(internRule(rule));
+                    }
+                );
+                /* key does not own its data, so deep copy it */
+                it = ruleSets.insert(
+                    QByteArray(key.constData(), key.size()), ruleSet
+                );
+            }
+            def.rules = *it;
             term->definitions.append(def);
         }
         if (isStepError(step))
@@ -661,19 +1346,39 @@ QString DatabaseManager::getDictionary(const uint64_t id) const
 }
 
 void DatabaseManager::addTags(const uint64_t  id,
-                              const QString  &tagStr,
+                              const char     *tagStr,
                               QList<Tag>     &tags) const
 {
-    QStringList tagList = tagStr.split(" ");
-
-    for (const QString &tagName : tagList)
+    auto dictTags = m_tagCache.constFind(id);
+    if (dictTags == m_tagCache.constEnd())
     {
-        const Tag &tag = m_tagCache[id][tagName];
-        if (!tag.name.isEmpty() && !tags.contains(tag))
+        return;
+    }
+
+    forEachWord(tagStr,
+        [&] (const QByteArray &tagName)
         {
-            tags.append(tag);
+            auto tag = dictTags->constFind(tagName);
+            if (tag != dictTags->constEnd() && !tags.contains(*tag))
+            {
+                tags.append(*tag);
+            }
         }
+    );
+}
+
+QString DatabaseManager::internRule(const QByteArray &rule) const
+{
+    QMutexLocker locker(&m_ruleLock);
+    auto it = m_ruleCache.constFind(rule);
+    if (it == m_ruleCache.constEnd())
+    {
+        /* rule may not own its data, so deep copy the key */
+        it = m_ruleCache.insert(
+            QByteArray(rule.constData(), rule.size()), QString::fromUtf8(rule)
+        );
     }
+    return *it;
 }
 
 #define QUERY   "SELECT dic_id, data, type "\
@@ -690,18 +1395,6 @@ int DatabaseManager::addFrequencies(Term &term) const
 
 #undef QUERY
 
-#define QUERY   "SELECT dic_id, data, type "\
-                    "FROM kanji_meta_bank "\
-                    "WHERE dic_id NOT IN (SELECT dic_id FROM dict_disabled) AND " \
-                        "(expression = ? AND mode = 'freq');"
-
-int DatabaseManager::addFrequencies(Kanji &kanji) const
-{
-    return addFrequencies(QUERY, kanji.character, kanji.frequencies);
-}
-
-#undef QUERY
-
 #define OBJ_READING_KEY     "reading"
 #define OBJ_FREQ_KEY        "frequency"
 #define OBJ_VALUE_KEY       "value"
@@ -733,86 +1426,12 @@ int DatabaseManager::addFrequencies(
     while ((step = sqlite3_step(stmt)) == SQLITE_ROW)
     {
         QString freqStr;
-        switch ((yomi_blob_t)sqlite3_column_int(stmt, 2))
-        {
-        case YOMI_BLOB_TYPE_STRING:
-            freqStr = (const char *)sqlite3_column_blob(stmt, 1);
-            break;
-
-        case YOMI_BLOB_TYPE_INT:
-            freqStr = QString::number(
-                *(const uint64_t *)sqlite3_column_blob(stmt, 1)
-            );
-            break;
-        case YOMI_BLOB_TYPE_OBJECT:
+        if (!parseFrequency(stmt, reading, freqStr))
         {
-            QJsonObject obj = QJsonDocument::fromJson(
-                (const char *)sqlite3_column_blob(stmt, 1)
-            ).object();
-
-            /* Check if this frequency is dependant on reading */
-            if (obj[OBJ_READING_KEY].isString())
-            {
-                if (obj[OBJ_READING_KEY].toString() != reading)
-                {
-                    continue;
-                }
-            }
-
-            /* First scenario:
-             * [
-             *     "<term>","freq",{"reading":"<reading>","frequency":<number>}
-             * ]
-             */
-            if (obj[OBJ_FREQ_KEY].isDouble())
-            {
-                freqStr = QString::number(obj[OBJ_FREQ_KEY].toInt());
-            }
-
-            /* Second scenario:
-             * [
-             *     "<term>","freq",{"reading":"<reading>","frequency": "<frequency string>">}
-             * ]
-             */
-            else if (obj[OBJ_FREQ_KEY].isString())
-            {
-                freqStr = obj[OBJ_FREQ_KEY].toString();
-            }
-
-            /* Third scenario:
-             * [
-             *     "<term>","freq",
-             *     {"reading":"<reading>",
-             *        "frequency": {"value": <number>, "displayValue": "<stylized frequency string>"}
-             *     }
-             * ]
-             */
-            else if (obj[OBJ_FREQ_KEY].isObject())
-            {
-                obj = obj[OBJ_FREQ_KEY].toObject();
-                /* Check for the type that should be shown */
-                if (obj[OBJ_DISPLAY_KEY].isString())
-                {
-                    freqStr = obj[OBJ_DISPLAY_KEY].toString();
-                }
-                else if (obj[OBJ_VALUE_KEY].isDouble())
-                {
-                    freqStr = QString::number(obj[OBJ_VALUE_KEY].toInt());
-                }
-                else
-                {
-                    continue;
-                }
-            }
-            break;
-        }
-        default:
             continue;
         }
-        freq.append(Frequency {
-            getDictionary(sqlite3_column_int64(stmt, 0)),
-            freqStr
-        });
+        const uint64_t id = sqlite3_column_int64(stmt, 0);
+        freq.append(Frequency {getDictionary(id), freqStr, id});
     }
     if (isStepError(step))
     {
@@ -827,6 +1446,90 @@ cleanup:
     return ret;
 }
 
+bool DatabaseManager::parseFrequency(
+    sqlite3_stmt *stmt,
+    const QString &reading,
+    QString &freqStr) const
+{
+    switch ((yomi_blob_t)sqlite3_column_int(stmt, 2))
+    {
+    case YOMI_BLOB_TYPE_STRING:
+        freqStr = (const char *)sqlite3_column_blob(stmt, 1);
+        break;
+
+    case YOMI_BLOB_TYPE_INT:
+        freqStr = QString::number(
+            *(const uint64_t *)sqlite3_column_blob(stmt, 1)
+        );
+        break;
+    case YOMI_BLOB_TYPE_OBJECT:
+    {
+        QJsonObject obj = QJsonDocument::fromJson(
+            (const char *)sqlite3_column_blob(stmt, 1)
+        ).object();
+
+        /* Check if this frequency is dependant on reading */
+        if (obj[OBJ_READING_KEY].isString())
+        {
+            if (obj[OBJ_READING_KEY].toString() != reading)
+            {
+                return false;
+            }
+        }
+
+        /* First scenario:
+         * [
+         *     "<term>","freq",{"reading":"<reading>","frequency":<number>}
+         * ]
+         */
+        if (obj[OBJ_FREQ_KEY].isDouble())
+        {
+            freqStr = QString::number(obj[OBJ_FREQ_KEY].toInt());
+        }
+
+        /* Second scenario:
+         * [
+         *     "<term>","freq",{"reading":"<reading>","frequency": "<frequency string>">}
+         * ]
+         */
+        else if (obj[OBJ_FREQ_KEY].isString())
+        {
+            freqStr = obj[OBJ_FREQ_KEY].toString();
+        }
+
+        /* Third scenario:
+         * [
+         *     "<term>","freq",
+         *     {"reading":"<reading>",
+         *        "frequency": {"value": <number>, "displayValue": "<stylized frequency string>"}
+         *     }
+         * ]
+         */
+        else if (obj[OBJ_FREQ_KEY].isObject())
+        {
+            obj = obj[OBJ_FREQ_KEY].toObject();
+            /* Check for the type that should be shown */
+            if (obj[OBJ_DISPLAY_KEY].isString())
+            {
+                freqStr = obj[OBJ_DISPLAY_KEY].toString();
+            }
+            else if (obj[OBJ_VALUE_KEY].isDouble())
+            {
+                freqStr = QString::number(obj[OBJ_VALUE_KEY].toInt());
+            }
+            else
+            {
+                return false;
+            }
+        }
+        break;
+    }
+    default:
+        return false;
+    }
+    return true;
+}
+
 #undef OBJ_READING_KEY
 #undef OBJ_FREQ_KEY
 #undef OBJ_VALUE_KEY
@@ -954,170 +1657,6 @@ QString DatabaseManager::errorCodeToString(const int code) const
     }
 }
 
-static const QChar HALFWIDTH_LOW(0xFF61);
-static const QChar HALFWIDTH_HIGH(0xFF9F);
-static const QChar HALFWIDTH_VOICED(0xFF9E);
-static const QChar HALFWIDTH_SEMI_VOICED(0xFF9F);
-
-QString DatabaseManager::halfToFull(const QString &query) const
-{
-    /* While initializing a new map every time this conversion is done seems and
-     * is stupid, QMap is not thread safe. An older version of Memento used to
-     * disregarded this and it led to a horrible bug that caused CPU usage to
-     * spike to 100% until Memento was closed.
-     *
-     * While it might seem obvious that half-width should be easily mappable to
-     * full-width with offsets, this is not the case. Unicode in their infinite
-     * wisdom decided the ordering for half-width characters should be different
-     * from their full width counter parts and that half width characters should
-     * use two characters to represent something like ガ using two characters
-     * (ｶﾞ).
-     */
-    QMap<QString, QString> charMap{
-        {"｡", "。"},
-        {"｢", "「"},
-        {"｣", "」"},
-        {"､", "、"},
-        {"･", "・"},
-        {"ｦ", "ヲ"},
-        {"ｧ", "ァ"},
-        {"ｨ", "ィ"},
-        {"ｩ", "ゥ"},
-        {"ｪ", "ェ"},
-        {"ｫ", "ォ"},
-        {"ｬ", "ャ"},
-        {"ｭ", "ュ"},
-        {"ｮ", "ョ"},
-        {"ｯ", "ッ"},
-        {"ｰ", "ー"},
-        {"ｱ", "ア"},
-        {"ｲ", "イ"},
-        {"ｳ", "ウ"},
-        {"ｴ", "エ"},
-        {"ｵ", "オ"},
-        {"ｶ", "か"},
-        {"ｶﾞ", "が"},
-        {"ｷ", "キ"},
-        {"ｷﾞ", "ギ"},
-        {"ｸ", "ク"},
-        {"ｸﾞ", "グ"},
-        {"ｹ", "ケ"},
-        {"ｹﾞ", "ゲ"},
-        {"ｺ", "コ"},
-        {"ｺﾞ", "ゴ"},
-        {"ｻ", "サ"},
-        {"ｻﾞ", "ザ"},
-        {"ｼ", "シ"},
-        {"ｼﾞ", "ジ"},
-        {"ｽ", "ス"},
-        {"ｽﾞ", "ズ"},
-        {"ｾ", "セ"},
-        {"ｾﾞ", "ゼ"},
-        {"ｿ", "ソ"},
-        {"ｿﾞ", "ゾ"},
-        {"ﾀ", "タ"},
-        {"ﾀﾞ", "ダ"},
-        {"ﾁ", "チ"},
-        {"ﾁﾞ", "ヂ"},
-        {"ﾂ", "ツ"},
-        {"ﾂﾞ", "ヅ"},
-        {"ﾃ", "テ"},
-        {"ﾃﾞ", "デ"},
-        {"ﾄ", "ト"},
-        {"ﾄﾞ", "ド"},
-        {"ﾅ", "ナ"},
-        {"ﾆ", "ニ"},
-        {"ﾇ", "ヌ"},
-        {"ﾈ", "ネ"},
-        {"ﾉ", "ノ"},
-        {"ﾊ", "ハ"},
-        {"ﾊﾞ", "バ"},
-        {"ﾊﾟ", "パ"},
-        {"ﾋ", "ヒ"},
-        {"ﾋﾞ", "ビ"},
-        {"ﾋﾟ", "ピ"},
-        {"ﾌ", "フ"},
-        {"ﾌﾞ", "ブ"},
-        {"ﾌﾟ", "プ"},
-        {"ﾍ", "ヘ"},
-        {"ﾍﾞ", "ベ"},
-        {"ﾍﾟ", "ペ"},
-        {"ﾎ", "ホ"},
-        {"ﾎﾞ", "ボ"},
-        {"ﾎﾟ", "ポ"},
-        {"ﾏ", "マ"},
-        {"ﾐ", "ミ"},
-        {"ﾑ", "ム"},
-        {"ﾒ", "メ"},
-        {"ﾓ", "モ"},
-        {"ﾔ", "ヤ"},
-        {"ﾕ", "ユ"},
-        {"ﾖ", "ヨ"},
-        {"ﾗ", "ラ"},
-        {"ﾘ", "リ"},
-        {"ﾙ", "ル"},
-        {"ﾚ", "レ"},
-        {"ﾛ", "ロ"},
-        {"ﾜ", "ワ"},
-        {"ﾝ", "ン"},
-    };
-
-    QString res;
-    int i;
-    for (i = 0; i < query.size() - 1; ++i)
-    {
-        if (HALFWIDTH_LOW <= query[i] && query[i] <= HALFWIDTH_HIGH)
-        {
-            if ((query[i + 1] == HALFWIDTH_VOICED ||
-                 query[i + 1] == HALFWIDTH_SEMI_VOICED) &&
-                charMap.contains(query.mid(i, 2)))
-            {
-                res += charMap[query.mid(i, 2)];
-                ++i;
-            }
-            else
-            {
-                res += charMap[query[i]];
-            }
-        }
-        else
-        {
-            res += query[i];
-        }
-    }
-    if (i < query.size())
-    {
-        if (HALFWIDTH_LOW <= query[i] && query[i] <= HALFWIDTH_HIGH &&
-            charMap.contains(query[i]))
-        {
-            res += charMap[query[i]];
-        }
-        else
-        {
-            res += query[i];
-        }
-    }
-    return res;
-}
-
-static const QChar KATAKANA_LOW(0x30A1);
-static const QChar KATAKANA_HIGH(0x30F6);
-static const QChar HIRAGANA_LOW(0x3041);
-[[maybe_unused]] static const QChar HIRAGANA_HIGH(0x3096);
-
-QString DatabaseManager::kataToHira(QString query) const
-{
-    for (QChar &ch : query)
-    {
-        ushort code = ch.unicode();
-        if (code >= KATAKANA_LOW && code <= KATAKANA_HIGH)
-        {
-            ch = QChar(HIRAGANA_LOW.unicode() + (code - KATAKANA_LOW.unicode()));
-        }
-    }
-    return query;
-}
-
 QStringList DatabaseManager::jsonArrayToStringList(const char *jsonstr) const
 {
     QJsonDocument document = QJsonDocument::fromJson(jsonstr);
@@ -1140,4 +1679,25 @@ bool inline DatabaseManager::isStepError(const int step)
     return step != SQLITE_ROW && step != SQLITE_DONE;
 }
 
+int DatabaseManager::progressHandler(void *)
+{
+    return t_cancelToken && t_cancelToken->isCancelled();
+}
+
+void DatabaseManager::interruptReaders() const
+{
+    if (m_db)
+    {
+        m_interrupts.fetchAndAddOrdered(1);
+        sqlite3_interrupt(m_db);
+    }
+}
+
+bool DatabaseManager::interruptedByWrite(
+    const int interrupts,
+    const CancellationToken &token) const
+{
+    return !token.isCancelled() && m_interrupts.loadAcquire() != interrupts;
+}
+
 /* End Helpers */
@@ -21,25 +21,49 @@
 #ifndef DATABASEMANAGER_H
 #define DATABASEMANAGER_H
 
+#include <QAtomicInt>
+#include <QFuture>
+#include <QMutex>
 #include <QReadWriteLock>
 #include <QSet>
 #include <QString>
 #include <sqlite3.h>
 
+#include "cancellationtoken.h"
 #include "expression.h"
+#include "termbackend.h"
 
 /**
  * Manages all interaction with the dictionary database on the backend.
  */
-class DatabaseManager
+class DatabaseManager : public TermBackend
 {
 public:
+    /**
+     * How the dictionary database is kept in memory.
+     */
+    enum class StorageProfile
+    {
+        /* Read pages from disk through the SQLite page cache */
+        disk,
+
+        /* Memory-map the database and use a larger page cache */
+        mapped,
+
+        /* Copy the entire database into memory */
+        memory,
+    };
+
     /**
      * Constructs a database manager with the specified database. Creates the
-     * database if it doesn't already exist.
-     * @param path The path to the dictionary database.
+     * database if it doesn't already exist. Mapped and in-memory databases are
+     * warmed up in the background.
+     * @param path    The path to the dictionary database.
+     * @param profile How the database is kept in memory.
      */
-    DatabaseManager(const QString &path);
+    DatabaseManager(
+        const QString &path,
+        StorageProfile profile = StorageProfile::disk);
     ~DatabaseManager();
 
     /**
@@ -86,29 +110,119 @@ public:
      */
     QStringList getDisabledDictionaries() const;
 
+    /**
+     * Gets the names of every dictionary in the database by id.
+     * @return A map of dictionary ids to dictionary names.
+     */
+    QHash<uint64_t, QString> getDictionaryIds() const;
+
     /**
      * Searches for terms that exactly match the query. Does automatic
-     * conversion from katakana to hiragana.
-     * @param      query The term to query for.
-     * @param[out] terms A list of matching terms. Belongs to the caller.
+     * conversion from katakana to hiragana. Only the fields needed to rank
+     * terms are set (expression, reading, and score). Call loadTerms() to load
+     * the rest.
+     * @param      query      The term to query for.
+     * @param      ruleFilter If not empty, only terms with at least one
+     *                        definition matching one of these rules are
+     *                        returned.
+     * @param[out] terms      A list of matching terms. Belongs to the caller.
+     * @param      token      Cancels the query. Running SQL statements are
+     *                        interrupted as soon as the token is cancelled.
+     * @return Empty string on success, error string on error. Cancelled
+     *         queries return an error string and leave terms untouched.
+     */
+    QString queryTerms(
+        const QString &query,
+        const QSet<QString> &ruleFilter,
+        QList<SharedTerm> &terms,
+        const CancellationToken &token = CancellationToken()) const override;
+
+    /**
+     * Searches the glossaries of every enabled dictionary for words in the
+     * query. The last word is matched as a prefix if it is longer than one
+     * character. Only the fields needed to rank terms are set (expression,
+     * reading, and score).
+     * @param      query The text to look for in glossaries.
+     * @param      limit The maximum number of definitions to match.
+     * @param[out] terms The matching terms ordered from best to worst match.
+     *                   Belongs to the caller.
+     * @param      token Cancels the query. Running SQL statements are
+     *                   interrupted as soon as the token is cancelled.
+     * @return Empty string on success, error string on error.
+     */
+    QString queryGlossary(
+        const QString &query,
+        int limit,
+        QList<SharedTerm> &terms,
+        const CancellationToken &token = CancellationToken()) const;
+
+    /**
+     * Loads the definitions, tags, frequencies, and pitches of terms returned
+     * by queryTerms().
+     * @param[out] terms The terms to load.
+     * @param      token Cancels loading. Running SQL statements are
+     *                   interrupted as soon as the token is cancelled.
      * @return Empty string on success, error string on error.
      */
-    QString queryTerms(const QString &query, QList<SharedTerm> &terms) const;
+    QString loadTerms(
+        const QList<SharedTerm> &terms,
+        const CancellationToken &token = CancellationToken()) const;
 
     /**
-     * Searches for kanji that exactly match the query.
+     * Searches for kanji that exactly match the query. Served from memory.
      * @param      query The kanji to look for. Should be a single character.
      * @param[out] kanji The Kanji struct to populate.
      * @return Empty string on success, error string on error.
      */
     QString queryKanji(const QString &query, Kanji &kanji) const;
 
+    /**
+     * Compiles the terms of every enabled dictionary into a term pack that
+     * can be searched in place of queryTerms().
+     * @param path The path to write the pack to.
+     * @return Empty string on success, error string on error.
+     */
+    QString compileTermPack(const QString &path) const;
+
 private:
+    /**
+     * Applies the storage profile to a connection and installs the progress
+     * handler.
+     * @param db The connection to configure.
+     */
+    void configureConnection(sqlite3 *db) const;
+
+    /**
+     * Copies the database on disk into a new in-memory connection.
+     * @return The in-memory connection, nullptr on failure.
+     */
+    sqlite3 *copyToMemory() const;
+
+    /**
+     * Brings the connection up to date with the database on disk after it has
+     * been modified. Expects the write lock to be held.
+     */
+    void refreshStorage();
+
+    /**
+     * Loads the database into memory ahead of the first lookup. Run in the
+     * background from the constructor.
+     */
+    void warmUp();
+
     /**
      * Initializes the dictionary cache so ids can be quickly mapped to names.
      */
     int initCache();
 
+    /**
+     * Loads every enabled kanji and its frequencies into memory so kanji
+     * lookups never touch the database. Expects the dictionary and tag caches
+     * to be initialized.
+     * @return An SQLite error code on failure.
+     */
+    int initKanjiCache();
+
     /**
      * Gets the name of the dictionary corresponding the ID.
      * @param id The id of the dictionary to look for.
@@ -117,7 +231,7 @@ private:
     QString getDictionary(const uint64_t id) const;
 
     /**
-     * Helper method for queryTerms.
+     * Helper method for loadTerms.
      * @param[out] terms A list of Term structs with the expression and reading
      *                   fields populated.
      * @return An SQLite error code on failure.
@@ -125,28 +239,30 @@ private:
     int populateTerms(const QList<SharedTerm> &terms) const;
 
     /**
-     * Helper method for retrieving tag information.
+     * Helper method for retrieving tag information. Tags are copied from the
+     * tag cache so their strings are shared instead of allocated.
      * @param      id     The id of the dictionary the tag comes from.
-     * @param      tagStr The name of the tag.
+     * @param      tagStr The space separated UTF-8 names of the tags.
      * @param[out] tags   The list to put the tags in.
      */
     void addTags(const uint64_t  id,
-                 const QString  &tagStr,
+                 const char     *tagStr,
                  QList<Tag>     &tags) const;
 
     /**
-     * Adds term frequencies to a Term struct.
-     * @param[out] term The term struct to add frequencies to.
-     * @return An SQLite error code on failure.
+     * Gets the shared copy of a deconjugation rule name so every definition
+     * with the rule refers to the same string. Thread safe.
+     * @param rule The UTF-8 name of the rule.
+     * @return The shared rule name.
      */
-    int addFrequencies(Term &term) const;
+    QString internRule(const QByteArray &rule) const;
 
     /**
-     * Adds kanji frequencies to a Kanji struct.
-     * @param[out] kanji The kanji struct to add frequencies to.
+     * Adds term frequencies to a Term struct.
+     * @param[out] term The term struct to add frequencies to.
      * @return An SQLite error code on failure.
      */
-    int addFrequencies(Kanji &kanji) const;
+    int addFrequencies(Term &term) const;
 
     /**
      * Adds frequencies to a frequency list. Should probably not be called
@@ -173,17 +289,18 @@ private:
     int addPitches(Term &term) const;
 
     /**
-     * Converts half-width katakana to full-width katakana.
-     * @param query The query string to convert.
-     */
-    QString halfToFull(const QString &query) const;
-
-    /**
-     * Converts all the katakana in a string to their equivalent hiragana.
-     * @param query The string to convert.
-     * @return Query with all the katakana replaced with hiragana.
+     * Parses the frequency in the current row of a frequency query. The
+     * statement must select dic_id, data, and type as its first three
+     * columns.
+     * @param      stmt    The statement positioned on a row.
+     * @param      reading The reading of the term if available.
+     * @param[out] freqStr The frequency to show.
+     * @return true if the row has a frequency for the reading, false otherwise.
      */
-    QString kataToHira(QString query) const;
+    bool parseFrequency(
+        sqlite3_stmt *stmt,
+        const QString &reading,
+        QString &freqStr) const;
 
     /**
      * Converts a raw JSON array of strings to a QStringList.
@@ -199,6 +316,32 @@ private:
      */
     static bool inline isStepError(const int step);
 
+    /**
+     * SQLite progress handler. Interrupts the running statement if the
+     * cancellation token of the calling thread has been cancelled.
+     * @param data Unused.
+     * @return Nonzero to interrupt the statement, zero to continue.
+     */
+    static int progressHandler(void *data);
+
+    /**
+     * Interrupts every statement running on the connection so pending
+     * searches give up the database lock quickly. Used before writes.
+     */
+    void interruptReaders() const;
+
+    /**
+     * Checks if a failed read was interrupted by a write rather than by its
+     * caller, in which case it should be retried.
+     * @param interrupts The value of m_interrupts before the read started.
+     * @param token      The cancellation token of the read.
+     * @return true if the read should be retried, false otherwise.
+     */
+    [[nodiscard]]
+    bool interruptedByWrite(
+        int interrupts,
+        const CancellationToken &token) const;
+
     /* A readonly connection to the dictionary database. */
     sqlite3 *m_db;
 
@@ -208,14 +351,40 @@ private:
     /* Saved path to the database. */
     const QByteArray m_dbpath;
 
+    /* How the database is kept in memory. */
+    const StorageProfile m_profile;
+
+    /* true if m_db is an in-memory copy of the database, false otherwise. */
+    bool m_inMemory = false;
+
+    /* The background warm-up pass. */
+    QFuture<void> m_warmUp;
+
+    /* Set to nonzero to stop the warm-up pass early. */
+    QAtomicInt m_stopWarmUp;
+
+    /* Incremented every time readers are interrupted for a write. */
+    mutable QAtomicInt m_interrupts;
+
     /* A set containing special characters that cannot be independent mora. */
     QSet<QString> m_moraSkipChar;
 
     /* Maps dictionary IDs to dictionary names. */
     QHash<const uint64_t, QString> m_dictionaryCache;
 
-    /* Maps dictionary IDs to a mapping between tag names and Tag structs. */
-    QHash<const uint64_t, QHash<QString, Tag>> m_tagCache;
+    /* Maps dictionary IDs to a mapping between UTF-8 tag names and Tag
+     * structs. */
+    QHash<const uint64_t, QHash<QByteArray, Tag>> m_tagCache;
+
+    /* Maps the code points of every enabled kanji to its definitions and
+     * frequencies. */
+    QHash<char32_t, Kanji> m_kanjiCache;
+
+    /* Maps UTF-8 rule names to shared rule names. */
+    mutable QHash<QByteArray, QString> m_ruleCache;
+
+    /* Locks the rule cache. */
+    mutable QMutex m_ruleLock;
 };
 
 #endif // DATABASEMANAGER_H
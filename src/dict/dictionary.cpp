@@ -25,13 +25,16 @@
 #include <QApplication>
 #include <QDebug>
 #include <QMessageBox>
+#include <QMutex>
 #include <QReadLocker>
 #include <QSettings>
 #include <QWriteLocker>
+#include <QtConcurrent>
 
 #include "databasemanager.h"
 #include "deconjugationquerygenerator.h"
 #include "exactquerygenerator.h"
+#include "termpack.h"
 
 #ifdef MECAB_SUPPORT
 #include "mecabquerygenerator.h"
@@ -41,14 +44,41 @@
 #include "util/globalmediator.h"
 #include "util/utils.h"
 
+/* The number of definitions a glossary search ranks */
+#define GLOSSARY_MATCH_LIMIT 200
+
 /* Begin Constructor/Destructor */
 
 Dictionary::Dictionary(QObject *parent) : QObject(parent)
 {
-    m_db = std::make_unique<DatabaseManager>(DirectoryUtils::getDictionaryDB());
+    QSettings settings;
+    settings.beginGroup(Constants::Settings::Database::GROUP);
+    const QString profileName = settings.value(
+        Constants::Settings::Database::PROFILE,
+        Constants::Settings::Database::PROFILE_DEFAULT
+    ).toString();
+    settings.endGroup();
+
+    DatabaseManager::StorageProfile profile =
+        DatabaseManager::StorageProfile::disk;
+    if (profileName == Constants::Settings::Database::Profile::MAPPED)
+    {
+        profile = DatabaseManager::StorageProfile::mapped;
+    }
+    else if (profileName == Constants::Settings::Database::Profile::MEMORY)
+    {
+        profile = DatabaseManager::StorageProfile::memory;
+    }
+    m_db = std::make_unique<DatabaseManager>(
+        DirectoryUtils::getDictionaryDB(), profile
+    );
 
     initDictionaryOrder();
     initQueryGenerators();
+    initResultLimit();
+
+    m_packPool.setMaxThreadCount(1);
+    initTermBackend();
 
     GlobalMediator *med = GlobalMediator::getGlobalMediator();
     med->setDictionary(this);
@@ -56,23 +86,41 @@ Dictionary::Dictionary(QObject *parent) : QObject(parent)
         med, &GlobalMediator::dictionaryOrderChanged,
         this, &Dictionary::initDictionaryOrder
     );
+    connect(
+        med, &GlobalMediator::dictionariesChanged,
+        this, &Dictionary::initDictionaryOrder
+    );
+    connect(
+        med, &GlobalMediator::dictionariesChanged,
+        this, &Dictionary::initTermBackend
+    );
     connect(
         med, &GlobalMediator::searchSettingsChanged,
         this, &Dictionary::initQueryGenerators
     );
+    connect(
+        med, &GlobalMediator::searchSettingsChanged,
+        this, &Dictionary::initResultLimit
+    );
 }
 
 void Dictionary::initDictionaryOrder()
 {
+    const QHash<uint64_t, QString> dicts = m_db->getDictionaryIds();
+
     m_dicOrder.lock.lockForWrite();
 
     QSettings settings;
     settings.beginGroup(Constants::Settings::Dictionaries::GROUP);
-    QStringList dicts = m_db->getDictionaries();
     m_dicOrder.map.clear();
-    for (const QString &dict : dicts)
+    m_dicOrder.ranks.clear();
+    for (auto it = dicts.constKeyValueBegin();
+         it != dicts.constKeyValueEnd();
+         ++it)
     {
-        m_dicOrder.map[dict] = settings.value(dict).toInt();
+        const int priority = settings.value(it->second).toInt();
+        m_dicOrder.map[it->second] = priority;
+        m_dicOrder.ranks[it->first] = priority;
     }
     settings.endGroup();
 
@@ -116,7 +164,17 @@ void Dictionary::initQueryGenerators()
     ).toBool();
     if (mecabIpadicMatching)
     {
-        m_generators.emplace_back(std::make_unique<MeCabQueryGenerator>());
+        const int maxCandidates = settings.value(
+            Constants::Settings::Search::Matcher::MECAB_MAX_CANDIDATES,
+            Constants::Settings::Search::Matcher::MECAB_MAX_CANDIDATES_DEFAULT
+        ).toInt();
+        const int maxPathLength = settings.value(
+            Constants::Settings::Search::Matcher::MECAB_MAX_PATH,
+            Constants::Settings::Search::Matcher::MECAB_MAX_PATH_DEFAULT
+        ).toInt();
+        m_generators.emplace_back(
+            std::make_unique<MeCabQueryGenerator>(maxCandidates, maxPathLength)
+        );
         if (!m_generators.back()->valid())
         {
             m_generators.pop_back();
@@ -149,9 +207,55 @@ void Dictionary::initQueryGenerators()
 #endif // MECAB_SUPPORT
 }
 
-Dictionary::~Dictionary()
+void Dictionary::initResultLimit()
+{
+    QSettings settings;
+    settings.beginGroup(Constants::Settings::Search::GROUP);
+    m_resultLimit.storeRelaxed(
+        settings.value(
+            Constants::Settings::Search::LIMIT,
+            Constants::Settings::Search::LIMIT_DEFAULT
+        ).toInt()
+    );
+    settings.endGroup();
+}
+
+void Dictionary::initTermBackend()
 {
+    const int generation = m_packGeneration.fetchAndAddOrdered(1) + 1;
+
+    QSettings settings;
+    settings.beginGroup(Constants::Settings::Database::GROUP);
+    const bool enabled = settings.value(
+        Constants::Settings::Database::PACK,
+        Constants::Settings::Database::PACK_DEFAULT
+    ).toBool();
+    settings.endGroup();
+
+    /* Out of date packs return the wrong terms, so fall back to the database
+     * until the pack is rebuilt */
+    const QString dbPath = DirectoryUtils::getDictionaryDB();
+    {
+        QWriteLocker locker(&m_packLock);
+        if (enabled && m_pack && m_pack->isCurrent(dbPath))
+        {
+            return;
+        }
+        m_pack.reset();
+    }
+    if (!enabled)
+    {
+        return;
+    }
+
+    m_packPool.start([this, generation] { buildTermPack(generation); });
+}
 
+Dictionary::~Dictionary()
+{
+    m_packGeneration.fetchAndAddOrdered(1);
+    m_packPool.clear();
+    m_packPool.waitForDone();
 }
 
 /* End Constructor/Destructor */
@@ -161,85 +265,195 @@ SharedTermList Dictionary::searchTerms(
     const QString query,
     const QString subtitle,
     const int index,
-    const int *currentIndex)
+    const CancellationToken &token,
+    const int limit)
 {
-    std::vector<SearchQuery> queries = generateQueries(query);
-    if (index != *currentIndex)
+    std::vector<SearchQuery> queries;
+    QHash<QString, QList<SharedTerm>> results;
+    if (!generateQueries(query, token, queries, results) ||
+        token.isCancelled())
     {
         return nullptr;
     }
 
     sortQueries(queries);
     filterDuplicates(queries);
-    if (index != *currentIndex)
+    if (token.isCancelled())
     {
         return nullptr;
     }
 
-    /* Query the database */
-    SharedTermList terms = SharedTermList(new QList<SharedTerm>);
-    for (const SearchQuery &query : queries)
+    return searchQueries(
+        queries, std::move(results), subtitle, index, token, limit
+    );
+}
+
+SharedTermList Dictionary::searchTerms(
+    const SharedTextAnalysis &analysis,
+    const int index,
+    const CancellationToken &token,
+    const int limit)
+{
+    if (analysis == nullptr)
     {
-        if (index != *currentIndex)
+        return nullptr;
+    }
+    return searchQueries(
+        analysis->queries(index), {}, analysis->text(), index, token, limit
+    );
+}
+
+SharedTextAnalysis Dictionary::analyzeText(
+    const QString &text,
+    const qsizetype maxLength) const
+{
+    std::vector<std::vector<SearchQuery>> queries(text.size());
+    {
+        QReadLocker lock{&m_generatorsMutex};
+
+        /* Run every generator but the first in the background */
+        std::vector<QFuture<std::vector<std::vector<SearchQuery>>>> futures;
+        for (size_t i = 1; i < m_generators.size(); ++i)
         {
-            return nullptr;
+            const QueryGenerator *gen = m_generators[i].get();
+            futures.emplace_back(
+                QtConcurrent::run(
+                    &m_lookupPool,
+                    [gen, &text, maxLength] {
+                        return gen->generateLineQueries(text, maxLength);
+                    }
+                )
+            );
         }
 
-        QList<SharedTerm> results;
-        QString err = m_db->queryTerms(query.deconj, results);
-        if (!err.isEmpty())
+        auto merge = [&queries] (
+            std::vector<std::vector<SearchQuery>> genQueries)
         {
-            qDebug() << err;
-            return nullptr;
+            for (size_t i = 0; i < genQueries.size() && i < queries.size(); ++i)
+            {
+                queries[i].insert(
+                    std::end(queries[i]),
+                    std::make_move_iterator(std::begin(genQueries[i])),
+                    std::make_move_iterator(std::end(genQueries[i]))
+                );
+            }
+        };
+        if (!m_generators.empty())
+        {
+            merge(m_generators.front()->generateLineQueries(text, maxLength));
         }
-        if (query.ruleFilter.size() > 0)
+        for (QFuture<std::vector<std::vector<SearchQuery>>> &future : futures)
         {
-            results.erase(
-                std::remove_if(
-                    results.begin(),
-                    results.end(),
-                    [&] (const SharedTerm &val)
-                    {
-                        for (const TermDefinition &def : val->definitions)
-                        {
-                            if (def.rules.intersects(query.ruleFilter))
-                            {
-                                return false;
-                            }
-                        }
-                        return true;
-                    }
-                ),
-                results.end()
-            );
+            merge(future.result());
         }
+    }
+
+    for (std::vector<SearchQuery> &positionQueries : queries)
+    {
+        sortQueries(positionQueries);
+        filterDuplicates(positionQueries);
+    }
+
+    return std::make_shared<const TextAnalysis>(text, std::move(queries));
+}
 
-        QString clozePrefix;
-        QString clozeBody;
-        QString clozeSuffix;
-        if (!results.isEmpty())
+SharedTermList Dictionary::searchQueries(
+    const std::vector<SearchQuery> &queries,
+    QHash<QString, QList<SharedTerm>> results,
+    const QString &subtitle,
+    const int index,
+    const CancellationToken &token,
+    int limit)
+{
+    /* Every term found shares the subtitle instead of copying pieces of it */
+    const SharedLookupContext lookup(new LookupContext{subtitle});
+
+    /* Query the database for everything needed to rank the terms */
+    const std::shared_ptr<const TermBackend> backend = getTermBackend();
+    SharedTermList terms = SharedTermList(new QList<SharedTerm>);
+    for (const SearchQuery &query : queries)
+    {
+        if (token.isCancelled())
         {
-            clozePrefix = subtitle.left(index);
-            clozeBody   = subtitle.mid(index, query.surface.size());
-            clozeSuffix = subtitle.right(
-                subtitle.size() - (index + query.surface.size())
+            return nullptr;
+        }
+
+        /* Results are taken so a duplicate query gets its own terms */
+        const QString key = queryKey(query);
+        QList<SharedTerm> queryResults;
+        if (results.contains(key))
+        {
+            queryResults = results.take(key);
+        }
+        else
+        {
+            QString err = backend->queryTerms(
+                query.deconj, query.ruleFilter, queryResults, token
             );
+            if (token.isCancelled())
+            {
+                return nullptr;
+            }
+            else if (!err.isEmpty())
+            {
+                qDebug() << err;
+                return nullptr;
+            }
         }
 
-        for (SharedTerm term : results)
+        for (SharedTerm term : queryResults)
         {
-            term->sentence = subtitle;
-            term->clozePrefix = clozePrefix;
-            term->clozeBody = clozeBody;
-            term->clozeSuffix = clozeSuffix;
+            term->lookup = lookup;
+            term->matchOffset = index;
+            term->matchLength = query.surface.size();
             term->conjugationExplanation = query.conjugationExplanation;
         }
 
-        terms->append(std::move(results));
+        terms->append(std::move(queryResults));
     }
 
     sortTerms(terms);
-    if (index != *currentIndex)
+    if (token.isCancelled() || !loadFirstPage(terms, token, limit))
+    {
+        return nullptr;
+    }
+
+    return terms;
+}
+
+SharedTermList Dictionary::searchGlossary(
+    const QString &query,
+    const CancellationToken &token,
+    const int limit)
+{
+    QList<SharedTerm> found;
+    QString err = m_db->queryGlossary(
+        query, GLOSSARY_MATCH_LIMIT, found, token
+    );
+    if (token.isCancelled())
+    {
+        return nullptr;
+    }
+    else if (!err.isEmpty())
+    {
+        qDebug() << err;
+        return nullptr;
+    }
+
+    /* Nothing in the query is part of the term, so there is nothing to cloze */
+    const SharedLookupContext lookup(new LookupContext{query});
+    for (SharedTerm &term : found)
+    {
+        term->lookup = lookup;
+        term->matchOffset = 0;
+        term->matchLength = 0;
+    }
+
+    /* Terms are already ranked by the database */
+    SharedTermList terms = SharedTermList(
+        new QList<SharedTerm>(std::move(found))
+    );
+    if (!loadFirstPage(terms, token, limit))
     {
         return nullptr;
     }
@@ -247,21 +461,158 @@ SharedTermList Dictionary::searchTerms(
     return terms;
 }
 
-std::vector<SearchQuery> Dictionary::generateQueries(const QString &text) const
+bool Dictionary::loadFirstPage(
+    const SharedTermList &terms,
+    const CancellationToken &token,
+    int limit) const
+{
+    /* Only load the terms that will be shown */
+    if (limit < 0)
+    {
+        limit = m_resultLimit.loadRelaxed();
+    }
+    const QList<SharedTerm> page = terms->mid(0, limit);
+    QString err = m_db->loadTerms(page, token);
+    if (token.isCancelled())
+    {
+        return false;
+    }
+    else if (!err.isEmpty())
+    {
+        qDebug() << err;
+        return false;
+    }
+    sortTermContents(page);
+
+    return true;
+}
+
+SharedTermList Dictionary::loadTerms(
+    const QList<QSharedPointer<const Term>> &terms,
+    const int cursor,
+    const int limit,
+    const CancellationToken &token) const
+{
+    SharedTermList page = SharedTermList(new QList<SharedTerm>);
+    QList<SharedTerm> unloaded;
+    for (qsizetype i = std::max(cursor, 0);
+         i < terms.size() && i < cursor + limit;
+         ++i)
+    {
+        SharedTerm term = SharedTerm::create(*terms[i]);
+        if (!term->loaded)
+        {
+            unloaded.append(term);
+        }
+        page->append(term);
+    }
+    if (unloaded.isEmpty())
+    {
+        return page;
+    }
+
+    QString err = m_db->loadTerms(unloaded, token);
+    if (token.isCancelled())
+    {
+        return nullptr;
+    }
+    else if (!err.isEmpty())
+    {
+        qDebug() << err;
+        return nullptr;
+    }
+    sortTermContents(unloaded);
+
+    return page;
+}
+
+bool Dictionary::generateQueries(
+    const QString &text,
+    const CancellationToken &token,
+    std::vector<SearchQuery> &queries,
+    QHash<QString, QList<SharedTerm>> &results) const
 {
     QReadLocker lock{&m_generatorsMutex};
 
-    std::vector<SearchQuery> queries;
-    for (const std::unique_ptr<QueryGenerator> &gen : m_generators)
+    const std::shared_ptr<const TermBackend> backend = getTermBackend();
+    QMutex resultsLock;
+    bool success = true;
+
+    /* Generates queries and looks them up without waiting on other
+     * generators. Queries already claimed by another generator are skipped. */
+    auto generate = [&] (const QueryGenerator *gen)
     {
-        std::vector<SearchQuery> currQueries = gen->generateQueries(text);
+        std::vector<SearchQuery> genQueries = gen->generateQueries(text);
+        for (const SearchQuery &query : genQueries)
+        {
+            if (token.isCancelled())
+            {
+                break;
+            }
+
+            const QString key = queryKey(query);
+            {
+                QMutexLocker locker(&resultsLock);
+                if (results.contains(key))
+                {
+                    continue;
+                }
+                results.insert(key, {});
+            }
+
+            QList<SharedTerm> terms;
+            QString err = backend->queryTerms(
+                query.deconj, query.ruleFilter, terms, token
+            );
+
+            QMutexLocker locker(&resultsLock);
+            if (!err.isEmpty())
+            {
+                if (!token.isCancelled())
+                {
+                    qDebug() << err;
+                }
+                success = false;
+                break;
+            }
+            results[key] = std::move(terms);
+        }
+
+        QMutexLocker locker(&resultsLock);
         queries.insert(
             std::end(queries),
-            std::make_move_iterator(std::begin(currQueries)),
-            std::make_move_iterator(std::end(currQueries))
+            std::make_move_iterator(std::begin(genQueries)),
+            std::make_move_iterator(std::end(genQueries))
+        );
+    };
+
+    /* Run every generator but the first in the background */
+    std::vector<QFuture<void>> futures;
+    for (size_t i = 1; i < m_generators.size(); ++i)
+    {
+        futures.emplace_back(
+            QtConcurrent::run(&m_lookupPool, generate, m_generators[i].get())
         );
     }
-    return queries;
+    if (!m_generators.empty())
+    {
+        generate(m_generators.front().get());
+    }
+    for (QFuture<void> &future : futures)
+    {
+        future.waitForFinished();
+    }
+
+    return success;
+}
+
+QString Dictionary::queryKey(const SearchQuery &query)
+{
+    QStringList rules(
+        std::begin(query.ruleFilter), std::end(query.ruleFilter)
+    );
+    rules.sort();
+    return query.deconj + QChar('\t') + rules.join(' ');
 }
 
 void Dictionary::sortQueries(std::vector<SearchQuery> &queries)
@@ -323,14 +674,14 @@ void Dictionary::filterDuplicates(std::vector<SearchQuery> &queries)
     queries.erase(last, std::end(queries));
 }
 
-void Dictionary::sortTerms(SharedTermList &terms) const
+void Dictionary::sortTerms(SharedTermList &terms)
 {
     std::sort(std::begin(*terms), std::end(*terms),
         [] (const SharedTerm &lhs, const SharedTerm &rhs) -> bool
         {
-            if (lhs->clozeBody.size() != rhs->clozeBody.size())
+            if (lhs->matchLength != rhs->matchLength)
             {
-                return lhs->clozeBody.size() > rhs->clozeBody.size();
+                return lhs->matchLength > rhs->matchLength;
             }
             if (lhs->expression.size() != rhs->expression.size())
             {
@@ -345,24 +696,33 @@ void Dictionary::sortTerms(SharedTermList &terms) const
             return lhs->score > rhs->score;
         }
     );
+}
 
-    m_dicOrder.lock.lockForRead();
-    for (SharedTerm term : *terms)
+void Dictionary::sortTermContents(const QList<SharedTerm> &terms) const
+{
+    const QHash<uint64_t, int> ranks = getDictionaryRanks();
+    for (SharedTerm term : terms)
     {
+        for (TermDefinition &def : term->definitions)
+        {
+            def.priority = ranks.value(def.dictionaryId);
+        }
+        for (Frequency &freq : term->frequencies)
+        {
+            freq.priority = ranks.value(freq.dictionaryId);
+        }
+
         std::sort(std::begin(term->definitions), std::end(term->definitions),
-            [=] (const TermDefinition &lhs, const TermDefinition &rhs) -> bool
+            [] (const TermDefinition &lhs, const TermDefinition &rhs) -> bool
             {
-                uint32_t lhsPriority = m_dicOrder.map[lhs.dictionary];
-                uint32_t rhsPriority = m_dicOrder.map[rhs.dictionary];
-                return lhsPriority < rhsPriority ||
-                       (lhsPriority == rhsPriority && lhs.score > rhs.score);
+                return lhs.priority < rhs.priority ||
+                       (lhs.priority == rhs.priority && lhs.score > rhs.score);
             }
         );
         std::sort(std::begin(term->frequencies), std::end(term->frequencies),
-            [=] (const Frequency &lhs, const Frequency &rhs) -> bool
+            [] (const Frequency &lhs, const Frequency &rhs) -> bool
             {
-                return m_dicOrder.map[lhs.dictionary] <
-                       m_dicOrder.map[rhs.dictionary];
+                return lhs.priority < rhs.priority;
             }
         );
         sortTags(term->tags);
@@ -371,7 +731,6 @@ void Dictionary::sortTerms(SharedTermList &terms) const
             sortTags(def.tags);
         }
     }
-    m_dicOrder.lock.unlock();
 }
 
 /* End Term Searching Methods */
@@ -389,20 +748,25 @@ SharedKanji Dictionary::searchKanji(const QString ch)
     }
 
     /* Sort all the information */
-    m_dicOrder.lock.lockForRead();
+    const QHash<uint64_t, int> ranks = getDictionaryRanks();
+    for (Frequency &freq : kanji->frequencies)
+    {
+        freq.priority = ranks.value(freq.dictionaryId);
+    }
+    for (KanjiDefinition &def : kanji->definitions)
+    {
+        def.priority = ranks.value(def.dictionaryId);
+    }
     std::sort(kanji->frequencies.begin(), kanji->frequencies.end(),
-        [=] (const Frequency &lhs, const Frequency &rhs) -> bool {
-            return m_dicOrder.map[lhs.dictionary] <
-                   m_dicOrder.map[rhs.dictionary];
+        [] (const Frequency &lhs, const Frequency &rhs) -> bool {
+            return lhs.priority < rhs.priority;
         }
     );
     std::sort(kanji->definitions.begin(), kanji->definitions.end(),
-        [=] (const KanjiDefinition &lhs, const KanjiDefinition &rhs) -> bool {
-            return m_dicOrder.map[lhs.dictionary] <
-                   m_dicOrder.map[rhs.dictionary];
+        [] (const KanjiDefinition &lhs, const KanjiDefinition &rhs) -> bool {
+            return lhs.priority < rhs.priority;
         }
     );
-    m_dicOrder.lock.unlock();
     for (KanjiDefinition &def : kanji->definitions)
     {
         sortTags(def.tags);
@@ -416,9 +780,11 @@ SharedKanji Dictionary::searchKanji(const QString ch)
 
 QString Dictionary::addDictionary(const QString &path)
 {
+    dropTermPack();
     int err = m_db->addDictionary(path);
     if (err)
     {
+        initTermBackend();
         return m_db->errorCodeToString(err);
     }
     Q_EMIT GlobalMediator::getGlobalMediator()->dictionariesChanged();
@@ -427,6 +793,7 @@ QString Dictionary::addDictionary(const QString &path)
 
 QString Dictionary::addDictionary(const QStringList &paths)
 {
+    dropTermPack();
     for (int i = 0; i < paths.size(); ++i)
     {
         int err = m_db->addDictionary(paths[i]);
@@ -437,6 +804,10 @@ QString Dictionary::addDictionary(const QStringList &paths)
                 Q_EMIT GlobalMediator::getGlobalMediator()
                     ->dictionariesChanged();
             }
+            else
+            {
+                initTermBackend();
+            }
             return m_db->errorCodeToString(err);
         }
     }
@@ -446,9 +817,11 @@ QString Dictionary::addDictionary(const QStringList &paths)
 
 QString Dictionary::deleteDictionary(const QString &name)
 {
+    dropTermPack();
     int err = m_db->deleteDictionary(name);
     if (err)
     {
+        initTermBackend();
         return m_db->errorCodeToString(err);
     }
     Q_EMIT GlobalMediator::getGlobalMediator()->dictionariesChanged();
@@ -458,6 +831,10 @@ QString Dictionary::deleteDictionary(const QString &name)
 QString Dictionary::disableDictionaries(const QStringList &dictionaries)
 {
     int err = m_db->disableDictionaries(dictionaries);
+
+    /* Also picks up changes to the term pack setting */
+    initTermBackend();
+
     if (err)
     {
         return m_db->errorCodeToString(err);
@@ -489,6 +866,69 @@ QStringList Dictionary::getDisabledDictionaries() const
 /* End Dictionary Methods */
 /* Begin Helpers */
 
+std::shared_ptr<const TermBackend> Dictionary::getTermBackend() const
+{
+    QReadLocker locker(&m_packLock);
+    if (m_pack)
+    {
+        return m_pack;
+    }
+
+    /* The database is owned by the dictionary, so don't take ownership */
+    return std::shared_ptr<const TermBackend>(
+        std::shared_ptr<const TermBackend>(), m_db.get()
+    );
+}
+
+void Dictionary::buildTermPack(int generation)
+{
+    if (m_packGeneration.loadAcquire() != generation)
+    {
+        return;
+    }
+
+    const QString packPath = DirectoryUtils::getDictionaryPack();
+    const QString dbPath = DirectoryUtils::getDictionaryDB();
+    std::shared_ptr<const TermPack> pack =
+        std::make_shared<const TermPack>(packPath);
+    if (!pack->isCurrent(dbPath))
+    {
+        /* Unmap the old pack so it can be replaced */
+        pack.reset();
+
+        QString err = m_db->compileTermPack(packPath);
+        if (!err.isEmpty())
+        {
+            qDebug() << "Could not compile dictionary pack:" << err;
+            return;
+        }
+        pack = std::make_shared<const TermPack>(packPath);
+        if (!pack->isCurrent(dbPath))
+        {
+            return;
+        }
+    }
+
+    QWriteLocker locker(&m_packLock);
+    if (m_packGeneration.loadAcquire() == generation)
+    {
+        m_pack = std::move(pack);
+    }
+}
+
+void Dictionary::dropTermPack()
+{
+    m_packGeneration.fetchAndAddOrdered(1);
+    QWriteLocker locker(&m_packLock);
+    m_pack.reset();
+}
+
+QHash<uint64_t, int> Dictionary::getDictionaryRanks() const
+{
+    QReadLocker lock{&m_dicOrder.lock};
+    return m_dicOrder.ranks;
+}
+
 void Dictionary::sortTags(QList<Tag> &tags) const
 {
     std::sort(std::begin(tags), std::end(tags),
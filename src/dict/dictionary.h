@@ -23,17 +23,24 @@
 
 #include <QObject>
 
+#include <QAtomicInt>
+#include <QHash>
 #include <QList>
 #include <QReadWriteLock>
 #include <QString>
+#include <QThreadPool>
 
 #include <memory>
 #include <vector>
 
+#include "cancellationtoken.h"
 #include "expression.h"
 #include "querygenerator.h"
+#include "textanalysis.h"
 
 class DatabaseManager;
+class TermBackend;
+class TermPack;
 
 /**
  * The intended API for interacting with the database.
@@ -48,21 +55,87 @@ public:
 
     /**
      * Searches for all terms in the query.
-     * @param query        The query to look for terms in. Only matches terms
-     *                     that start from the beginning of the query.
-     * @param subtitle     The subtitle the query appears in.
-     * @param index        The index into the subtitle where the query begins.
-     * @param currentIndex A pointer to the current index. If this value is no
-     *                     different from the index before this method is done,
-     *                     the search is aborted.
-     * @return A list of all the terms found, nullptr if the search was aborted.
+     * @param query    The query to look for terms in. Only matches terms that
+     *                 start from the beginning of the query.
+     * @param subtitle The subtitle the query appears in.
+     * @param index    The index into the subtitle where the query begins.
+     * @param token    Aborts the search when cancelled, including any database
+     *                 query in progress.
+     * @param limit    The number of top ranked terms to load. Negative values
+     *                 use the result limit from the search settings.
+     * @return A list of all the terms found in ranked order, nullptr if the
+     *         search was aborted. Terms past the limit are not loaded.
      *         Belongs to the caller.
      */
     SharedTermList searchTerms(
         const QString query,
         const QString subtitle,
         const int index,
-        const int *currentIndex);
+        const CancellationToken &token = CancellationToken(),
+        const int limit = -1);
+
+    /**
+     * Searches for all terms at a position in a line of analyzed text.
+     * @param analysis The analysis of the line being searched.
+     * @param index    The index into the line where the query begins.
+     * @param token    Aborts the search when cancelled, including any database
+     *                 query in progress.
+     * @param limit    The number of top ranked terms to load. Negative values
+     *                 use the result limit from the search settings.
+     * @return A list of all the terms found in ranked order, nullptr if the
+     *         search was aborted. Terms past the limit are not loaded.
+     *         Belongs to the caller.
+     */
+    SharedTermList searchTerms(
+        const SharedTextAnalysis &analysis,
+        const int index,
+        const CancellationToken &token = CancellationToken(),
+        const int limit = -1);
+
+    /**
+     * Searches for terms whose definitions contain the words in a query.
+     * Used to look up Japanese terms from another language.
+     * @param query The words to look for. The last word is matched as a
+     *              prefix if it is longer than one character.
+     * @param token Aborts the search when cancelled, including any database
+     *              query in progress.
+     * @param limit The number of top ranked terms to load. Negative values use
+     *              the result limit from the search settings.
+     * @return A list of all the terms found in ranked order, nullptr if the
+     *         search was aborted. Terms past the limit are not loaded.
+     *         Belongs to the caller.
+     */
+    SharedTermList searchGlossary(
+        const QString &query,
+        const CancellationToken &token = CancellationToken(),
+        const int limit = -1);
+
+    /**
+     * Loads a page of terms returned by searchTerms().
+     * @param terms  The ranked list of terms returned by searchTerms().
+     * @param cursor The index of the first term in the page.
+     * @param limit  The number of terms in the page.
+     * @param token  Aborts loading when cancelled.
+     * @return Loaded copies of the terms in the page, nullptr if loading was
+     *         aborted. Belongs to the caller.
+     */
+    SharedTermList loadTerms(
+        const QList<QSharedPointer<const Term>> &terms,
+        const int cursor,
+        const int limit,
+        const CancellationToken &token = CancellationToken()) const;
+
+    /**
+     * Analyzes a line of text once so terms can be searched for at every
+     * position in it without generating queries again.
+     * @param text      The line of text to analyze.
+     * @param maxLength The maximum length of text searched from a position.
+     * @return The analysis of the text.
+     */
+    [[nodiscard]]
+    SharedTextAnalysis analyzeText(
+        const QString &text,
+        const qsizetype maxLength) const;
 
     /**
      * Searches for a single kanji.
@@ -122,14 +195,77 @@ private Q_SLOTS:
      */
     void initQueryGenerators();
 
+    /**
+     * Reads the number of terms to load from the search settings.
+     */
+    void initResultLimit();
+
+    /**
+     * Chooses between searching the database and the compiled term pack.
+     * Rebuilds the term pack in the background if it is out of date. The
+     * database is searched until the rebuild finishes.
+     */
+    void initTermBackend();
+
 private:
     /**
-     * Generate queries from text.
-     * @param text The text to generate queries from.
-     * @return The list of SearchQuery.
+     * Generates queries from text by running every query generator in
+     * parallel. Queries are looked up in the database as soon as the
+     * generator that produced them finishes, so fast generators do not wait
+     * for slow ones.
+     * @param      text    The text to generate queries from.
+     * @param      token   Aborts generation when cancelled.
+     * @param[out] queries The list of SearchQuery, unsorted.
+     * @param[out] results Maps queryKey() of every query that was looked up to
+     *                     its results.
+     * @return true on success, false if a lookup failed or was cancelled.
+     */
+    bool generateQueries(
+        const QString &text,
+        const CancellationToken &token,
+        std::vector<SearchQuery> &queries,
+        QHash<QString, QList<SharedTerm>> &results) const;
+
+    /**
+     * Gets a key that is equal for queries that return the same terms.
+     * @param query The query.
+     * @return The key of the query.
      */
     [[nodiscard]]
-    std::vector<SearchQuery> generateQueries(const QString &text) const;
+    static QString queryKey(const SearchQuery &query);
+
+    /**
+     * Searches the database for all terms matching a list of queries.
+     * @param queries  The sorted and deduplicated queries.
+     * @param results  Results of queries that were already looked up, keyed by
+     *                 queryKey(). Queries not in here are looked up.
+     * @param subtitle The subtitle the queries appear in.
+     * @param index    The index into the subtitle where the queries begin.
+     * @param token    Aborts the search when cancelled.
+     * @param limit    The number of top ranked terms to load. Negative values
+     *                 use the result limit from the search settings.
+     * @return A list of all the terms found, nullptr if the search was aborted.
+     */
+    SharedTermList searchQueries(
+        const std::vector<SearchQuery> &queries,
+        QHash<QString, QList<SharedTerm>> results,
+        const QString &subtitle,
+        const int index,
+        const CancellationToken &token,
+        int limit);
+
+    /**
+     * Loads the top ranked terms of a search.
+     * @param terms The ranked terms.
+     * @param token Aborts loading when cancelled.
+     * @param limit The number of terms to load. Negative values use the result
+     *              limit from the search settings.
+     * @return true on success, false if loading failed or was aborted.
+     */
+    bool loadFirstPage(
+        const SharedTermList &terms,
+        const CancellationToken &token,
+        int limit) const;
 
     /**
      * Sorties queries in order from ascending length of the surface.
@@ -144,10 +280,49 @@ private:
     static void filterDuplicates(std::vector<SearchQuery> &queries);
 
     /**
-     * Sort the term list by priority and length.
+     * Sort the term list by length and score. Only uses fields that are set
+     * before terms are loaded.
      * @param[out] terms The term list to sort.
      */
-    void sortTerms(SharedTermList &terms) const;
+    static void sortTerms(SharedTermList &terms);
+
+    /**
+     * Sorts the definitions, frequencies, and tags of loaded terms by
+     * dictionary priority.
+     * @param[out] terms The terms to sort the contents of.
+     */
+    void sortTermContents(const QList<SharedTerm> &terms) const;
+
+    /**
+     * Gets the priority of every dictionary by id. Takes the dictionary order
+     * lock once so callers can sort without holding it.
+     * @return A map of dictionary ids to priorities. Lower values come first.
+     */
+    [[nodiscard]]
+    QHash<uint64_t, int> getDictionaryRanks() const;
+
+    /**
+     * Gets the backend terms are searched with.
+     * @return The term pack if it is enabled and up to date, the database
+     *         otherwise.
+     */
+    [[nodiscard]]
+    std::shared_ptr<const TermBackend> getTermBackend() const;
+
+    /**
+     * Compiles the term pack and switches to it if nothing has changed since
+     * the build was started. Run on the term pack pool.
+     * @param generation The value of m_packGeneration when the build was
+     *                   started.
+     */
+    void buildTermPack(int generation);
+
+    /**
+     * Stops using the term pack and cancels any build in progress. Called
+     * before the database is modified so lookups never see a pack that is
+     * out of date. initTermBackend() rebuilds it afterwards.
+     */
+    void dropTermPack();
 
     /**
      * Sorts tag by descending order, breaking ties on ascending score.
@@ -164,12 +339,34 @@ private:
     /* List of QueryGenerators */
     std::vector<std::unique_ptr<QueryGenerator>> m_generators;
 
+    /* Runs query generators in parallel with each other */
+    mutable QThreadPool m_lookupPool;
+
+    /* The number of top ranked terms loaded by a search */
+    QAtomicInt m_resultLimit;
+
+    /* The compiled term pack, nullptr if disabled or out of date */
+    std::shared_ptr<const TermPack> m_pack;
+
+    /* Locks m_pack */
+    mutable QReadWriteLock m_packLock;
+
+    /* Incremented every time the term backend is reinitialized. Stops
+     * outdated builds from replacing the current backend. */
+    QAtomicInt m_packGeneration;
+
+    /* Builds term packs one at a time */
+    QThreadPool m_packPool;
+
     /* Contains dictionary priority information. */
     struct DictOrder
     {
         /* Maps dictionary names to priorities. */
         QHash<QString, int> map;
 
+        /* Maps dictionary ids to priorities. */
+        QHash<uint64_t, int> ranks;
+
         /* Used for locking for reading and writing. */
         mutable QReadWriteLock lock;
     } m_dicOrder;
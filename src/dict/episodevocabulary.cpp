@@ -0,0 +1,596 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "episodevocabulary.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSettings>
+#include <QThread>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "dictionary.h"
+
+#include "util/constants.h"
+#include "util/utils.h"
+
+#define VOCABULARY_CACHE_MAGIC      "MMVOCB01"
+#define VOCABULARY_CACHE_VERSION    1
+#define VOCABULARY_CACHE_SUFFIX     ".vocabcache"
+
+/* The size the cache is trimmed to after every save */
+#define VOCABULARY_CACHE_MAX_SIZE   (32 * 1024 * 1024)
+
+static_assert(std::is_trivially_copyable_v<VocabularyCacheHeader>);
+static_assert(std::is_trivially_copyable_v<VocabularyCacheLine>);
+static_assert(std::is_trivially_copyable_v<VocabularyCacheWord>);
+static_assert(sizeof(VocabularyCacheHeader) == 32);
+static_assert(sizeof(VocabularyCacheLine) == 16);
+static_assert(sizeof(VocabularyCacheWord) == 16);
+static_assert(
+    sizeof(VOCABULARY_CACHE_MAGIC) - 1 == sizeof(VocabularyCacheHeader::magic)
+);
+
+/* Begin Constructor/Destructor */
+
+EpisodeVocabulary::EpisodeVocabulary(
+    Dictionary *dictionary,
+    qsizetype maxLength,
+    QObject *parent)
+    : QObject(parent),
+      m_dictionary(dictionary),
+      m_maxLength(maxLength)
+{
+    m_pool.setThreadPriority(QThread::LowestPriority);
+    initSettings();
+}
+
+EpisodeVocabulary::~EpisodeVocabulary()
+{
+    cancel();
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+/* End Constructor/Destructor */
+/* Begin Initializers */
+
+void EpisodeVocabulary::initSettings()
+{
+    QSettings settings;
+    settings.beginGroup(Constants::Settings::Search::GROUP);
+    m_settings.enabled = settings.value(
+            Constants::Settings::Search::VOCABULARY,
+            Constants::Settings::Search::VOCABULARY_DEFAULT
+        ).toBool();
+    m_settings.threads = settings.value(
+            Constants::Settings::Search::VOCABULARY_THREADS,
+            Constants::Settings::Search::VOCABULARY_THREADS_DEFAULT
+        ).toInt();
+    if (m_settings.threads < 1)
+    {
+        m_settings.threads =
+            Constants::Settings::Search::VOCABULARY_THREADS_DEFAULT;
+    }
+    settings.endGroup();
+
+    m_pool.setMaxThreadCount(m_settings.threads);
+    if (!m_settings.enabled)
+    {
+        cancel();
+    }
+}
+
+/* End Initializers */
+/* Begin Precomputing */
+
+void EpisodeVocabulary::precompute(const QStringList &lines)
+{
+    if (!m_settings.enabled || lines.isEmpty())
+    {
+        return;
+    }
+
+    QStringList unique = lines;
+    unique.removeAll(QString());
+    unique.removeDuplicates();
+    const QString key = cacheKey(unique);
+    {
+        QMutexLocker locker(&m_cache.lock);
+        if (m_cache.key == key)
+        {
+            return;
+        }
+    }
+
+    m_cancel.cancel();
+    m_pool.clear();
+    const CancellationToken token = m_cancel.token();
+    {
+        QMutexLocker locker(&m_cache.lock);
+        m_cache.key = key;
+        m_cache.lines.clear();
+    }
+
+    const int threads = m_settings.threads;
+    m_pool.start(
+        [=] {
+            QHash<QString, QList<Word>> cached;
+            if (load(key, cached))
+            {
+                QMutexLocker locker(&m_cache.lock);
+                if (!token.isCancelled() && m_cache.key == key)
+                {
+                    m_cache.lines = std::move(cached);
+                }
+                return;
+            }
+
+            std::shared_ptr<QAtomicInt> next =
+                std::make_shared<QAtomicInt>(0);
+            std::shared_ptr<QAtomicInt> running =
+                std::make_shared<QAtomicInt>(threads);
+            std::shared_ptr<QAtomicInt> failed =
+                std::make_shared<QAtomicInt>(0);
+            for (int i = 0; i < threads; ++i)
+            {
+                m_pool.start(
+                    [=] { run(token, key, unique, next, running, failed); }
+                );
+            }
+        }
+    );
+}
+
+void EpisodeVocabulary::cancel()
+{
+    m_cancel.cancel();
+    m_pool.clear();
+
+    QMutexLocker locker(&m_cache.lock);
+    m_cache.key.clear();
+    m_cache.lines.clear();
+}
+
+bool EpisodeVocabulary::lookup(
+    const QString &line,
+    int index,
+    Word &word) const
+{
+    QMutexLocker locker(&m_cache.lock);
+    auto it = m_cache.lines.constFind(line);
+    if (it == m_cache.lines.cend())
+    {
+        return false;
+    }
+
+    auto wordIt = std::lower_bound(it->cbegin(), it->cend(), index,
+        [] (const Word &lhs, int value)
+        {
+            return lhs.offset < value;
+        }
+    );
+    if (wordIt != it->cend() && wordIt->offset == index)
+    {
+        word = *wordIt;
+    }
+    else
+    {
+        word = Word();
+        word.offset = index;
+    }
+    return true;
+}
+
+bool EpisodeVocabulary::words(const QString &line, QList<Word> &words) const
+{
+    QMutexLocker locker(&m_cache.lock);
+    auto it = m_cache.lines.constFind(line);
+    if (it == m_cache.lines.cend())
+    {
+        return false;
+    }
+    words = *it;
+    return true;
+}
+
+QString EpisodeVocabulary::cacheKey(const QStringList &lines) const
+{
+    QCryptographicHash hasher(QCryptographicHash::Md5);
+
+    /* Anything that changes what a search finds has to change the key */
+    QStringList fingerprint;
+    fingerprint << QString::number(VOCABULARY_CACHE_VERSION)
+                << QString::number(m_maxLength)
+                << m_dictionary->getDictionaries()
+                << m_dictionary->getDisabledDictionaries();
+    QSettings settings;
+    settings.beginGroup(Constants::Settings::Search::GROUP);
+    for (const char *matcher : {
+            Constants::Settings::Search::Matcher::EXACT,
+            Constants::Settings::Search::Matcher::DECONJ,
+#ifdef MECAB_SUPPORT
+            Constants::Settings::Search::Matcher::MECAB_IPADIC,
+            Constants::Settings::Search::Matcher::MECAB_MAX_CANDIDATES,
+            Constants::Settings::Search::Matcher::MECAB_MAX_PATH,
+#endif // MECAB_SUPPORT
+        })
+    {
+        fingerprint << settings.value(matcher).toString();
+    }
+    settings.endGroup();
+    for (const QString &str : fingerprint)
+    {
+        hasher.addData(QByteArrayView(
+            (const char *)str.constData(), str.size() * sizeof(QChar)
+        ));
+        hasher.addData(QByteArrayView("\0", 1));
+    }
+
+    for (const QString &line : lines)
+    {
+        hasher.addData(QByteArrayView(
+            (const char *)line.constData(), line.size() * sizeof(QChar)
+        ));
+        hasher.addData(QByteArrayView("\0", 1));
+    }
+    return hasher.result().toHex();
+}
+
+void EpisodeVocabulary::run(
+    CancellationToken token,
+    QString key,
+    QStringList lines,
+    std::shared_ptr<QAtomicInt> next,
+    std::shared_ptr<QAtomicInt> running,
+    std::shared_ptr<QAtomicInt> failed)
+{
+    for (int i = next->fetchAndAddRelaxed(1);
+         i < lines.size();
+         i = next->fetchAndAddRelaxed(1))
+    {
+        if (token.isCancelled())
+        {
+            return;
+        }
+
+        QList<Word> words;
+        if (!lookupLine(lines[i], token, words))
+        {
+            if (token.isCancelled())
+            {
+                return;
+            }
+
+            /* The database was busy or broken. Leave the line out so it is
+             * searched normally, and don't save an incomplete episode. */
+            failed->storeRelaxed(1);
+            continue;
+        }
+
+        QMutexLocker locker(&m_cache.lock);
+        if (token.isCancelled() || m_cache.key != key)
+        {
+            return;
+        }
+        m_cache.lines.insert(lines[i], words);
+    }
+
+    /* The last thread out saves the episode */
+    if (running->fetchAndSubOrdered(1) != 1 || failed->loadRelaxed())
+    {
+        return;
+    }
+    QHash<QString, QList<Word>> snapshot;
+    {
+        QMutexLocker locker(&m_cache.lock);
+        if (token.isCancelled() || m_cache.key != key)
+        {
+            return;
+        }
+        snapshot = m_cache.lines;
+    }
+    QString err = save(key, snapshot);
+    if (!err.isEmpty())
+    {
+        qDebug() << err;
+    }
+}
+
+bool EpisodeVocabulary::lookupLine(
+    const QString &line,
+    const CancellationToken &token,
+    QList<Word> &words) const
+{
+    const SharedTextAnalysis analysis =
+        m_dictionary->analyzeText(line, m_maxLength);
+    for (int i = 0; i < line.size(); ++i)
+    {
+        if (analysis->queries(i).empty())
+        {
+            continue;
+        }
+
+        /* Terms are ranked longest match first without loading any */
+        SharedTermList terms = m_dictionary->searchTerms(analysis, i, token, 0);
+        if (terms == nullptr || token.isCancelled())
+        {
+            return false;
+        }
+        else if (terms->isEmpty())
+        {
+            continue;
+        }
+
+        const SharedTerm &term = terms->first();
+        Word word;
+        word.offset = i;
+        word.length = term->matchLength;
+        word.expression = term->expression;
+        word.reading = term->reading;
+        words.append(word);
+    }
+    return true;
+}
+
+/* End Precomputing */
+/* Begin On Disk Cache */
+
+/**
+ * Gets the path of a cache entry.
+ * @param key The key of the entry.
+ * @return The path to the entry.
+ */
+static QString entryPath(const QString &key)
+{
+    return QDir(DirectoryUtils::getVocabularyCacheDir())
+        .filePath(key + VOCABULARY_CACHE_SUFFIX);
+}
+
+bool EpisodeVocabulary::load(
+    const QString &key,
+    QHash<QString, QList<Word>> &lines)
+{
+    QFile file(entryPath(key));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size < (qint64)sizeof(VocabularyCacheHeader))
+    {
+        return false;
+    }
+    const uchar *data = file.map(0, size);
+    if (data == nullptr)
+    {
+        return false;
+    }
+
+    /* Validate the tables against the size of the file before reading any
+     * of them */
+    const VocabularyCacheHeader *header = (const VocabularyCacheHeader *)data;
+    const uint64_t linesSize =
+        (uint64_t)header->lineCount * sizeof(VocabularyCacheLine);
+    const uint64_t wordsSize =
+        (uint64_t)header->wordCount * sizeof(VocabularyCacheWord);
+    const uint64_t tableSize = size - sizeof(VocabularyCacheHeader);
+    const int magicCmp = std::memcmp(
+        header->magic, VOCABULARY_CACHE_MAGIC, sizeof(header->magic)
+    );
+    if (magicCmp != 0 ||
+        header->version != VOCABULARY_CACHE_VERSION ||
+        linesSize > tableSize ||
+        wordsSize > tableSize - linesSize ||
+        (tableSize - linesSize - wordsSize) / sizeof(char16_t) <
+            header->textSize)
+    {
+        file.unmap((uchar *)data);
+        return false;
+    }
+
+    const uchar *tables = data + sizeof(VocabularyCacheHeader);
+    const VocabularyCacheLine *cacheLines =
+        (const VocabularyCacheLine *)tables;
+    const VocabularyCacheWord *cacheWords =
+        (const VocabularyCacheWord *)(tables + linesSize);
+    const QChar *text = (const QChar *)(tables + linesSize + wordsSize);
+    const auto inText = [header] (uint64_t offset, uint64_t length)
+    {
+        return offset + length <= header->textSize;
+    };
+
+    QHash<QString, QList<Word>> cached;
+    cached.reserve(header->lineCount);
+    bool valid = true;
+    for (uint32_t i = 0; i < header->lineCount && valid; ++i)
+    {
+        const VocabularyCacheLine &line = cacheLines[i];
+        valid = inText(line.textOffset, line.textSize) &&
+            (uint64_t)line.firstWord + line.wordCount <= header->wordCount;
+
+        QList<Word> words;
+        words.reserve(valid ? line.wordCount : 0);
+        for (uint32_t j = 0; j < line.wordCount && valid; ++j)
+        {
+            const VocabularyCacheWord &cacheWord =
+                cacheWords[line.firstWord + j];
+            valid =
+                inText(cacheWord.expressionOffset, cacheWord.expressionSize) &&
+                inText(cacheWord.readingOffset, cacheWord.readingSize);
+            if (valid)
+            {
+                Word word;
+                word.offset = cacheWord.offset;
+                word.length = cacheWord.length;
+                word.expression = QString(
+                    text + cacheWord.expressionOffset, cacheWord.expressionSize
+                );
+                word.reading = QString(
+                    text + cacheWord.readingOffset, cacheWord.readingSize
+                );
+                words.append(word);
+            }
+        }
+        if (valid)
+        {
+            cached.insert(
+                QString(text + line.textOffset, line.textSize), words
+            );
+        }
+    }
+    file.unmap((uchar *)data);
+    if (!valid)
+    {
+        return false;
+    }
+
+    /* Mark the entry as recently used for eviction */
+    file.setFileTime(
+        QDateTime::currentDateTime(), QFileDevice::FileModificationTime
+    );
+
+    lines = std::move(cached);
+    return true;
+}
+
+QString EpisodeVocabulary::save(
+    const QString &key,
+    const QHash<QString, QList<Word>> &lines)
+{
+    std::vector<VocabularyCacheLine> cacheLines;
+    cacheLines.reserve(lines.size());
+    std::vector<VocabularyCacheWord> cacheWords;
+    QString text;
+
+    /* Expressions and readings repeat all through an episode */
+    QHash<QString, uint32_t> offsets;
+    const auto intern = [&offsets, &text] (const QString &str)
+    {
+        auto it = offsets.constFind(str);
+        if (it != offsets.cend())
+        {
+            return *it;
+        }
+        const uint32_t offset = text.size();
+        text += str;
+        offsets.insert(str, offset);
+        return offset;
+    };
+
+    constexpr int MAX_SIZE = std::numeric_limits<uint16_t>::max();
+    for (auto it = lines.cbegin(); it != lines.cend(); ++it)
+    {
+        VocabularyCacheLine line;
+        std::memset(&line, 0, sizeof(line));
+        line.textOffset = text.size();
+        line.textSize = it.key().size();
+        line.firstWord = cacheWords.size();
+        text += it.key();
+
+        for (const Word &word : it.value())
+        {
+            if (word.offset > MAX_SIZE || word.length > MAX_SIZE ||
+                word.expression.size() > MAX_SIZE ||
+                word.reading.size() > MAX_SIZE)
+            {
+                continue;
+            }
+
+            VocabularyCacheWord cacheWord;
+            std::memset(&cacheWord, 0, sizeof(cacheWord));
+            cacheWord.offset = word.offset;
+            cacheWord.length = word.length;
+            cacheWord.expressionSize = word.expression.size();
+            cacheWord.readingSize = word.reading.size();
+            cacheWord.expressionOffset = intern(word.expression);
+            cacheWord.readingOffset = intern(word.reading);
+            cacheWords.push_back(cacheWord);
+        }
+        line.wordCount = cacheWords.size() - line.firstWord;
+        cacheLines.push_back(line);
+    }
+
+    VocabularyCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, VOCABULARY_CACHE_MAGIC, sizeof(header.magic));
+    header.version   = VOCABULARY_CACHE_VERSION;
+    header.lineCount = cacheLines.size();
+    header.wordCount = cacheWords.size();
+    header.textSize  = text.size();
+
+    const QString path = entryPath(key);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return "Could not open " + path + ": " + file.errorString();
+    }
+    file.write((const char *)&header, sizeof(header));
+    file.write(
+        (const char *)cacheLines.data(),
+        cacheLines.size() * sizeof(VocabularyCacheLine)
+    );
+    file.write(
+        (const char *)cacheWords.data(),
+        cacheWords.size() * sizeof(VocabularyCacheWord)
+    );
+    file.write((const char *)text.constData(), text.size() * sizeof(QChar));
+    if (!file.commit())
+    {
+        return "Could not write " + path + ": " + file.errorString();
+    }
+
+    /* Entries are sorted newest first, so keep everything until the cache is
+     * full and remove the rest */
+    const QFileInfoList entries =
+        QDir(DirectoryUtils::getVocabularyCacheDir()).entryInfoList(
+            {"*" VOCABULARY_CACHE_SUFFIX}, QDir::Files, QDir::Time
+        );
+    qint64 total = 0;
+    for (const QFileInfo &entry : entries)
+    {
+        total += entry.size();
+        if (total > VOCABULARY_CACHE_MAX_SIZE)
+        {
+            QFile::remove(entry.filePath());
+        }
+    }
+
+    return "";
+}
+
+/* End On Disk Cache */
+
+#undef VOCABULARY_CACHE_MAGIC
+#undef VOCABULARY_CACHE_VERSION
+#undef VOCABULARY_CACHE_SUFFIX
+#undef VOCABULARY_CACHE_MAX_SIZE
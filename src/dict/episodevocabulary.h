@@ -0,0 +1,295 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef EPISODEVOCABULARY_H
+#define EPISODEVOCABULARY_H
+
+#include <QObject>
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+
+#include <cstdint>
+#include <memory>
+
+#include "cancellationtoken.h"
+
+class Dictionary;
+
+/* Begin On Disk Layout */
+
+/**
+ * The header at the start of every vocabulary cache file.
+ */
+struct VocabularyCacheHeader
+{
+    /* Always VOCABULARY_CACHE_MAGIC */
+    char magic[8];
+
+    /* The version of the layout */
+    uint32_t version;
+
+    /* The number of lines */
+    uint32_t lineCount;
+
+    /* The number of words across every line */
+    uint32_t wordCount;
+
+    /* Unused, keeps the text size aligned */
+    uint32_t reserved;
+
+    /* The size of the text table in UTF-16 code units */
+    uint64_t textSize;
+};
+
+/**
+ * A line in a vocabulary cache file.
+ */
+struct VocabularyCacheLine
+{
+    /* The offset of the text of the line in the text table */
+    uint32_t textOffset;
+
+    /* The length of the text of the line in UTF-16 code units */
+    uint32_t textSize;
+
+    /* The index of the first word of the line in the word table */
+    uint32_t firstWord;
+
+    /* The number of words in the line */
+    uint32_t wordCount;
+};
+
+/**
+ * A word in a vocabulary cache file. Expressions and readings are stored once
+ * in the text table no matter how many words share them.
+ */
+struct VocabularyCacheWord
+{
+    /* The position of the word in its line */
+    uint16_t offset;
+
+    /* The length of the word in its line */
+    uint16_t length;
+
+    /* The length of the expression in UTF-16 code units */
+    uint16_t expressionSize;
+
+    /* The length of the reading in UTF-16 code units */
+    uint16_t readingSize;
+
+    /* The offset of the expression in the text table */
+    uint32_t expressionOffset;
+
+    /* The offset of the reading in the text table */
+    uint32_t readingOffset;
+};
+
+/* End On Disk Layout */
+
+/**
+ * Looks up every line of an episode ahead of time. For every position in a
+ * line that starts a dictionary match, the longest match is kept along with
+ * its top ranked term. Results are saved to disk keyed by the lines and the
+ * dictionaries, so an episode is only looked up once.
+ */
+class EpisodeVocabulary : public QObject
+{
+    Q_OBJECT
+
+public:
+    /* The longest match starting at a position in a line */
+    struct Word
+    {
+        /* The position of the word in the line */
+        int offset = 0;
+
+        /* The length of the match in the line. 0 if nothing matches. */
+        int length = 0;
+
+        /* The expression of the top ranked term */
+        QString expression;
+
+        /* The reading of the top ranked term */
+        QString reading;
+    };
+
+    /**
+     * Constructs a vocabulary.
+     * @param dictionary The dictionary to search. Must outlive the vocabulary.
+     * @param maxLength  The maximum length of text searched from a position.
+     * @param parent     The parent of this object.
+     */
+    EpisodeVocabulary(
+        Dictionary *dictionary,
+        qsizetype maxLength,
+        QObject *parent = nullptr);
+    virtual ~EpisodeVocabulary();
+
+    /**
+     * Returns if precomputing is enabled by the user.
+     * @return true if precomputing is enabled, false otherwise.
+     */
+    [[nodiscard]]
+    inline bool enabled() const
+    {
+        return m_settings.enabled;
+    }
+
+    /**
+     * Initializes the vocabulary settings. Clears the vocabulary if it was
+     * disabled.
+     */
+    void initSettings();
+
+    /**
+     * Starts looking up every line of an episode in the background. Loads the
+     * results from disk instead if they were computed before. Cancels any
+     * episode that is already running. Does nothing if precomputing is
+     * disabled or the lines are already loaded.
+     * @param lines The lines of the episode as they are shown to the user.
+     */
+    void precompute(const QStringList &lines);
+
+    /**
+     * Stops the current episode and clears all results.
+     */
+    void cancel();
+
+    /**
+     * Gets the word starting at a position in a line.
+     * @param      line  The line.
+     * @param      index The position in the line.
+     * @param[out] word  The word at the position. Its length is 0 if nothing
+     *                   in the dictionaries starts there.
+     * @return true if the line has been looked up, false otherwise.
+     */
+    bool lookup(const QString &line, int index, Word &word) const;
+
+    /**
+     * Gets every word in a line.
+     * @param      line  The line.
+     * @param[out] words The words in the line ordered by position.
+     * @return true if the line has been looked up, false otherwise.
+     */
+    bool words(const QString &line, QList<Word> &words) const;
+
+private:
+    /**
+     * Computes the cache key of a set of lines with the current dictionaries
+     * and search settings.
+     * @param lines The deduplicated lines.
+     * @return The key of the lines.
+     */
+    [[nodiscard]]
+    QString cacheKey(const QStringList &lines) const;
+
+    /**
+     * Looks up lines until every line has been looked up or the episode is
+     * cancelled. The last thread to finish saves the results to disk.
+     * @param token   Cancelled when this episode is superseded.
+     * @param key     The cache key of the episode.
+     * @param lines   The deduplicated lines.
+     * @param next    The index of the next line to look up. Shared by all
+     *                threads working on this episode.
+     * @param running The number of threads still working on this episode.
+     * @param failed  Set if a lookup failed, in which case nothing is saved.
+     */
+    void run(
+        CancellationToken token,
+        QString key,
+        QStringList lines,
+        std::shared_ptr<QAtomicInt> next,
+        std::shared_ptr<QAtomicInt> running,
+        std::shared_ptr<QAtomicInt> failed);
+
+    /**
+     * Looks up every position in a line.
+     * @param      line  The line.
+     * @param      token Aborts the lookup when cancelled.
+     * @param[out] words The longest match at every position that has one.
+     * @return true on success, false if a search failed or was cancelled.
+     */
+    bool lookupLine(
+        const QString &line,
+        const CancellationToken &token,
+        QList<Word> &words) const;
+
+    /**
+     * Loads the words of an episode from disk.
+     * @param      key   The cache key of the episode.
+     * @param[out] lines Maps lines to their words.
+     * @return true if the episode was cached, false otherwise.
+     */
+    static bool load(const QString &key, QHash<QString, QList<Word>> &lines);
+
+    /**
+     * Saves the words of an episode to disk, then evicts the least recently
+     * used entries if the cache is too big.
+     * @param key   The cache key of the episode.
+     * @param lines Maps lines to their words.
+     * @return Empty string on success, error string on error.
+     */
+    static QString save(
+        const QString &key,
+        const QHash<QString, QList<Word>> &lines);
+
+    /* The dictionary to search */
+    Dictionary *m_dictionary;
+
+    /* The maximum length of text searched from a position */
+    const qsizetype m_maxLength;
+
+    /* The low priority pool lines are looked up on */
+    QThreadPool m_pool;
+
+    /* Cancelled every time an episode is started or cancelled */
+    CancellationSource m_cancel;
+
+    /* Looked up lines */
+    struct Cache
+    {
+        /* The cache key of the episode the lines belong to */
+        QString key;
+
+        /* Maps lines to their words ordered by position */
+        QHash<QString, QList<Word>> lines;
+
+        /* Locks the cache */
+        mutable QMutex lock;
+    } m_cache;
+
+    /* Vocabulary settings */
+    struct Settings
+    {
+        /* true if precomputing is enabled, false otherwise */
+        bool enabled{false};
+
+        /* The number of threads lines are looked up on */
+        int threads{1};
+    } m_settings;
+};
+
+#endif // EPISODEVOCABULARY_H
@@ -73,6 +73,12 @@ struct Frequency
 
     /* Frequency of the expression/kanji/etc. */
     QString freq;
+
+    /* The id of the frequency dictionary. */
+    uint64_t dictionaryId = 0;
+
+    /* The priority of the frequency dictionary. Lower values come first. */
+    int priority = 0;
 };
 
 /**
@@ -111,34 +117,55 @@ struct TermDefinition
      *  Used for ordering. More common entries have a larger score.
      */
     int score;
+
+    /* The id of the dictionary this entry comes from. */
+    uint64_t dictionaryId = 0;
+
+    /* The priority of the dictionary this entry comes from.
+     * Lower values come first.
+     */
+    int priority = 0;
 };
 
 /**
- * A parent struct of Term and Kanji that contains fields common between the
- * two.
+ * The text a lookup was run on. Every term and kanji found by the same lookup
+ * shares one context, so the text is stored once per lookup instead of once
+ * per result. Immutable once constructed.
  */
-struct CommonExpFields
+struct LookupContext
+{
+    /* The complete sentence the lookup was run on. */
+    QString sentence;
+};
+
+using SharedLookupContext = QSharedPointer<const LookupContext>;
+
+/**
+ * The state of the player when a note is added to Anki. Only built for the
+ * copy of a term or kanji that is handed to Anki.
+ */
+struct NoteContext
 {
     /* The title of the expression this came from. */
     QString title;
 
-    /* The complete sentence this term was found in. */
+    /* The complete subtitle the term was found in. */
     QString sentence;
 
     /* The start time of the subtitle */
-    double startTime;
+    double startTime = 0;
 
     /* The end time of the subtitle */
-    double endTime;
+    double endTime = 0;
 
     /* The current secondary subtitle */
     QString sentence2;
 
     /* The start time of the selected context */
-    double startTimeContext;
+    double startTimeContext = 0;
 
     /* The end time of the selected context */
-    double endTimeContext;
+    double endTimeContext = 0;
 
     /* The currently selected context */
     QString context;
@@ -148,18 +175,63 @@ struct CommonExpFields
 
     /* The current text in the user's clipboard */
     QString clipboard;
+};
 
-    /* The raw term as it was matched by Memento. */
-    QString clozeBody;
+using SharedNoteContext = QSharedPointer<const NoteContext>;
 
-    /* Everything in the sentence before the cloze body */
-    QString clozePrefix;
+/**
+ * A parent struct of Term and Kanji that contains fields common between the
+ * two.
+ */
+struct CommonExpFields
+{
+    /* The lookup this was found by. nullptr if it was not found in text. */
+    SharedLookupContext lookup;
+
+    /* The index into the lookup sentence where the match begins */
+    qsizetype matchOffset = 0;
+
+    /* The length of the text matched in the lookup sentence */
+    qsizetype matchLength = 0;
 
-    /* Everything in the sentence after the cloze body */
-    QString clozeSuffix;
+    /* The state of the player when this was added to Anki. nullptr until a
+     * note is built. */
+    SharedNoteContext note;
 
     /* A list of frequencies */
     QList<Frequency> frequencies;
+
+    /**
+     * Gets the raw text as it was matched by Memento.
+     * @return The matched text, empty if there is no lookup context.
+     */
+    [[nodiscard]]
+    inline QString clozeBody() const
+    {
+        return lookup ?
+            lookup->sentence.mid(matchOffset, matchLength) : QString();
+    }
+
+    /**
+     * Gets everything in the lookup sentence before the cloze body.
+     * @return The text before the match, empty if there is no lookup context.
+     */
+    [[nodiscard]]
+    inline QString clozePrefix() const
+    {
+        return lookup ? lookup->sentence.left(matchOffset) : QString();
+    }
+
+    /**
+     * Gets everything in the lookup sentence after the cloze body.
+     * @return The text after the match, empty if there is no lookup context.
+     */
+    [[nodiscard]]
+    inline QString clozeSuffix() const
+    {
+        return lookup ?
+            lookup->sentence.mid(matchOffset + matchLength) : QString();
+    }
 };
 
 /**
@@ -193,6 +265,11 @@ struct Term : public CommonExpFields
      */
     int score = 0;
 
+    /* true if the definitions, tags, frequencies, and pitches of this term
+     * have been loaded, false if only the fields used for ranking are set.
+     */
+    bool loaded = false;
+
     /* The name of the audio source */
     QString audioSrcName;
 
@@ -247,6 +324,14 @@ struct KanjiDefinition
      * The string is the corresponding value.
      */
     QList<QPair<Tag, QString>> index;
+
+    /* The id of the dictionary the definition comes from. */
+    uint64_t dictionaryId = 0;
+
+    /* The priority of the dictionary the definition comes from.
+     * Lower values come first.
+     */
+    int priority = 0;
 };
 
 /**
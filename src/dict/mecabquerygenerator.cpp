@@ -20,7 +20,11 @@
 
 #include "mecabquerygenerator.h"
 
+#include <algorithm>
+
 #include <QDebug>
+#include <QPair>
+#include <QSet>
 #include <QtGlobal>
 
 #include "util/utils.h"
@@ -87,7 +91,9 @@ static QByteArray genMecabArg()
 /* End Static Helpers */
 /* Begin Constructor */
 
-MeCabQueryGenerator::MeCabQueryGenerator()
+MeCabQueryGenerator::MeCabQueryGenerator(int maxCandidates, int maxPathLength)
+    : m_maxCandidates(std::max(maxCandidates, 1)),
+      m_maxPathLength(std::max(maxPathLength, 1))
 {
 #if defined(Q_OS_WIN)
     QByteArray mecabArg = genMecabArg();
@@ -117,64 +123,260 @@ std::vector<SearchQuery> MeCabQueryGenerator::generateQueries(
         return {};
     }
 
-    std::unique_ptr<MeCab::Lattice> lattice(MeCab::createLattice());
     QByteArray textArr = text.toUtf8();
-    lattice->set_sentence(textArr);
-    if (!m_tagger->parse(lattice.get()))
+    std::unique_ptr<MeCab::Lattice> lattice = parse(textArr);
+    if (lattice == nullptr)
     {
-        qDebug() << "Cannot access MeCab";
-        qDebug() << MeCab::getLastError();
         return {};
     }
-    std::vector<MeCabQuery> mecabQueries =
-        generateQueriesHelper(lattice->bos_node()->next);
 
-    std::vector<SearchQuery> queries;
-    queries.reserve(mecabQueries.size());
-    std::copy(
-        std::begin(mecabQueries), std::end(mecabQueries),
-        std::back_inserter(queries)
-    );
+    PathCache cache;
+    std::vector<qsizetype> paths =
+        enumeratePaths(lattice->bos_node()->next, cache);
+    return buildQueries(paths, -1, cache);
+}
+
+std::vector<std::vector<SearchQuery>> MeCabQueryGenerator::generateLineQueries(
+    const QString &text,
+    qsizetype maxLength) const
+{
+    std::vector<std::vector<SearchQuery>> queries(text.size());
+    if (!valid() || text.isEmpty())
+    {
+        return queries;
+    }
+
+    QByteArray textArr = text.toUtf8();
+    std::unique_ptr<MeCab::Lattice> lattice = parse(textArr);
+    if (lattice == nullptr)
+    {
+        return queries;
+    }
+
+    /* Nodes that start inside of a best path node rejoin the best path at the
+     * first position they share with it */
+    PathCache cache;
+    cache.sentence = lattice->sentence();
+    for (const MeCab::Node *node = lattice->bos_node()->next;
+         node && node->stat != MECAB_EOS_NODE;
+         node = node->next)
+    {
+        const qsizetype begin =
+            (node->surface - cache.sentence) - (node->rlength - node->length);
+        cache.bestAt.insert(begin, node);
+    }
+
+    /* Map every UTF-16 position to the byte offset MeCab uses */
+    qsizetype byteOffset = 0;
+    for (qsizetype i = 0; i < text.size(); ++i)
+    {
+        const char16_t ch = text[i].unicode();
+        if (QChar::isLowSurrogate(ch))
+        {
+            byteOffset += 2;
+            continue;
+        }
+
+        if (!text[i].isSpace() &&
+            byteOffset < static_cast<qsizetype>(lattice->size()))
+        {
+            /* MeCab only looks up nodes where another node ends. Positions
+             * inside of a node are parsed on their own like they would be
+             * when hovered. */
+            const MeCab::Node *node = lattice->begin_nodes(byteOffset);
+            if (node)
+            {
+                std::vector<qsizetype> paths = enumeratePaths(node, cache);
+                queries[i] = buildQueries(paths, maxLength, cache);
+            }
+            else
+            {
+                queries[i] = generateQueries(text.mid(i, maxLength));
+            }
+        }
+
+        if (ch < 0x80)
+        {
+            byteOffset += 1;
+        }
+        else if (ch < 0x800)
+        {
+            byteOffset += 2;
+        }
+        else if (QChar::isHighSurrogate(ch))
+        {
+            byteOffset += 2;
+        }
+        else
+        {
+            byteOffset += 3;
+        }
+    }
+
     return queries;
 }
 
-std::vector<MeCabQueryGenerator::MeCabQuery>
-MeCabQueryGenerator::generateQueriesHelper(const MeCab::Node *node)
+std::unique_ptr<MeCab::Lattice> MeCabQueryGenerator::parse(
+    const QByteArray &text) const
+{
+    std::unique_ptr<MeCab::Lattice> lattice(MeCab::createLattice());
+    lattice->set_sentence(text);
+    if (!m_tagger->parse(lattice.get()))
+    {
+        qDebug() << "Cannot access MeCab";
+        qDebug() << MeCab::getLastError();
+        return nullptr;
+    }
+    return lattice;
+}
+
+std::vector<qsizetype> MeCabQueryGenerator::enumeratePaths(
+    const MeCab::Node *node,
+    PathCache &cache) const
 {
-    std::vector<MeCabQuery> queries;
-    while (node)
+    if (node == nullptr)
+    {
+        return {};
+    }
+
+    /* Positions are expanded only after every position after them is done.
+     * The bool marks if the children of a position have been pushed yet. */
+    std::vector<QPair<const MeCab::Node *, bool>> stack{{node, false}};
+    while (!stack.empty())
     {
-        QString deconj = extractDeconjugation(node);
-        QString surface = extractSurface(node);
-        QString surfaceClean = extractCleanSurface(node);
-        if (deconj != "*")
+        auto [head, childrenPushed] = stack.back();
+        stack.pop_back();
+        if (cache.paths.contains(head))
         {
-            MeCabQuery query;
-            query.deconj = deconj;
-            query.surface = surface;
-            query.surfaceClean = surfaceClean;
-            query.source = SearchQuery::Source::mecab;
-            queries.emplace_back(std::move(query));
+            continue;
         }
 
-        if (node->next)
+        if (!childrenPushed)
         {
-            std::vector<MeCabQuery> subQueries =
-                generateQueriesHelper(node->next);
-            for (MeCabQuery &p : subQueries)
+            stack.push_back({head, true});
+            for (const MeCab::Node *n = head; n; n = n->bnext)
             {
-                p.deconj.prepend(surfaceClean);
-                p.surface.prepend(surface);
-                p.surfaceClean.prepend(surfaceClean);
-                queries.emplace_back(std::move(p));
+                const MeCab::Node *next = successor(n, cache);
+                if (next && !cache.paths.contains(next))
+                {
+                    stack.push_back({next, false});
+                }
             }
+            continue;
         }
 
-        node = node->bnext;
+        std::vector<qsizetype> paths;
+        for (const MeCab::Node *n = head;
+             n && paths.size() < static_cast<size_t>(m_maxCandidates);
+             n = n->bnext)
+        {
+            if (nodeText(n, cache.text).deconj != "*")
+            {
+                paths.emplace_back(cache.entries.size());
+                cache.entries.emplace_back(PathEntry{n, -1, 1});
+            }
+
+            const MeCab::Node *next = successor(n, cache);
+            auto tails = next ? cache.paths.constFind(next) : cache.paths.cend();
+            if (tails == cache.paths.cend())
+            {
+                continue;
+            }
+            for (qsizetype tail : *tails)
+            {
+                if (paths.size() >= static_cast<size_t>(m_maxCandidates))
+                {
+                    break;
+                }
+                const int length = cache.entries[tail].length + 1;
+                if (length > m_maxPathLength)
+                {
+                    continue;
+                }
+                paths.emplace_back(cache.entries.size());
+                cache.entries.emplace_back(PathEntry{n, tail, length});
+            }
+        }
+        cache.paths.insert(head, std::move(paths));
+    }
+
+    return cache.paths.value(node);
+}
+
+const MeCab::Node *MeCabQueryGenerator::successor(
+    const MeCab::Node *node,
+    const PathCache &cache)
+{
+    if (node->next || cache.sentence == nullptr)
+    {
+        return node->next;
+    }
+    if (node->stat == MECAB_BOS_NODE || node->stat == MECAB_EOS_NODE)
+    {
+        return nullptr;
+    }
+    const qsizetype end = (node->surface - cache.sentence) + node->length;
+    return cache.bestAt.value(end, nullptr);
+}
+
+SearchQuery MeCabQueryGenerator::buildQuery(qsizetype index, PathCache &cache)
+{
+    SearchQuery query;
+    query.source = SearchQuery::Source::mecab;
+    for (qsizetype i = index; i != -1; i = cache.entries[i].next)
+    {
+        const NodeText nt = nodeText(cache.entries[i].node, cache.text);
+        query.surface += nt.surface;
+        query.deconj +=
+            cache.entries[i].next == -1 ? nt.deconj : nt.surfaceClean;
+    }
+    return query;
+}
+
+std::vector<SearchQuery> MeCabQueryGenerator::buildQueries(
+    const std::vector<qsizetype> &paths,
+    qsizetype maxLength,
+    PathCache &cache)
+{
+    std::vector<SearchQuery> queries;
+    queries.reserve(paths.size());
+    QSet<QPair<QString, QString>> seen;
+    for (qsizetype index : paths)
+    {
+        SearchQuery query = buildQuery(index, cache);
+        if (maxLength >= 0 && query.surface.size() > maxLength)
+        {
+            continue;
+        }
+        QPair<QString, QString> key{query.deconj, query.surface};
+        if (seen.contains(key))
+        {
+            continue;
+        }
+        seen.insert(std::move(key));
+        queries.emplace_back(std::move(query));
     }
     return queries;
 }
 
+MeCabQueryGenerator::NodeText MeCabQueryGenerator::nodeText(
+    const MeCab::Node *node,
+    QHash<const MeCab::Node *, NodeText> &text)
+{
+    auto it = text.constFind(node);
+    if (it != text.cend())
+    {
+        return *it;
+    }
+    NodeText nt{
+        extractDeconjugation(node),
+        extractSurface(node),
+        extractCleanSurface(node)
+    };
+    text.insert(node, nt);
+    return nt;
+}
+
 inline QString MeCabQueryGenerator::extractDeconjugation(
     const MeCab::Node *node)
 {
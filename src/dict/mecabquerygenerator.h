@@ -24,6 +24,9 @@
 #include "querygenerator.h"
 
 #include <memory>
+#include <vector>
+
+#include <QHash>
 
 #include <mecab.h>
 
@@ -33,7 +36,14 @@
 class MeCabQueryGenerator final : public QueryGenerator
 {
 public:
-    MeCabQueryGenerator();
+    /**
+     * Constructs a MeCab query generator.
+     * @param maxCandidates The maximum number of queries generated from a
+     *                      single string of text.
+     * @param maxPathLength The maximum number of MeCab nodes joined together
+     *                      into a single query.
+     */
+    MeCabQueryGenerator(int maxCandidates, int maxPathLength);
     virtual ~MeCabQueryGenerator() = default;
 
     /**
@@ -56,26 +66,142 @@ public:
     std::vector<SearchQuery> generateQueries(
         const QString &text) const override;
 
+    /**
+     * Generates queries for every position in a line of text from a single
+     * MeCab parse of the whole line. Positions where no lattice node begins
+     * are parsed separately.
+     * @param text      The line of text to generate queries from.
+     * @param maxLength The maximum length of a query's surface string.
+     * @return The queries for every position in the text.
+     */
+    [[nodiscard]]
+    std::vector<std::vector<SearchQuery>> generateLineQueries(
+        const QString &text,
+        qsizetype maxLength) const override;
+
 private:
     /**
-     * A special SearchPair that contains additional information needed by
-     * MeCab.
+     * A node in a path through the lattice. Paths are stored as singly linked
+     * lists so paths that share a suffix also share storage.
+     */
+    struct PathEntry
+    {
+        /* The MeCab node at this point in the path */
+        const MeCab::Node *node;
+
+        /* Index of the next entry in the path, -1 if this is the last node */
+        qsizetype next;
+
+        /* The number of nodes in the path starting from this entry */
+        int length;
+    };
+
+    /**
+     * The strings extracted from a single MeCab node.
      */
-    struct MeCabQuery : public SearchQuery
+    struct NodeText
     {
+        /* The deconjugated word, * if there is none */
+        QString deconj;
+
+        /* The surface string including whitespace */
+        QString surface;
+
         /* The surface string without whitespace */
         QString surfaceClean;
     };
 
     /**
-     * Recursively generates queries and surface strings from a node.
-     * @param node The node to start at. Usually the next node after the BOS
-     *             node. Is nullptr safe.
-     * @return A list of conjugated string and surface (raw) strings.
+     * Everything that is shared between path enumerations over one lattice.
+     */
+    struct PathCache
+    {
+        /* The storage for all path entries */
+        std::vector<PathEntry> entries;
+
+        /* Strings extracted from nodes */
+        QHash<const MeCab::Node *, NodeText> text;
+
+        /* Maps the first node at a lattice position to the paths starting
+         * there */
+        QHash<const MeCab::Node *, std::vector<qsizetype>> paths;
+
+        /* The sentence the lattice was built from. Only set when best path
+         * nodes can be reached from nodes outside of the best path. */
+        const char *sentence{nullptr};
+
+        /* Maps byte offsets in sentence to the best path node starting there */
+        QHash<qsizetype, const MeCab::Node *> bestAt;
+    };
+
+    /**
+     * Enumerates all paths through the lattice beginning at a node without
+     * recursion. Paths are memoized per lattice position so every position is
+     * only expanded once.
+     * @param      node  The node to start at. Usually the next node after the
+     *                   BOS node. Is nullptr safe.
+     * @param[out] cache The cache to store paths in.
+     * @return Indices into cache.entries of the paths that start at node, in
+     *         the order they should be turned into queries.
+     */
+    [[nodiscard]]
+    std::vector<qsizetype> enumeratePaths(
+        const MeCab::Node *node,
+        PathCache &cache) const;
+
+    /**
+     * Gets the first node at the lattice position a path continues to after a
+     * node.
+     * @param node  The node to get the successor of.
+     * @param cache The cache containing the best path.
+     * @return The node the path continues to, nullptr if the path ends.
+     */
+    [[nodiscard]]
+    static const MeCab::Node *successor(
+        const MeCab::Node *node,
+        const PathCache &cache);
+
+    /**
+     * Builds the query described by a path through the lattice.
+     * @param      index The index of the first entry in the path.
+     * @param[out] cache The cache containing the path.
+     * @return The query for the path.
      */
     [[nodiscard]]
-    static std::vector<MeCabQuery> generateQueriesHelper(
-        const MeCab::Node *node);
+    static SearchQuery buildQuery(qsizetype index, PathCache &cache);
+
+    /**
+     * Turns paths into queries, dropping duplicates.
+     * @param      paths     The indices of the paths to turn into queries.
+     * @param      maxLength The maximum length of a query's surface string.
+     *                       Negative values mean no limit.
+     * @param[out] cache     The cache containing the paths.
+     * @return The list of queries.
+     */
+    [[nodiscard]]
+    static std::vector<SearchQuery> buildQueries(
+        const std::vector<qsizetype> &paths,
+        qsizetype maxLength,
+        PathCache &cache);
+
+    /**
+     * Gets the strings for a node, extracting them if they are not cached.
+     * @param      node The node to get the text of.
+     * @param[out] text Cache of strings extracted from nodes.
+     * @return The strings belonging to the node.
+     */
+    [[nodiscard]]
+    static NodeText nodeText(
+        const MeCab::Node *node,
+        QHash<const MeCab::Node *, NodeText> &text);
+
+    /**
+     * Parses text with MeCab.
+     * @param text The text to parse.
+     * @return The parsed lattice, nullptr on error.
+     */
+    [[nodiscard]]
+    std::unique_ptr<MeCab::Lattice> parse(const QByteArray &text) const;
 
     /**
      * Gets the deconjugated word from a MeCab node.
@@ -103,6 +229,12 @@ private:
 
     /* The object used for interacting with MeCab */
     std::unique_ptr<MeCab::Tagger> m_tagger{nullptr};
+
+    /* The maximum number of queries generated from a single string */
+    const int m_maxCandidates;
+
+    /* The maximum number of nodes joined together into a single query */
+    const int m_maxPathLength;
 };
 
 #endif // MECABQUERYGENERATOR_H
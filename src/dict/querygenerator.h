@@ -61,6 +61,32 @@ public:
     [[nodiscard]]
     virtual std::vector<SearchQuery> generateQueries(
         const QString &text) const = 0;
+
+    /**
+     * Generates queries for every position in a line of text. The queries at
+     * index i of the result are the queries for the text starting at i.
+     * Positions that cannot start a query such as whitespace are left empty.
+     * The default implementation calls generateQueries() for every position.
+     * @param text      The line of text to generate queries from.
+     * @param maxLength The maximum length of text considered from a position.
+     * @return The queries for every position in the text.
+     */
+    [[nodiscard]]
+    virtual std::vector<std::vector<SearchQuery>> generateLineQueries(
+        const QString &text,
+        qsizetype maxLength) const
+    {
+        std::vector<std::vector<SearchQuery>> queries(text.size());
+        for (qsizetype i = 0; i < text.size(); ++i)
+        {
+            if (text[i].isSpace() || text[i].isLowSurrogate())
+            {
+                continue;
+            }
+            queries[i] = generateQueries(text.mid(i, maxLength));
+        }
+        return queries;
+    }
 };
 
 #endif // QUERYGENERATOR_H
@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TERMBACKEND_H
+#define TERMBACKEND_H
+
+#include <QList>
+#include <QSet>
+#include <QString>
+
+#include "cancellationtoken.h"
+#include "expression.h"
+
+/**
+ * Interface for a read backend that finds the terms matching a query. Lets the
+ * dictionary switch between reading from SQLite and from a compiled pack.
+ */
+class TermBackend
+{
+public:
+    virtual ~TermBackend() = default;
+
+    /**
+     * Searches for terms that exactly match the query. Does automatic
+     * conversion from katakana to hiragana. Only the fields needed to rank
+     * terms are set (expression, reading, and score).
+     * @param      query      The term to query for.
+     * @param      ruleFilter If not empty, only terms with at least one
+     *                        definition matching one of these rules are
+     *                        returned.
+     * @param[out] terms      A list of matching terms. Belongs to the caller.
+     * @param      token      Cancels the query.
+     * @return Empty string on success, error string on error. Cancelled
+     *         queries return an error string and leave terms untouched.
+     */
+    virtual QString queryTerms(
+        const QString &query,
+        const QSet<QString> &ruleFilter,
+        QList<SharedTerm> &terms,
+        const CancellationToken &token = CancellationToken()) const = 0;
+};
+
+#endif // TERMBACKEND_H
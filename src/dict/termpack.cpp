@@ -0,0 +1,403 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "termpack.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "util/textnormalizer.h"
+
+#define TERM_PACK_MAGIC     "MMTPACK1"
+#define TERM_PACK_VERSION   1
+
+static_assert(std::is_trivially_copyable_v<TermPackHeader>);
+static_assert(std::is_trivially_copyable_v<TermPackEntry>);
+static_assert(std::is_trivially_copyable_v<TermPackKey>);
+static_assert(sizeof(TermPackString) == 8);
+static_assert(sizeof(TermPackEntry) == 32);
+static_assert(sizeof(TermPackKey) == 12);
+static_assert(sizeof(TermPackHeader) == 72);
+static_assert(sizeof(TERM_PACK_MAGIC) - 1 == sizeof(TermPackHeader::magic));
+
+/* Begin Helpers */
+
+/**
+ * Compares two byte strings. Shorter strings sort before longer strings that
+ * they are a prefix of.
+ * @param lhs     The left string.
+ * @param lhsSize The size of the left string.
+ * @param rhs     The right string.
+ * @param rhsSize The size of the right string.
+ * @return Less than zero if lhs < rhs, zero if they are equal, greater than
+ *         zero if lhs > rhs.
+ */
+static inline int compareBytes(
+    const char *lhs,
+    size_t lhsSize,
+    const char *rhs,
+    size_t rhsSize)
+{
+    int cmp = std::memcmp(lhs, rhs, std::min(lhsSize, rhsSize));
+    if (cmp != 0)
+    {
+        return cmp;
+    }
+    return lhsSize < rhsSize ? -1 : (lhsSize > rhsSize ? 1 : 0);
+}
+
+/**
+ * Returns the stamp of a database used to tell if a pack is out of date.
+ * @param      source   The path to the database.
+ * @param[out] size     The size of the database.
+ * @param[out] modified The modification time of the database.
+ */
+static void sourceStamp(const QString &source, int64_t &size, int64_t &modified)
+{
+    QFileInfo info(source);
+    size = info.size();
+    modified = info.lastModified().toMSecsSinceEpoch();
+}
+
+/* End Helpers */
+
+/* Begin TermPack */
+
+TermPack::TermPack(const QString &path) : m_file(path)
+{
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    const qint64 size = m_file.size();
+    if (size < (qint64)sizeof(TermPackHeader))
+    {
+        return;
+    }
+    const uchar *data = m_file.map(0, size);
+    if (data == nullptr)
+    {
+        return;
+    }
+
+    /* Validate the tables against the size of the file once so searches only
+     * have to check the bounds of strings */
+    const TermPackHeader *header = (const TermPackHeader *)data;
+    const uint64_t fileSize = size;
+    if (std::memcmp(
+            header->magic, TERM_PACK_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != TERM_PACK_VERSION ||
+        header->entriesOffset % alignof(TermPackEntry) != 0 ||
+        header->keysOffset % alignof(TermPackKey) != 0 ||
+        header->entriesOffset > fileSize ||
+        header->keysOffset > fileSize ||
+        header->stringsOffset > fileSize ||
+        (fileSize - header->entriesOffset) / sizeof(TermPackEntry) <
+            header->entryCount ||
+        (fileSize - header->keysOffset) / sizeof(TermPackKey) <
+            header->keyCount ||
+        fileSize - header->stringsOffset < header->stringsSize)
+    {
+        m_file.unmap((uchar *)data);
+        return;
+    }
+
+    m_header  = header;
+    m_entries = (const TermPackEntry *)(data + header->entriesOffset);
+    m_keys    = (const TermPackKey *)(data + header->keysOffset);
+    m_strings = (const char *)(data + header->stringsOffset);
+}
+
+TermPack::~TermPack()
+{
+    if (m_header)
+    {
+        m_file.unmap((uchar *)m_header);
+    }
+}
+
+bool TermPack::isCurrent(const QString &source) const
+{
+    if (!isValid())
+    {
+        return false;
+    }
+    int64_t size = 0;
+    int64_t modified = 0;
+    sourceStamp(source, size, modified);
+    return m_header->sourceSize == size &&
+        m_header->sourceModified == modified;
+}
+
+const char *TermPack::string(const TermPackString &str) const
+{
+    /* Every string has a null terminator after it */
+    if ((uint64_t)str.offset + str.size >= m_header->stringsSize)
+    {
+        return nullptr;
+    }
+    return m_strings + str.offset;
+}
+
+void TermPack::findEntries(
+    const QByteArray &key,
+    std::vector<uint32_t> &entries) const
+{
+    auto compare = [this] (const TermPackKey &lhs, const QByteArray &rhs)
+    {
+        const char *str = string(lhs.key);
+        return compareBytes(
+            str ? str : "", str ? lhs.key.size : 0, rhs.data(), rhs.size()
+        );
+    };
+
+    const TermPackKey *begin = m_keys;
+    const TermPackKey *end = m_keys + m_header->keyCount;
+    const TermPackKey *it = std::lower_bound(
+        begin, end, key,
+        [&] (const TermPackKey &lhs, const QByteArray &rhs)
+        {
+            return compare(lhs, rhs) < 0;
+        }
+    );
+    for (; it != end && compare(*it, key) == 0; ++it)
+    {
+        if (it->entry < m_header->entryCount)
+        {
+            entries.push_back(it->entry);
+        }
+    }
+}
+
+QString TermPack::queryTerms(
+    const QString &query,
+    const QSet<QString> &ruleFilter,
+    QList<SharedTerm> &terms,
+    const CancellationToken &token) const
+{
+    if (!isValid())
+    {
+        return "Dictionary pack is invalid";
+    }
+
+    TextNormalizer::Variants variants;
+    TextNormalizer::normalize(query, variants);
+
+    /* Search for every variant the database query would have bound */
+    std::vector<uint32_t> entries;
+    findEntries(variants.exact, entries);
+    if (variants.containsKatakana)
+    {
+        findEntries(variants.hiragana, entries);
+    }
+    if (variants.containsHalfWidth)
+    {
+        findEntries(variants.katakana, entries);
+    }
+
+    /* Variants can find the same entry through its expression and its
+     * reading, so remove duplicates like GROUP BY would */
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+    QSet<QByteArray> rules;
+    for (const QString &rule : ruleFilter)
+    {
+        rules << rule.toUtf8();
+    }
+
+    QList<SharedTerm> termList;
+    for (uint32_t index : entries)
+    {
+        if (token.isCancelled())
+        {
+            return "Query cancelled";
+        }
+
+        const TermPackEntry &entry = m_entries[index];
+        const char *expression = string(entry.expression);
+        const char *reading = string(entry.reading);
+        if (expression == nullptr || reading == nullptr)
+        {
+            return "Dictionary pack is corrupt";
+        }
+
+        if (!rules.isEmpty())
+        {
+            const char *entryRules = string(entry.rules);
+            if (entryRules == nullptr)
+            {
+                return "Dictionary pack is corrupt";
+            }
+
+            bool matches = false;
+            const char *end = entryRules + entry.rules.size;
+            for (const char *word = entryRules; word < end && !matches; )
+            {
+                const char *space = (const char *)std::memchr(
+                    word, ' ', end - word
+                );
+                if (space == nullptr)
+                {
+                    space = end;
+                }
+                matches = space != word &&
+                    rules.contains(
+                        QByteArray::fromRawData(word, space - word)
+                    );
+                word = space + 1;
+            }
+            if (!matches)
+            {
+                continue;
+            }
+        }
+
+        /* One allocation for the term and its reference count */
+        SharedTerm term = SharedTerm::create();
+        term->expression = QString::fromUtf8(expression, entry.expression.size);
+        term->reading    = QString::fromUtf8(reading, entry.reading.size);
+        term->score      = entry.score;
+        termList.append(term);
+    }
+
+    terms.append(termList);
+
+    return "";
+}
+
+/* End TermPack */
+
+/* Begin TermPackWriter */
+
+TermPackString TermPackWriter::addString(const char *str)
+{
+    if (str == NULL)
+    {
+        str = "";
+    }
+
+    /* Expressions, readings, and rules repeat a lot, so only store each
+     * string once */
+    const QByteArray bytes = QByteArray::fromRawData(str, std::strlen(str));
+    auto it = m_stringIds.constFind(bytes);
+    if (it != m_stringIds.constEnd())
+    {
+        return *it;
+    }
+
+    TermPackString loc;
+    loc.offset = m_strings.size();
+    loc.size = bytes.size();
+    m_strings.append(bytes);
+    m_strings.append('\0');
+
+    /* The key must own its bytes since str is only valid during the call */
+    m_stringIds.insert(QByteArray(bytes.constData(), bytes.size()), loc);
+
+    return loc;
+}
+
+void TermPackWriter::addTerm(
+    const char *expression,
+    const char *reading,
+    int score,
+    const char *rules)
+{
+    TermPackEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.expression = addString(expression);
+    entry.reading    = addString(reading);
+    entry.rules      = addString(rules);
+    entry.score      = score;
+
+    const uint32_t index = m_entries.size();
+    m_entries.push_back(entry);
+
+    TermPackKey key;
+    key.key = entry.expression;
+    key.entry = index;
+    m_keys.push_back(key);
+
+    if (entry.reading.size != 0 &&
+        entry.reading.offset != entry.expression.offset)
+    {
+        key.key = entry.reading;
+        m_keys.push_back(key);
+    }
+}
+
+QString TermPackWriter::save(const QString &path, const QString &source)
+{
+    /* Sort the keys so they can be binary searched */
+    const char *strings = m_strings.constData();
+    std::stable_sort(m_keys.begin(), m_keys.end(),
+        [strings] (const TermPackKey &lhs, const TermPackKey &rhs)
+        {
+            return compareBytes(
+                strings + lhs.key.offset, lhs.key.size,
+                strings + rhs.key.offset, rhs.key.size
+            ) < 0;
+        }
+    );
+
+    TermPackHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TERM_PACK_MAGIC, sizeof(header.magic));
+    header.version       = TERM_PACK_VERSION;
+    header.entryCount    = m_entries.size();
+    header.keyCount      = m_keys.size();
+    sourceStamp(source, header.sourceSize, header.sourceModified);
+    header.entriesOffset = sizeof(header);
+    header.keysOffset    =
+        header.entriesOffset + m_entries.size() * sizeof(TermPackEntry);
+    header.stringsOffset =
+        header.keysOffset + m_keys.size() * sizeof(TermPackKey);
+    header.stringsSize   = m_strings.size();
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return "Could not open " + path + ": " + file.errorString();
+    }
+    file.write((const char *)&header, sizeof(header));
+    file.write(
+        (const char *)m_entries.data(),
+        m_entries.size() * sizeof(TermPackEntry)
+    );
+    file.write(
+        (const char *)m_keys.data(), m_keys.size() * sizeof(TermPackKey)
+    );
+    file.write(m_strings);
+    if (!file.commit())
+    {
+        return "Could not write " + path + ": " + file.errorString();
+    }
+
+    return "";
+}
+
+/* End TermPackWriter */
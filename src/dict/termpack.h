@@ -0,0 +1,249 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TERMPACK_H
+#define TERMPACK_H
+
+#include "termbackend.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+
+#include <cstdint>
+#include <vector>
+
+/* Begin On Disk Layout */
+
+/**
+ * A string in the string table of a pack. Strings are UTF-8 and followed by a
+ * null terminator that is not counted in size.
+ */
+struct TermPackString
+{
+    /* The offset of the string from the start of the string table */
+    uint32_t offset;
+
+    /* The size of the string in bytes */
+    uint32_t size;
+};
+
+/**
+ * Everything needed to rank one expression/reading pair, summed over every
+ * enabled dictionary.
+ */
+struct TermPackEntry
+{
+    /* The expression of the term */
+    TermPackString expression;
+
+    /* The reading of the term */
+    TermPackString reading;
+
+    /* The space separated rules of every definition of the term */
+    TermPackString rules;
+
+    /* The sum of the scores of every definition of the term */
+    int32_t score;
+
+    /* Padding, always zero */
+    uint32_t reserved;
+};
+
+/**
+ * Maps an expression or reading to an entry. Keys are sorted by their bytes so
+ * they can be binary searched.
+ */
+struct TermPackKey
+{
+    /* The expression or reading */
+    TermPackString key;
+
+    /* The index of the entry the key belongs to */
+    uint32_t entry;
+};
+
+/**
+ * The header at the start of every pack.
+ */
+struct TermPackHeader
+{
+    /* Always TERM_PACK_MAGIC */
+    char magic[8];
+
+    /* The version of the layout */
+    uint32_t version;
+
+    /* The number of entries */
+    uint32_t entryCount;
+
+    /* The number of keys */
+    uint32_t keyCount;
+
+    /* Padding, always zero */
+    uint32_t reserved;
+
+    /* The size of the database the pack was compiled from */
+    int64_t sourceSize;
+
+    /* The modification time of the database in milliseconds since epoch */
+    int64_t sourceModified;
+
+    /* The offset of the entry table from the start of the file */
+    uint64_t entriesOffset;
+
+    /* The offset of the key table from the start of the file */
+    uint64_t keysOffset;
+
+    /* The offset of the string table from the start of the file */
+    uint64_t stringsOffset;
+
+    /* The size of the string table in bytes */
+    uint64_t stringsSize;
+};
+
+/* End On Disk Layout */
+
+/**
+ * A read-only, memory-mapped term index compiled from the dictionary
+ * database. Finding terms is a binary search over mapped pages with no SQL
+ * and no parsing, and every instance of Memento shares the same pages. The
+ * database stays the source of truth; packs are rebuilt whenever it changes.
+ */
+class TermPack : public TermBackend
+{
+public:
+    /**
+     * Maps a compiled pack.
+     * @param path The path to the pack.
+     */
+    TermPack(const QString &path);
+    virtual ~TermPack();
+
+    /**
+     * Returns if the pack was mapped and its layout is valid.
+     * @return true if the pack can be searched, false otherwise.
+     */
+    [[nodiscard]]
+    inline bool isValid() const
+    {
+        return m_header != nullptr;
+    }
+
+    /**
+     * Returns if the pack was compiled from the current version of a
+     * database.
+     * @param source The path to the database.
+     * @return true if the pack is up to date, false otherwise.
+     */
+    [[nodiscard]]
+    bool isCurrent(const QString &source) const;
+
+    QString queryTerms(
+        const QString &query,
+        const QSet<QString> &ruleFilter,
+        QList<SharedTerm> &terms,
+        const CancellationToken &token = CancellationToken()) const override;
+
+private:
+    /**
+     * Adds the index of every entry with a key to a list.
+     * @param      key     The UTF-8 key to look for.
+     * @param[out] entries The list to add the entry indices to.
+     */
+    void findEntries(
+        const QByteArray &key,
+        std::vector<uint32_t> &entries) const;
+
+    /**
+     * Gets a string from the string table.
+     * @param str The string to get.
+     * @return A pointer to the null terminated string, nullptr if str is out
+     *         of bounds.
+     */
+    [[nodiscard]]
+    const char *string(const TermPackString &str) const;
+
+    /* The mapped file */
+    QFile m_file;
+
+    /* The header of the pack. nullptr if the pack is invalid. */
+    const TermPackHeader *m_header = nullptr;
+
+    /* The entry table */
+    const TermPackEntry *m_entries = nullptr;
+
+    /* The key table */
+    const TermPackKey *m_keys = nullptr;
+
+    /* The string table */
+    const char *m_strings = nullptr;
+};
+
+/**
+ * Builds a term pack one term at a time.
+ */
+class TermPackWriter
+{
+public:
+    /**
+     * Adds a term to the pack.
+     * @param expression The UTF-8 expression of the term.
+     * @param reading    The UTF-8 reading of the term. May be empty.
+     * @param score      The summed score of the term.
+     * @param rules      The UTF-8 space separated rules of the term.
+     */
+    void addTerm(
+        const char *expression,
+        const char *reading,
+        int score,
+        const char *rules);
+
+    /**
+     * Writes the pack to disk. The pack is replaced atomically, so mapped
+     * copies of the old pack stay valid.
+     * @param path   The path to write the pack to.
+     * @param source The path to the database the pack was compiled from.
+     * @return Empty string on success, error string on error.
+     */
+    QString save(const QString &path, const QString &source);
+
+private:
+    /**
+     * Adds a string to the string table.
+     * @param str The null terminated UTF-8 string to add. May be NULL.
+     * @return The location of the string in the table.
+     */
+    TermPackString addString(const char *str);
+
+    /* The string table */
+    QByteArray m_strings;
+
+    /* Maps strings to their location in the string table */
+    QHash<QByteArray, TermPackString> m_stringIds;
+
+    /* The entry table */
+    std::vector<TermPackEntry> m_entries;
+
+    /* The key table, unsorted until saved */
+    std::vector<TermPackKey> m_keys;
+};
+
+#endif // TERMPACK_H
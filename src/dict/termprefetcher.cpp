@@ -0,0 +1,259 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "termprefetcher.h"
+
+#include <algorithm>
+
+#include <QMutexLocker>
+#include <QSettings>
+#include <QThread>
+
+#include "dictionary.h"
+
+#include "util/constants.h"
+
+/* Begin Constructor/Destructor */
+
+TermPrefetcher::TermPrefetcher(Dictionary *dictionary, QObject *parent)
+    : QObject(parent),
+      m_dictionary(dictionary)
+{
+    m_pool.setThreadPriority(QThread::LowestPriority);
+    initSettings();
+}
+
+TermPrefetcher::~TermPrefetcher()
+{
+    cancel();
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+/* End Constructor/Destructor */
+/* Begin Initializers */
+
+void TermPrefetcher::initSettings()
+{
+    QSettings settings;
+    settings.beginGroup(Constants::Settings::Search::GROUP);
+    m_settings.enabled = settings.value(
+            Constants::Settings::Search::PREFETCH,
+            Constants::Settings::Search::PREFETCH_DEFAULT
+        ).toBool();
+    m_settings.threads = settings.value(
+            Constants::Settings::Search::PREFETCH_THREADS,
+            Constants::Settings::Search::PREFETCH_THREADS_DEFAULT
+        ).toInt();
+    if (m_settings.threads < 1)
+    {
+        m_settings.threads = Constants::Settings::Search::PREFETCH_THREADS_DEFAULT;
+    }
+    m_settings.budget = settings.value(
+            Constants::Settings::Search::PREFETCH_BUDGET,
+            Constants::Settings::Search::PREFETCH_BUDGET_DEFAULT
+        ).toInt();
+    settings.endGroup();
+
+    m_pool.setMaxThreadCount(m_settings.threads);
+    if (!m_settings.enabled)
+    {
+        cancel();
+    }
+}
+
+/* End Initializers */
+/* Begin Prefetching */
+
+void TermPrefetcher::prefetch(
+    const QString &text,
+    const QFuture<SharedTextAnalysis> &analysis,
+    std::vector<int> positions)
+{
+    if (!m_settings.enabled || text.isEmpty() || analysis.isCanceled())
+    {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_cache.lock);
+        if (m_cache.text == text)
+        {
+            return;
+        }
+    }
+
+    m_cancel.cancel();
+    m_pool.clear();
+    const CancellationToken token = m_cancel.token();
+    {
+        QMutexLocker locker(&m_cache.lock);
+        m_cache.text = text;
+        m_cache.results.clear();
+    }
+
+    std::shared_ptr<const std::vector<int>> order =
+        std::make_shared<const std::vector<int>>(std::move(positions));
+    std::shared_ptr<QAtomicInt> next = std::make_shared<QAtomicInt>(0);
+    QElapsedTimer timer;
+    timer.start();
+    const int budget = m_settings.budget;
+    for (int i = 0; i < m_settings.threads; ++i)
+    {
+        m_pool.start(
+            [=] { run(token, analysis, order, next, timer, budget); }
+        );
+    }
+}
+
+void TermPrefetcher::cancel()
+{
+    m_cancel.cancel();
+    m_pool.clear();
+
+    QMutexLocker locker(&m_cache.lock);
+    m_cache.text.clear();
+    m_cache.results.clear();
+}
+
+bool TermPrefetcher::result(
+    const QString &text,
+    int index,
+    SharedTermList &terms,
+    SharedKanji &kanji) const
+{
+    QMutexLocker locker(&m_cache.lock);
+    if (m_cache.text != text)
+    {
+        return false;
+    }
+    auto it = m_cache.results.constFind(index);
+    if (it == m_cache.results.cend())
+    {
+        return false;
+    }
+    terms = it->first;
+    kanji = it->second;
+    return true;
+}
+
+void TermPrefetcher::run(
+    CancellationToken token,
+    QFuture<SharedTextAnalysis> analysisFuture,
+    std::shared_ptr<const std::vector<int>> order,
+    std::shared_ptr<QAtomicInt> next,
+    QElapsedTimer timer,
+    int budget)
+{
+    if (token.isCancelled())
+    {
+        return;
+    }
+    SharedTextAnalysis analysis = analysisFuture.result();
+    if (analysis == nullptr)
+    {
+        return;
+    }
+
+    const QString &text = analysis->text();
+    const std::vector<int> positions =
+        order->empty() ? orderPositions(*analysis) : *order;
+    for (int i = next->fetchAndAddRelaxed(1);
+         i < static_cast<int>(positions.size());
+         i = next->fetchAndAddRelaxed(1))
+    {
+        if (token.isCancelled() || (budget > 0 && timer.hasExpired(budget)))
+        {
+            return;
+        }
+
+        const int index = positions[i];
+        SharedTermList terms =
+            m_dictionary->searchTerms(analysis, index, token);
+        if (token.isCancelled())
+        {
+            return;
+        }
+        else if (terms && terms->isEmpty())
+        {
+            terms = nullptr;
+        }
+
+        SharedKanji kanji = nullptr;
+        if (analysis->characterClass(index) ==
+                TextAnalysis::CharacterClass::kanji)
+        {
+            kanji = m_dictionary->searchKanji(text[index]);
+            if (kanji)
+            {
+                kanji->lookup = terms ?
+                    terms->first()->lookup :
+                    SharedLookupContext(new LookupContext{text});
+                kanji->matchOffset = index;
+                kanji->matchLength = 1;
+            }
+        }
+
+        QMutexLocker locker(&m_cache.lock);
+        if (token.isCancelled() || m_cache.text != text)
+        {
+            return;
+        }
+        m_cache.results.insert(index, {terms, kanji});
+    }
+}
+
+std::vector<int> TermPrefetcher::orderPositions(const TextAnalysis &analysis)
+{
+    std::vector<QPair<int, qsizetype>> lengths;
+    for (int i = 0; i < analysis.text().size(); ++i)
+    {
+        qsizetype longest = 0;
+        for (const SearchQuery &query : analysis.queries(i))
+        {
+            longest = std::max(longest, query.surface.size());
+        }
+        if (longest > 0 ||
+            analysis.characterClass(i) == TextAnalysis::CharacterClass::kanji)
+        {
+            lengths.emplace_back(i, longest);
+        }
+    }
+
+    /* Longest candidate matches first, reading order breaks ties */
+    std::stable_sort(
+        std::begin(lengths), std::end(lengths),
+        [] (const QPair<int, qsizetype> &lhs,
+            const QPair<int, qsizetype> &rhs) -> bool
+        {
+            return lhs.second > rhs.second;
+        }
+    );
+
+    std::vector<int> positions;
+    positions.reserve(lengths.size());
+    for (const QPair<int, qsizetype> &p : lengths)
+    {
+        positions.emplace_back(p.first);
+    }
+    return positions;
+}
+
+/* End Prefetching */
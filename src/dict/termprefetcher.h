@@ -0,0 +1,179 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TERMPREFETCHER_H
+#define TERMPREFETCHER_H
+
+#include <QObject>
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QThreadPool>
+
+#include <memory>
+#include <vector>
+
+#include "cancellationtoken.h"
+#include "expression.h"
+#include "textanalysis.h"
+
+class Dictionary;
+
+/**
+ * Speculatively searches every position of a line of text in the background
+ * so results are ready before the user hovers over the text.
+ */
+class TermPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructs a prefetcher.
+     * @param dictionary The dictionary to search. Must outlive the prefetcher.
+     * @param parent     The parent of this object.
+     */
+    TermPrefetcher(Dictionary *dictionary, QObject *parent = nullptr);
+    virtual ~TermPrefetcher();
+
+    /**
+     * Returns if prefetching is enabled by the user.
+     * @return true if prefetching is enabled, false otherwise.
+     */
+    [[nodiscard]]
+    inline bool enabled() const
+    {
+        return m_settings.enabled;
+    }
+
+    /**
+     * Initializes the prefetcher settings. Does not cancel a running
+     * prefetch.
+     */
+    void initSettings();
+
+    /**
+     * Starts searching every position of a line of text. Cancels any
+     * prefetch that is already running. Does nothing if prefetching is
+     * disabled or the text is already being prefetched.
+     * @param text      The line of text to prefetch.
+     * @param analysis  The analysis of the line of text.
+     * @param positions The positions to search in the order they are searched.
+     *                  Empty to search every position that has queries,
+     *                  longest candidate matches first.
+     */
+    void prefetch(
+        const QString &text,
+        const QFuture<SharedTextAnalysis> &analysis,
+        std::vector<int> positions = {});
+
+    /**
+     * Stops the current prefetch and clears all cached results.
+     */
+    void cancel();
+
+    /**
+     * Gets the cached result for a position in a line of text.
+     * @param      text  The line of text.
+     * @param      index The position in the text.
+     * @param[out] terms The terms found at the position, nullptr if there
+     *                   were none.
+     * @param[out] kanji The kanji found at the position, nullptr if there was
+     *                   none.
+     * @return true if there is a cached result, false otherwise.
+     */
+    bool result(
+        const QString &text,
+        int index,
+        SharedTermList &terms,
+        SharedKanji &kanji) const;
+
+private:
+    /**
+     * Searches positions in the text until every position has been searched,
+     * the time budget runs out, or the prefetch is cancelled.
+     * @param token     Cancelled when this prefetch is superseded.
+     * @param analysis  The analysis of the text.
+     * @param order     The positions to search in order. Empty to search the
+     *                  positions returned by orderPositions().
+     * @param next      The index of the next position to search. Shared by
+     *                  all threads working on this prefetch.
+     * @param timer     The timer started when the prefetch began.
+     * @param budget    The number of milliseconds the prefetch may run for.
+     *                  Zero or less means no limit.
+     */
+    void run(
+        CancellationToken token,
+        QFuture<SharedTextAnalysis> analysis,
+        std::shared_ptr<const std::vector<int>> order,
+        std::shared_ptr<QAtomicInt> next,
+        QElapsedTimer timer,
+        int budget);
+
+    /**
+     * Orders the positions in an analysis so positions with the longest
+     * candidate matches are searched first.
+     * @param analysis The analysis of the text.
+     * @return Every position in the text that has queries.
+     */
+    [[nodiscard]]
+    static std::vector<int> orderPositions(const TextAnalysis &analysis);
+
+    /* The dictionary to search */
+    Dictionary *m_dictionary;
+
+    /* The low priority pool prefetch searches are run on */
+    QThreadPool m_pool;
+
+    /* Cancelled every time a prefetch is started or cancelled. Prefetches
+     * stop as soon as their token is cancelled. */
+    CancellationSource m_cancel;
+
+    /* Prefetched results */
+    struct Cache
+    {
+        /* The text the results belong to */
+        QString text;
+
+        /* Maps positions to the terms and kanji found there */
+        QHash<int, QPair<SharedTermList, SharedKanji>> results;
+
+        /* Locks the cache */
+        mutable QMutex lock;
+    } m_cache;
+
+    /* Prefetcher settings */
+    struct Settings
+    {
+        /* true if prefetching is enabled, false otherwise */
+        bool enabled{false};
+
+        /* The number of threads searches are run on */
+        int threads{1};
+
+        /* The maximum number of milliseconds spent on a single line */
+        int budget{0};
+    } m_settings;
+};
+
+#endif // TERMPREFETCHER_H
@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "textanalysis.h"
+
+/* Begin Constructor */
+
+TextAnalysis::TextAnalysis(
+    QString text,
+    std::vector<std::vector<SearchQuery>> queries)
+    : m_text(std::move(text)),
+      m_queries(std::move(queries))
+{
+    m_classes.resize(m_text.size());
+    TextNormalizer::classify(m_text, m_classes.data());
+}
+
+/* End Constructor */
+/* Begin Getters */
+
+TextAnalysis::CharacterClass TextAnalysis::characterClass(
+    qsizetype index) const
+{
+    if (index < 0 || index >= static_cast<qsizetype>(m_classes.size()))
+    {
+        return CharacterClass::other;
+    }
+    return m_classes[index];
+}
+
+const std::vector<SearchQuery> &TextAnalysis::queries(qsizetype index) const
+{
+    static const std::vector<SearchQuery> empty;
+    if (index < 0 || index >= static_cast<qsizetype>(m_queries.size()))
+    {
+        return empty;
+    }
+    return m_queries[index];
+}
+
+/* End Getters */
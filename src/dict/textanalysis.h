@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TEXTANALYSIS_H
+#define TEXTANALYSIS_H
+
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+#include "searchquery.h"
+
+#include "util/textnormalizer.h"
+
+/**
+ * The result of analyzing a line of text once. Holds everything needed to
+ * search for terms at any position in the line without processing the line
+ * again. Immutable once constructed so it can be shared between threads.
+ */
+class TextAnalysis
+{
+public:
+    /**
+     * The script a character belongs to.
+     */
+    using CharacterClass = TextNormalizer::CharacterClass;
+
+    /**
+     * Constructs an analysis of a line of text.
+     * @param text    The line of text.
+     * @param queries The sorted and deduplicated queries for every position in
+     *                the text.
+     */
+    TextAnalysis(QString text, std::vector<std::vector<SearchQuery>> queries);
+
+    /**
+     * Gets the line of text this analysis belongs to.
+     * @return The analyzed text.
+     */
+    [[nodiscard]]
+    inline const QString &text() const
+    {
+        return m_text;
+    }
+
+    /**
+     * Gets the class of the character at a position.
+     * @param index The position of the character.
+     * @return The class of the character, other if index is out of range.
+     */
+    [[nodiscard]]
+    CharacterClass characterClass(qsizetype index) const;
+
+    /**
+     * Gets the queries for the text starting at a position.
+     * @param index The position in the text.
+     * @return The queries for the position, empty if index is out of range.
+     */
+    [[nodiscard]]
+    const std::vector<SearchQuery> &queries(qsizetype index) const;
+
+    /**
+     * Classifies a single character.
+     * @param ch The character to classify.
+     * @return The class of the character.
+     */
+    [[nodiscard]]
+    static inline CharacterClass classify(QChar ch)
+    {
+        return TextNormalizer::classify(ch);
+    }
+
+private:
+    /* The analyzed line of text */
+    const QString m_text;
+
+    /* The class of every character in the text */
+    std::vector<CharacterClass> m_classes;
+
+    /* The queries for every position in the text */
+    const std::vector<std::vector<SearchQuery>> m_queries;
+};
+
+using SharedTextAnalysis = std::shared_ptr<const TextAnalysis>;
+
+#endif // TEXTANALYSIS_H
@@ -140,6 +140,186 @@ static int rollback_transaction(sqlite3 *db)
     return 0;
 }
 
+/**
+ * Collects the statistics the query planner uses to pick indexes. Only
+ * samples each index, so this stays fast on large databases. Failing to
+ * analyze is not an error since queries still work without statistics.
+ * @param db The database to analyze
+ */
+static void analyze_db(sqlite3 *db)
+{
+    char *errmsg = NULL;
+    sqlite3_exec(
+        db, "PRAGMA analysis_limit = 1000; ANALYZE;", NULL, NULL, &errmsg
+    );
+    if (errmsg)
+    {
+        fprintf(stderr, "Could not analyze database\nError: %s\n", errmsg);
+        sqlite3_free(errmsg);
+    }
+}
+
+/**
+ * Creates the full-text index over glossaries and the trigger that keeps it
+ * in sync with term_bank. Rows in the index share their rowid with the term
+ * they belong to. Not every build of SQLite has FTS5, so failing to create
+ * the index is not an error. Reverse searches just won't work.
+ * @param db The database to create the index in
+ * @return 0 if the index was created, nonzero otherwise
+ */
+static int create_glossary_index(sqlite3 *db)
+{
+    char *errmsg = NULL;
+    /* The last word of a search is matched as a prefix while the user types,
+     * so short prefixes get their own indexes */
+    sqlite3_exec(
+        db,
+        "CREATE VIRTUAL TABLE term_glossary USING fts5("
+            "glossary,"
+            "prefix = '2 3',"
+            "tokenize = 'unicode61 remove_diacritics 2'"
+        ");"
+        "CREATE TRIGGER term_bank_remove AFTER DELETE ON term_bank "
+        "BEGIN "
+            "DELETE FROM term_glossary WHERE rowid = old.rowid;"
+        "END;",
+        NULL, NULL, &errmsg
+    );
+    if (errmsg)
+    {
+        fprintf(stderr, "Could not create glossary index\nError: %s\n", errmsg);
+        sqlite3_free(errmsg);
+        return -1;
+    }
+    return 0;
+}
+
+/* Extracts the text of plain, text, and structured content glossaries */
+#define QUERY   "INSERT INTO term_glossary (rowid, glossary) "\
+                    "SELECT rowid, ("\
+                        "SELECT group_concat(value, ' ') "\
+                            "FROM json_tree(term_bank.glossary) "\
+                            "WHERE type = 'text' AND "\
+                                "(typeof(key) = 'integer' OR "\
+                                 "key IN ('content', 'text'))"\
+                    ") "\
+                    "FROM term_bank "\
+                    "WHERE ?1 IS NULL OR dic_id = ?1;"
+
+/**
+ * Adds the glossaries of terms to the full-text index. Does nothing if the
+ * index could not be created.
+ * @param db The database to index
+ * @param id The id of the dictionary to index, negative to index all
+ *           dictionaries
+ */
+static void index_glossaries(sqlite3 *db, const sqlite3_int64 id)
+{
+    sqlite3_stmt *stmt = NULL;
+    int           step = 0;
+
+    if (sqlite3_prepare_v2(db, QUERY, -1, &stmt, NULL) != SQLITE_OK)
+    {
+        fprintf(stderr, "Could not index glossaries\nError: %s\n",
+                sqlite3_errmsg(db));
+        goto cleanup;
+    }
+    if (id >= 0 && sqlite3_bind_int64(stmt, 1, id) != SQLITE_OK)
+    {
+        fprintf(stderr, "Could not bind values to sqlite statement\n");
+        goto cleanup;
+    }
+    if ((step = sqlite3_step(stmt)) != SQLITE_DONE)
+    {
+        fprintf(stderr, "Could not index glossaries\nError: %s\n",
+                sqlite3_errmsg(db));
+        goto cleanup;
+    }
+
+cleanup:
+    sqlite3_finalize(stmt);
+}
+
+#undef QUERY
+
+#define QUERY   "SELECT sql FROM sqlite_master "\
+                    "WHERE type = 'table' AND name = 'term_glossary';"
+
+/**
+ * Makes sure the full-text index over glossaries exists and is current. A
+ * database upgraded by an SQLite without FTS5 never got the index, so it is
+ * created and filled whenever it is missing. Indexes created before prefix
+ * indexes were added are rebuilt.
+ * @param db The database to check
+ */
+static void ensure_glossary_index(sqlite3 *db)
+{
+    sqlite3_stmt *stmt    = NULL;
+    int           step    = 0;
+    int           current = 0;
+    int           exists  = 0;
+    char         *errmsg  = NULL;
+
+    if (sqlite3_prepare_v2(db, QUERY, -1, &stmt, NULL) != SQLITE_OK)
+    {
+        fprintf(stderr, "Could not check glossary index\nError: %s\n",
+                sqlite3_errmsg(db));
+        goto cleanup;
+    }
+    if ((step = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        const char *sql = (const char *)sqlite3_column_text(stmt, 0);
+        exists = 1;
+        current = sql && strstr(sql, "prefix") != NULL;
+    }
+    else if (step != SQLITE_DONE)
+    {
+        fprintf(stderr, "Could not check glossary index\nError: %s\n",
+                sqlite3_errmsg(db));
+        goto cleanup;
+    }
+    sqlite3_finalize(stmt);
+    stmt = NULL;
+
+    if (current)
+    {
+        goto cleanup;
+    }
+    if (begin_transaction(db))
+    {
+        goto cleanup;
+    }
+    if (exists)
+    {
+        sqlite3_exec(
+            db,
+            "DROP TRIGGER IF EXISTS term_bank_remove;"
+            "DROP TABLE term_glossary;",
+            NULL, NULL, &errmsg
+        );
+        if (errmsg)
+        {
+            fprintf(stderr, "Could not drop glossary index\nError: %s\n",
+                    errmsg);
+            rollback_transaction(db);
+            goto cleanup;
+        }
+    }
+    if (create_glossary_index(db))
+    {
+        rollback_transaction(db);
+        goto cleanup;
+    }
+    index_glossaries(db, -1);
+    commit_transaction(db);
+
+cleanup:
+    sqlite3_finalize(stmt);
+    sqlite3_free(errmsg);
+}
+
+#undef QUERY
+
 /**
  * Drops all the tables provided in argv
  * @param   db   The database to drop tables from
@@ -232,7 +412,6 @@ static int create_db(sqlite3 *db)
             "score      INTEGER     NOT NULL,"
             "PRIMARY KEY(dic_id, name)"
         ");"
-        "CREATE INDEX idx_tag_bank_name ON tag_bank(dic_id, name);"
 
         "CREATE TABLE term_bank ("
             "dic_id     INTEGER     NOT NULL,"
@@ -245,9 +424,14 @@ static int create_db(sqlite3 *db)
             "sequence   INTEGER     NOT NULL,"
             "term_tags  TEXT        NOT NULL"   // Space separated list
         ");"
-        "CREATE INDEX idx_term_bank_exp     ON term_bank(expression);"
-        "CREATE INDEX idx_term_bank_reading ON term_bank(reading);"
-        "CREATE INDEX idx_term_bank_combo   ON term_bank(expression, reading);"
+        /* Covers the columns needed to rank terms so ranking never touches
+         * the table. The expression index also serves exact lookups. */
+        "CREATE INDEX idx_term_bank_exp     ON term_bank("
+            "expression, reading, dic_id, score, rules"
+        ");"
+        "CREATE INDEX idx_term_bank_reading ON term_bank("
+            "reading, expression, dic_id, score, rules"
+        ");"
 
         "CREATE TABLE term_meta_bank ("
             "dic_id     INTEGER     NOT NULL,"
@@ -256,7 +440,9 @@ static int create_db(sqlite3 *db)
             "type       INTEGER     NOT NULL,"  // Type of data in the blob
             "data       BLOB"                   // Data defined by mode
         ");"
-        "CREATE INDEX idx_term_meta_exp ON term_meta_bank(expression, mode);"
+        "CREATE INDEX idx_term_meta_exp ON term_meta_bank("
+            "expression, mode, dic_id"
+        ");"
 
         "CREATE TABLE kanji_bank ("
             "dic_id     INTEGER     NOT NULL,"
@@ -285,6 +471,7 @@ static int create_db(sqlite3 *db)
         ret = DB_CREATE_TABLE_ERR;
         goto cleanup;
     }
+    /* The glossary index is created by ensure_glossary_index() */
 
     /* Update the user_version pragma */
     pragma = sqlite3_mprintf("PRAGMA user_version = %d;", YOMI_DB_VERSION);
@@ -457,6 +644,99 @@ cleanup:
     return ret;
 }
 
+static int update_v4_to_v5(sqlite3 *db)
+{
+    int        ret     = 0;
+    const int  version = 5;
+    char      *pragma  = NULL;
+    char      *errmsg  = NULL;
+
+    pragma = sqlite3_mprintf(
+        "DROP INDEX IF EXISTS idx_tag_bank_name;"
+
+        "DROP INDEX IF EXISTS idx_term_bank_exp;"
+        "DROP INDEX IF EXISTS idx_term_bank_reading;"
+        "DROP INDEX IF EXISTS idx_term_bank_combo;"
+        "CREATE INDEX idx_term_bank_exp     ON term_bank("
+            "expression, reading, dic_id, score, rules"
+        ");"
+        "CREATE INDEX idx_term_bank_reading ON term_bank("
+            "reading, expression, dic_id, score, rules"
+        ");"
+
+        "DROP INDEX IF EXISTS idx_term_meta_exp;"
+        "CREATE INDEX idx_term_meta_exp ON term_meta_bank("
+            "expression, mode, dic_id"
+        ");"
+
+        "PRAGMA user_version = %d;",
+        version
+    );
+
+    if (pragma == NULL)
+    {
+        fprintf(stderr, "Could not allocate memory for query\n");
+        ret = MALLOC_FAILURE_ERR;
+        goto cleanup;
+    }
+
+    if (sqlite3_exec(db, pragma, NULL, NULL, &errmsg) != SQLITE_OK)
+    {
+        fprintf(stderr,
+            "Failed to update database from version 4 to 5.\n"
+            "Error: %s\n"
+            "Query: %s\n",
+            errmsg, pragma
+        );
+        ret = DB_ALTER_TABLE_ERR;
+        goto cleanup;
+    }
+
+    analyze_db(db);
+
+cleanup:
+    sqlite3_free(errmsg);
+    sqlite3_free(pragma);
+
+    return ret;
+}
+
+static int update_v5_to_v6(sqlite3 *db)
+{
+    int        ret     = 0;
+    const int  version = 6;
+    char      *pragma  = NULL;
+    char      *errmsg  = NULL;
+
+    /* The glossary index is created by ensure_glossary_index() so it is
+     * retried on every open if this SQLite has no FTS5 */
+    pragma = sqlite3_mprintf("PRAGMA user_version = %d;", version);
+    if (pragma == NULL)
+    {
+        fprintf(stderr, "Could not allocate memory for query\n");
+        ret = MALLOC_FAILURE_ERR;
+        goto cleanup;
+    }
+
+    if (sqlite3_exec(db, pragma, NULL, NULL, &errmsg) != SQLITE_OK)
+    {
+        fprintf(stderr,
+            "Failed to update database from version 5 to 6.\n"
+            "Error: %s\n"
+            "Query: %s\n",
+            errmsg, pragma
+        );
+        ret = DB_ALTER_TABLE_ERR;
+        goto cleanup;
+    }
+
+cleanup:
+    sqlite3_free(errmsg);
+    sqlite3_free(pragma);
+
+    return ret;
+}
+
 /**
  * Create the tables in the database if they do not already exist
  * @param   db The database to add tables to
@@ -523,7 +803,22 @@ static int prepare_db(sqlite3 *db)
         {
             goto cleanup;
         }
+        __attribute__((fallthrough));
+
+    case 4:
+        if ((ret = update_v4_to_v5(db)))
+        {
+            goto cleanup;
+        }
+        __attribute__((fallthrough));
+
+    case 5:
+        if ((ret = update_v5_to_v6(db)))
+        {
+            goto cleanup;
+        }
     }
+    ensure_glossary_index(db);
 
     /* Set all PRAGMA value to their expected values */
     sqlite3_exec(db, "PRAGMA recursive_triggers = true;", NULL, NULL, &errmsg);
@@ -2058,6 +2353,7 @@ int yomi_process_dictionary(const char *dict_file, const char *db_file, const ch
         ret = YOMI_ERR_ADDING_TERMS;
         goto error;
     }
+    index_glossaries(db, id);
 
     /* Process term bank metadata */
     if (add_dic_files(dict_archive, db, id, term_meta_bank))
@@ -2093,6 +2389,9 @@ int yomi_process_dictionary(const char *dict_file, const char *db_file, const ch
         goto error;
     }
 
+    /* The new rows change which indexes are worth using */
+    analyze_db(db);
+
     zip_close(dict_archive);
     sqlite3_close_v2(db);
 
@@ -22,12 +22,15 @@
 #include "ui_definitionwidget.h"
 
 #include <QFrame>
+#include <QFutureWatcher>
 #include <QGraphicsDropShadowEffect>
 #include <QPushButton>
 #include <QScrollBar>
 #include <QSettings>
+#include <QtConcurrent>
 
 #include "audio/audioplayer.h"
+#include "dict/dictionary.h"
 #include "util/constants.h"
 #include "util/globalmediator.h"
 #include "util/iconfactory.h"
@@ -68,6 +71,7 @@ DefinitionWidget::~DefinitionWidget()
 void DefinitionWidget::clearTerms()
 {
     ++m_searchId;
+    m_loadCancel.cancel();
     m_savedScroll = 0;
     m_addable.clear();
     m_termWidgets.clear();
@@ -261,8 +265,9 @@ void DefinitionWidget::setTerms(SharedTermList terms, SharedKanji kanji)
         return;
     }
 
-    /* Add the terms */
-    showTerms(0, m_state.resultLimit);
+    /* Add the terms that have been loaded */
+    const int end = loadedEnd(0, m_state.resultLimit);
+    showTerms(0, end);
     m_ui->scrollArea->verticalScrollBar()->setValue(0);
     if (m_state.autoPlayAudio && !m_termWidgets.empty())
     {
@@ -271,7 +276,7 @@ void DefinitionWidget::setTerms(SharedTermList terms, SharedKanji kanji)
 
     QPushButton *buttonShowMore = nullptr;
     /* Add the show more button */
-    if (m_state.resultLimit < m_terms.size() + (m_kanji ? 1 : 0))
+    if (end < m_terms.size() + (m_kanji ? 1 : 0))
     {
         buttonShowMore = new QPushButton;
         buttonShowMore->setSizePolicy(
@@ -297,26 +302,13 @@ void DefinitionWidget::setTerms(SharedTermList terms, SharedKanji kanji)
     m_ui->layoutScroll->addStretch();
 
     /* Check if entries are addable to Anki */
-    if (m_client->isEnabled())
-    {
-        AnkiReply *reply = m_client->notesAddable(m_terms);
-        int searchId = m_searchId;
-        connect(reply, &AnkiReply::finishedBoolList, this,
-            [=] (const QList<bool> &addable, const QString &error) {
-                if (error.isEmpty() && searchId == m_searchId)
-                {
-                    m_addable = addable;
-                    setAddable(0, m_state.resultLimit);
-                }
-            }
+    AnkiReply *reply = checkAddable(0, end);
+    if (reply && buttonShowMore)
+    {
+        connect(
+            reply, &AnkiReply::finishedBoolList,
+            buttonShowMore, [=] { buttonShowMore->setEnabled(true); }
         );
-        if (buttonShowMore)
-        {
-            connect(
-                reply, &AnkiReply::finishedBoolList,
-                buttonShowMore, [=] { buttonShowMore->setEnabled(true); }
-            );
-        }
     }
 
     Q_EMIT widgetShown();
@@ -364,6 +356,65 @@ void DefinitionWidget::mousePressEvent(QMouseEvent *event)
 }
 
 void DefinitionWidget::showMoreTerms()
+{
+    const int start = m_termWidgets.size();
+    const int end   = start + m_state.resultLimit;
+    if (loadedEnd(start, end) == end)
+    {
+        appendTerms();
+        return;
+    }
+
+    /* Load the next page before showing it */
+    QPushButton *buttonShowMore = qobject_cast<QPushButton *>(sender());
+    if (buttonShowMore)
+    {
+        buttonShowMore->setEnabled(false);
+    }
+
+    const int searchId = m_searchId;
+    const CancellationToken token = m_loadCancel.token();
+    const QList<QSharedPointer<const Term>> terms = m_terms;
+    QFutureWatcher<SharedTermList> *watcher =
+        new QFutureWatcher<SharedTermList>(this);
+    connect(
+        watcher, &QFutureWatcher<SharedTermList>::finished, this,
+        [=] {
+            SharedTermList page = watcher->result();
+            watcher->deleteLater();
+            if (searchId != m_searchId)
+            {
+                return;
+            }
+            if (buttonShowMore)
+            {
+                buttonShowMore->setEnabled(true);
+            }
+            if (page == nullptr)
+            {
+                return;
+            }
+
+            for (qsizetype i = 0;
+                 i < page->size() && start + i < m_terms.size();
+                 ++i)
+            {
+                m_terms[start + i] = page->at(i);
+            }
+            appendTerms();
+        }
+    );
+    watcher->setFuture(
+        QtConcurrent::run(
+            [=] {
+                return GlobalMediator::getGlobalMediator()->getDictionary()
+                    ->loadTerms(terms, start, end - start, token);
+            }
+        )
+    );
+}
+
+void DefinitionWidget::appendTerms()
 {
     QLayoutItem *spacer = m_ui->scrollAreaContents->layout()->takeAt(
         m_ui->scrollAreaContents->layout()->count() - 1
@@ -376,7 +427,7 @@ void DefinitionWidget::showMoreTerms()
     int start = m_termWidgets.size();
     int end   = start + m_state.resultLimit;
     showTerms(start, end);
-    setAddable(start, end);
+    checkAddable(start, end);
 
     if (end < m_terms.size() + (m_kanji ? 1 : 0))
     {
@@ -437,6 +488,35 @@ void DefinitionWidget::showTerms(const int start, const int end)
     setUpdatesEnabled(true);
 }
 
+AnkiReply *DefinitionWidget::checkAddable(const int start, const int end)
+{
+    if (!m_client->isEnabled())
+    {
+        return nullptr;
+    }
+
+    AnkiReply *reply = m_client->notesAddable(m_terms.mid(start, end - start));
+    int searchId = m_searchId;
+    connect(reply, &AnkiReply::finishedBoolList, this,
+        [=] (const QList<bool> &addable, const QString &error) {
+            if (!error.isEmpty() || searchId != m_searchId)
+            {
+                return;
+            }
+            if (m_addable.size() < start * 2 + addable.size())
+            {
+                m_addable.resize(start * 2 + addable.size());
+            }
+            for (qsizetype i = 0; i < addable.size(); ++i)
+            {
+                m_addable[start * 2 + i] = addable[i];
+            }
+            setAddable(start, end);
+        }
+    );
+    return reply;
+}
+
 void DefinitionWidget::setAddable(const int start, const int end)
 {
     for (int i = start;
@@ -447,6 +527,18 @@ void DefinitionWidget::setAddable(const int start, const int end)
     }
 }
 
+int DefinitionWidget::loadedEnd(const int start, const int end) const
+{
+    for (int i = start; i < end && i < m_terms.size(); ++i)
+    {
+        if (!m_terms[i]->loaded)
+        {
+            return i;
+        }
+    }
+    return end;
+}
+
 /* End Term Helpers */
 /* Begin Kanji Helpers */
 
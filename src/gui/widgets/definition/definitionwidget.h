@@ -31,6 +31,7 @@
 #include "termwidget.h"
 
 #include "anki/ankiclient.h"
+#include "dict/cancellationtoken.h"
 #include "dict/expression.h"
 
 enum class AudioSourceType;
@@ -106,10 +107,25 @@ private Q_SLOTS:
     void initSignals();
 
     /**
-     * Shows more terms up to the limit.
+     * Shows more terms up to the limit. Loads the next page of terms first if
+     * it has not been loaded.
      */
     void showMoreTerms();
 
+    /**
+     * Adds the next page of terms below the currently shown terms. Every term
+     * in the page must already be loaded.
+     */
+    void appendTerms();
+
+    /**
+     * Checks if the terms in m_terms from start to end are addable to Anki.
+     * @param start The starting index in m_terms to check (inclusive).
+     * @param end   The ending index in m_terms to check (exclusive).
+     * @return The reply, nullptr if Anki is not enabled.
+     */
+    AnkiReply *checkAddable(const int start, const int end);
+
     /**
      * Sets all terms in m_terms from start to end as addable to Anki based on
      * the values in m_addable.
@@ -126,6 +142,15 @@ private Q_SLOTS:
      */
     void showTerms(const int start, const int end);
 
+    /**
+     * Finds the end of the run of loaded terms in m_terms.
+     * @param start The starting index in m_terms (inclusive).
+     * @param end   The ending index in m_terms (exclusive).
+     * @return The index of the first term from start that is not loaded, end
+     *         if every term up to end is loaded.
+     */
+    int loadedEnd(const int start, const int end) const;
+
     /**
      * Hides terms and shows a kanji entry.
      * @param kanji The kanji to show.
@@ -220,6 +245,9 @@ private:
     /* Current search ID. Used to prevent erroneous signals */
     int m_searchId = 0;
 
+    /* Cancelled when the terms are cleared so stale pages stop loading */
+    CancellationSource m_loadCancel;
+
     /* The child definition widget */
     QPointer<DefinitionWidget> m_child = nullptr;
 };
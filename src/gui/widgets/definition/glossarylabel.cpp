@@ -636,6 +636,7 @@ void GlossaryLabel::mouseMoveEvent(QMouseEvent *event)
         return;
     }
     m_currentIndex = position;
+    m_searchCancel.cancel();
 
     QString text = toPlainText();
     QRegularExpression delim("[\\n。\\.]");
@@ -662,7 +663,7 @@ void GlossaryLabel::mouseMoveEvent(QMouseEvent *event)
 
     int index = position - start;
     DictionaryWorker *worker = new DictionaryWorker(
-        query, text, index, position
+        query, text, index, position, m_searchCancel.token()
     );
     connect(
         worker, &DictionaryWorker::searchDone,
@@ -683,9 +684,13 @@ void GlossaryLabel::mousePressEvent(QMouseEvent *event)
 void DictionaryWorker::run()
 {
     Dictionary *dict = GlobalMediator::getGlobalMediator()->getDictionary();
-    SharedTermList terms = dict->searchTerms(query, sentence, index, &index);
+    SharedTermList terms = dict->searchTerms(query, sentence, index, token);
 
-    if (terms == nullptr)
+    if (token.isCancelled())
+    {
+        return;
+    }
+    else if (terms == nullptr)
     {
         /* noop */
     }
@@ -700,17 +705,18 @@ void DictionaryWorker::run()
         kanji = SharedKanji(dict->searchKanji(query[0]));
         if (kanji)
         {
-            kanji->sentence = sentence;
-            kanji->clozePrefix = sentence.left(index);
-            kanji->clozeBody = kanji->character;
-            kanji->clozeSuffix = sentence.mid(index + 1);
+            kanji->lookup = terms ?
+                terms->first()->lookup :
+                SharedLookupContext(new LookupContext{sentence});
+            kanji->matchOffset = index;
+            kanji->matchLength = 1;
         }
     }
 
     int length = 0;
     if (terms)
     {
-        length = terms->first()->clozeBody.size();
+        length = terms->first()->matchLength;
     }
     else if (kanji)
     {
@@ -24,6 +24,7 @@
 #include <QRunnable>
 #include <QTextEdit>
 
+#include "dict/cancellationtoken.h"
 #include "dict/expression.h"
 #include "util/constants.h"
 
@@ -193,6 +194,9 @@ private:
 
     /* The index that is currently being searched */
     int m_currentIndex = -1;
+
+    /* Cancelled whenever the current index changes so stale searches stop */
+    CancellationSource m_searchCancel;
 };
 
 /**
@@ -209,17 +213,20 @@ public:
      * @param sentence The sentence containing the query.
      * @param index    The position of the query in the sentence.
      * @param position The position of the query in the entire text.
+     * @param token    Cancelled if the search is superseded.
      */
     DictionaryWorker(
         const QString &query,
         const QString &sentence,
         int index,
-        int position
+        int position,
+        const CancellationToken &token
     ) : QObject(nullptr),
         query(query),
         sentence(sentence),
         index(index),
-        position(position) {}
+        position(position),
+        token(token) {}
 
     /**
      * Searches the dictionary and emits are signal when finished.
@@ -253,6 +260,9 @@ private:
 
     /* The position of the query in the entire text */
     int position;
+
+    /* Cancelled if the search is superseded */
+    const CancellationToken token;
 };
 
 #endif // GLOSSARYLABEL_H
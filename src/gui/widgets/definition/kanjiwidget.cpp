@@ -254,17 +254,19 @@ void KanjiWidget::addKanji()
     double delay =
         mediator->getPlayerAdapter()->getSubDelay() -
         mediator->getPlayerAdapter()->getAudioDelay();
-    kanji->clipboard = QGuiApplication::clipboard()->text();
-    kanji->title = player->getTitle();
-    kanji->sentence = player->getSubtitle(true);
-    kanji->sentence2 = player->getSecondarySubtitle();
-    kanji->startTime = player->getSubStart() + delay;
-    kanji->endTime = player->getSubEnd() + delay;
-    kanji->context = subList->getPrimaryContext("\n");
-    kanji->context2 = subList->getSecondaryContext("\n");
+    NoteContext *note = new NoteContext;
+    note->clipboard = QGuiApplication::clipboard()->text();
+    note->title = player->getTitle();
+    note->sentence = player->getSubtitle(true);
+    note->sentence2 = player->getSecondarySubtitle();
+    note->startTime = player->getSubStart() + delay;
+    note->endTime = player->getSubEnd() + delay;
+    note->context = subList->getPrimaryContext("\n");
+    note->context2 = subList->getSecondaryContext("\n");
     QPair<double, double> contextTimes = subList->getPrimaryContextTime();
-    kanji->startTimeContext = contextTimes.first + delay;
-    kanji->endTimeContext = contextTimes.second + delay;
+    note->startTimeContext = contextTimes.first + delay;
+    note->endTimeContext = contextTimes.second + delay;
+    kanji->note = SharedNoteContext(note);
 
     AnkiReply *reply = mediator->getAnkiClient()->addNote(kanji);
     connect(reply, &AnkiReply::finishedInt, this,
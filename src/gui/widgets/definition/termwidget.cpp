@@ -283,17 +283,19 @@ Term *TermWidget::initAnkiTerm() const
     double delay =
         mediator->getPlayerAdapter()->getSubDelay() -
         mediator->getPlayerAdapter()->getAudioDelay();
-    term->clipboard = QGuiApplication::clipboard()->text();
-    term->title = player->getTitle();
-    term->sentence = player->getSubtitle(true);
-    term->sentence2 = player->getSecondarySubtitle();
-    term->startTime = player->getSubStart() + delay;
-    term->endTime = player->getSubEnd() + delay;
-    term->context = subList->getPrimaryContext("\n");
-    term->context2 = subList->getSecondaryContext("\n");
+    NoteContext *note = new NoteContext;
+    note->clipboard = QGuiApplication::clipboard()->text();
+    note->title = player->getTitle();
+    note->sentence = player->getSubtitle(true);
+    note->sentence2 = player->getSecondarySubtitle();
+    note->startTime = player->getSubStart() + delay;
+    note->endTime = player->getSubEnd() + delay;
+    note->context = subList->getPrimaryContext("\n");
+    note->context2 = subList->getSecondaryContext("\n");
     QPair<double, double> contextTimes = subList->getPrimaryContextTime();
-    term->startTimeContext = contextTimes.first + delay;
-    term->endTimeContext = contextTimes.second + delay;
+    note->startTimeContext = contextTimes.first + delay;
+    note->endTimeContext = contextTimes.second + delay;
+    term->note = SharedNoteContext(note);
 
     return term;
 }
@@ -513,14 +515,10 @@ void TermWidget::searchKanji(const QString &ch)
     );
     if (kanji)
     {
-        kanji->title       = m_term->title;
-        kanji->sentence    = m_term->sentence;
-        kanji->startTime   = m_term->startTime;
-        kanji->endTime     = m_term->endTime;
-        kanji->sentence2   = m_term->sentence2;
-        kanji->clozePrefix = m_term->clozePrefix;
-        kanji->clozeBody   = m_term->clozeBody;
-        kanji->clozeSuffix = m_term->clozeSuffix;
+        kanji->lookup      = m_term->lookup;
+        kanji->matchOffset = m_term->matchOffset;
+        kanji->matchLength = m_term->matchLength;
+        kanji->note        = m_term->note;
         Q_EMIT kanjiSearched(QSharedPointer<const Kanji>(kanji));
     }
 }
@@ -214,6 +214,11 @@ void MpvWidget::initPropertyMap()
             }
         };
 
+    m_propertyMap["playlist-count"] =
+        [=] (mpv_event_property *) {
+            Q_EMIT playlistChanged();
+        };
+
     m_propertyMap["pause"] =
         [=] (mpv_event_property *prop) {
             if (prop->format == MPV_FORMAT_FLAG)
@@ -590,6 +595,7 @@ void MpvWidget::initializeGL()
     mpv_observe_property(m_mpv, 0, "media-title",         MPV_FORMAT_STRING);
     mpv_observe_property(m_mpv, 0, "path",                MPV_FORMAT_STRING);
     mpv_observe_property(m_mpv, 0, "pause",               MPV_FORMAT_FLAG);
+    mpv_observe_property(m_mpv, 0, "playlist-count",      MPV_FORMAT_INT64);
     mpv_observe_property(m_mpv, 0, "time-pos",            MPV_FORMAT_DOUBLE);
     mpv_observe_property(m_mpv, 0, "track-list/count",    MPV_FORMAT_INT64);
     mpv_observe_property(m_mpv, 0, "volume",              MPV_FORMAT_INT64);
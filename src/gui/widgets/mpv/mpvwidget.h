@@ -125,6 +125,11 @@ Q_SIGNALS:
      */
     void fileChanged(QString path) const;
 
+    /**
+     * Emitted when the number of files in the playlist changes.
+     */
+    void playlistChanged() const;
+
     /**
      * Emitted when the current video track changes to a different id.
      * @param id The id of the current video track starting at 1.
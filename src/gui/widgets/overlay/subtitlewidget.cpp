@@ -25,9 +25,13 @@
 #include <QClipboard>
 #include <QDebug>
 #include <QScrollBar>
+#include <QSet>
 #include <QSettings>
 #include <QTextEdit>
 #include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
 
 #include "player/playeradapter.h"
 #include "util/constants.h"
@@ -63,6 +67,9 @@ SubtitleWidget::SubtitleWidget(QWidget *parent)
 
     m_findDelay->setSingleShot(true);
 
+    m_prefetcher = new TermPrefetcher(m_dictionary, this);
+    m_vocabulary = new EpisodeVocabulary(m_dictionary, MAX_QUERY_LENGTH, this);
+
     initSettings();
 
     GlobalMediator *mediator = GlobalMediator::getGlobalMediator();
@@ -130,6 +137,30 @@ SubtitleWidget::SubtitleWidget(QWidget *parent)
         mediator, &GlobalMediator::playerPositionChanged,
         this,     &SubtitleWidget::positionChanged
     );
+    connect(
+        mediator, &GlobalMediator::subtitleListLoaded,
+        this,     &SubtitleWidget::setEpisode,
+        Qt::QueuedConnection
+    );
+    connect(
+        mediator, &GlobalMediator::playerFileChanged,
+        this,
+        [this] {
+            m_episodeLines.clear();
+            m_vocabulary->cancel();
+        },
+        Qt::QueuedConnection
+    );
+    connect(
+        mediator, &GlobalMediator::dictionariesChanged,
+        this,     &SubtitleWidget::precomputeVocabulary,
+        Qt::QueuedConnection
+    );
+    connect(
+        mediator, &GlobalMediator::dictionaryOrderChanged,
+        this,     &SubtitleWidget::precomputeVocabulary,
+        Qt::QueuedConnection
+    );
     connect(
         mediator, &GlobalMediator::playerSubtitlesDisabled,
         this,     [this] { positionChanged(-1); },
@@ -159,6 +190,14 @@ SubtitleWidget::SubtitleWidget(QWidget *parent)
         [this] (bool paused) {
             m_paused = paused;
             adjustVisibility();
+            if (m_paused)
+            {
+                prefetchTerms();
+            }
+            else
+            {
+                m_searchCancel.cancel();
+            }
         },
         Qt::QueuedConnection
     );
@@ -320,6 +359,14 @@ void SubtitleWidget::initSettings()
             Constants::Settings::Search::REPLACE_WITH,
             Constants::Settings::Search::REPLACE_WITH_DEFAULT
         ).toString();
+
+    /* Query generators may have changed, so the analysis is stale */
+    m_prefetcher->initSettings();
+    m_prefetcher->cancel();
+    m_vocabulary->initSettings();
+    precomputeVocabulary();
+    m_analysis.text.clear();
+    m_analysis.future = QFuture<SharedTextAnalysis>();
     setSubtitle(
         m_subtitle.rawText, m_subtitle.startTime, m_subtitle.endTime, 0
     );
@@ -378,6 +425,7 @@ void SubtitleWidget::mouseMoveEvent(QMouseEvent *event)
     {
     case Settings::SearchMethod::Hover:
         m_currentIndex = position;
+        m_searchCancel.cancel();
         m_findDelay->start(m_settings.delay);
         break;
 
@@ -385,6 +433,7 @@ void SubtitleWidget::mouseMoveEvent(QMouseEvent *event)
         if (QGuiApplication::keyboardModifiers() & m_settings.modifier)
         {
             m_currentIndex = position;
+            m_searchCancel.cancel();
             findTerms();
         }
         break;
@@ -405,6 +454,7 @@ void SubtitleWidget::leaveEvent(QEvent *event)
 
     m_findDelay->stop();
     m_currentIndex = -1;
+    m_searchCancel.cancel();
     adjustVisibility();
 }
 
@@ -435,21 +485,71 @@ void SubtitleWidget::findTerms()
     }
 
     QString subtitleText = getText();
+
+    /* Use prefetched results if they are ready */
+    SharedTermList prefetchedTerms = nullptr;
+    SharedKanji prefetchedKanji = nullptr;
+    if (m_prefetcher->result(
+            subtitleText, index, prefetchedTerms, prefetchedKanji))
+    {
+        if (prefetchedTerms)
+        {
+            m_lastEmittedIndex = index;
+            m_lastEmittedSize = prefetchedTerms->first()->matchLength;
+        }
+        else if (prefetchedKanji)
+        {
+            m_lastEmittedIndex = index;
+            m_lastEmittedSize = 1;
+        }
+        Q_EMIT GlobalMediator::getGlobalMediator()
+            ->termsChanged(prefetchedTerms, prefetchedKanji);
+        return;
+    }
+
+    /* Nothing to search for if the episode was looked up ahead of time and
+     * no word starts here */
+    EpisodeVocabulary::Word word;
+    if (m_vocabulary->lookup(subtitleText, index, word) &&
+        word.length == 0 &&
+        !CharacterUtils::isKanji(queryStr[0]))
+    {
+        Q_EMIT GlobalMediator::getGlobalMediator()
+            ->termsChanged(nullptr, nullptr);
+        return;
+    }
+
+    QFuture<SharedTextAnalysis> analysisFuture = m_analysis.future;
+    const CancellationToken token = m_searchCancel.token();
     QThreadPool::globalInstance()->start(
         [=] {
             /* Look for Terms */
-            SharedTermList terms = m_dictionary->searchTerms(
-                queryStr, subtitleText, index, &m_currentIndex
-            );
-            if (terms == nullptr)
+            SharedTextAnalysis analysis = nullptr;
+            if (!analysisFuture.isCanceled())
             {
-                /* noop */
+                analysis = analysisFuture.result();
             }
-            else if (!m_paused || index != m_currentIndex)
+            SharedTermList terms = nullptr;
+            if (analysis && analysis->text() == subtitleText)
+            {
+                terms = m_dictionary->searchTerms(analysis, index, token);
+            }
+            else
+            {
+                analysis = nullptr;
+                terms = m_dictionary->searchTerms(
+                    queryStr, subtitleText, index, token
+                );
+            }
+            if (token.isCancelled())
             {
                 /* Early Exit */
                 return;
             }
+            else if (terms == nullptr)
+            {
+                /* noop */
+            }
             else if (terms->isEmpty())
             {
                 /* No Terms */
@@ -458,20 +558,25 @@ void SubtitleWidget::findTerms()
             else
             {
                 m_lastEmittedIndex = index;
-                m_lastEmittedSize = terms->first()->clozeBody.size();
+                m_lastEmittedSize = terms->first()->matchLength;
             }
 
             /* Look for Kanji */
             SharedKanji kanji = nullptr;
-            if (CharacterUtils::isKanji(queryStr[0]))
+            const bool isKanji = analysis ?
+                analysis->characterClass(index) ==
+                    TextAnalysis::CharacterClass::kanji :
+                CharacterUtils::isKanji(queryStr[0]);
+            if (isKanji)
             {
                 kanji = m_dictionary->searchKanji(queryStr[0]);
                 if (kanji)
                 {
-                    kanji->sentence = subtitleText;
-                    kanji->clozePrefix = subtitleText.left(index);
-                    kanji->clozeBody = kanji->character;
-                    kanji->clozeSuffix = subtitleText.mid(index + 1);
+                    kanji->lookup = terms ?
+                        terms->first()->lookup :
+                        SharedLookupContext(new LookupContext{subtitleText});
+                    kanji->matchOffset = index;
+                    kanji->matchLength = 1;
                     if (terms == nullptr)
                     {
                         m_lastEmittedIndex = index;
@@ -537,6 +642,7 @@ void SubtitleWidget::positionChanged(const double value)
         m_subtitle.rawText.clear();
         clearText();
         hide();
+        m_prefetcher->cancel();
         Q_EMIT GlobalMediator::getGlobalMediator()->subtitleExpired();
     }
 }
@@ -549,21 +655,35 @@ void SubtitleWidget::setSubtitle(QString subtitle,
                                  const double delay)
 {
     m_subtitle.rawText = subtitle;
-
-    /* Process the subtitle */
-    subtitle = subtitle.trimmed();
-    if (m_settings.replaceNewLines)
-    {
-        subtitle.replace('\n', m_settings.replaceStr);
-    }
+    subtitle = formatSubtitle(subtitle);
 
     /* Add it to the text edit */
     setText(subtitle);
 
+    /* Analyze the text once for every search on this subtitle */
+    if (subtitle.isEmpty())
+    {
+        m_analysis.text.clear();
+        m_analysis.future = QFuture<SharedTextAnalysis>();
+        m_prefetcher->cancel();
+    }
+    else if (m_analysis.text != getText())
+    {
+        Dictionary *dictionary = m_dictionary;
+        m_analysis.text = getText();
+        m_analysis.future = QtConcurrent::run(
+            [dictionary, text = m_analysis.text] {
+                return dictionary->analyzeText(text, MAX_QUERY_LENGTH);
+            }
+        );
+    }
+    prefetchTerms();
+
     /* Keep track of when to delete the subtitle */
     m_subtitle.startTime = start + delay;
     m_subtitle.endTime = end + delay;
     m_currentIndex = -1;
+    m_searchCancel.cancel();
 
     adjustVisibility();
 
@@ -571,6 +691,82 @@ void SubtitleWidget::setSubtitle(QString subtitle,
     m_pausedForCurrentSubtitle = false;
 }
 
+QString SubtitleWidget::formatSubtitle(QString subtitle) const
+{
+    subtitle = subtitle.trimmed();
+    if (m_settings.replaceNewLines)
+    {
+        subtitle.replace('\n', m_settings.replaceStr);
+    }
+    return subtitle;
+}
+
+void SubtitleWidget::prefetchTerms()
+{
+    const QString text = getText();
+    QList<EpisodeVocabulary::Word> words;
+    if (text.isEmpty() || !m_vocabulary->words(text, words))
+    {
+        m_prefetcher->prefetch(text, m_analysis.future);
+        return;
+    }
+
+    /* Longest words first, reading order breaks ties */
+    std::stable_sort(
+        std::begin(words), std::end(words),
+        [] (const EpisodeVocabulary::Word &lhs,
+            const EpisodeVocabulary::Word &rhs) -> bool
+        {
+            return lhs.length > rhs.length;
+        }
+    );
+
+    std::vector<int> positions;
+    QSet<int> searched;
+    for (const EpisodeVocabulary::Word &word : words)
+    {
+        positions.emplace_back(word.offset);
+        searched.insert(word.offset);
+    }
+    for (int i = 0; i < text.size(); ++i)
+    {
+        if (!searched.contains(i) && CharacterUtils::isKanji(text[i]))
+        {
+            positions.emplace_back(i);
+        }
+    }
+
+    /* Hovers over this subtitle are answered without searching */
+    if (positions.empty())
+    {
+        m_prefetcher->cancel();
+        return;
+    }
+    m_prefetcher->prefetch(text, m_analysis.future, std::move(positions));
+}
+
+void SubtitleWidget::setEpisode(const QStringList &lines)
+{
+    m_episodeLines = lines;
+    precomputeVocabulary();
+}
+
+void SubtitleWidget::precomputeVocabulary()
+{
+    if (!m_vocabulary->enabled() || m_episodeLines.isEmpty())
+    {
+        return;
+    }
+
+    QStringList lines;
+    lines.reserve(m_episodeLines.size());
+    for (const QString &line : m_episodeLines)
+    {
+        lines << formatSubtitle(line);
+    }
+    m_vocabulary->precompute(lines);
+}
+
 void SubtitleWidget::selectText()
 {
     StrokeLabel::selectText(m_lastEmittedIndex, m_lastEmittedSize);
@@ -23,10 +23,13 @@
 
 #include "gui/widgets/common/strokelabel.h"
 
+#include <QFuture>
 #include <QMouseEvent>
 #include <QTimer>
 
 #include "dict/dictionary.h"
+#include "dict/episodevocabulary.h"
+#include "dict/termprefetcher.h"
 
 /**
  * Widget used to display subtitle text and initiate searches.
@@ -127,16 +130,66 @@ private Q_SLOTS:
      */
     void selectText();
 
+    /**
+     * Precomputes the vocabulary of every line in the current episode.
+     * @param lines The lines of the primary subtitle track.
+     */
+    void setEpisode(const QStringList &lines);
+
+    /**
+     * Precomputes the vocabulary of m_episodeLines as they would be shown.
+     * Called when the lines or how they are shown changes.
+     */
+    void precomputeVocabulary();
+
 private:
+    /**
+     * Processes a subtitle the way it is shown in the widget.
+     * @param subtitle The subtitle text.
+     * @return The text shown for the subtitle.
+     */
+    [[nodiscard]]
+    QString formatSubtitle(QString subtitle) const;
+
+    /**
+     * Starts prefetching the current subtitle. If the episode vocabulary has
+     * the subtitle, only positions where a word or kanji starts are searched,
+     * longest words first.
+     */
+    void prefetchTerms();
+
     /* The dictionary object, used for query for terms. */
     Dictionary *m_dictionary;
 
     /* Timer object used for starting searches when hover is enabled. */
     QTimer *m_findDelay;
 
+    /* Contains the analysis of the current subtitle text. */
+    struct Analysis
+    {
+        /* The text being analyzed. */
+        QString text;
+
+        /* The analysis of the text. Started when the subtitle is set and
+         * shared by every search on the subtitle. */
+        QFuture<SharedTextAnalysis> future;
+    } m_analysis;
+
+    /* Searches the current subtitle in the background before it is hovered. */
+    TermPrefetcher *m_prefetcher;
+
+    /* The words of every line in the episode, looked up ahead of time. */
+    EpisodeVocabulary *m_vocabulary;
+
+    /* The unformatted lines of the current episode. */
+    QStringList m_episodeLines;
+
     /* The current index the cursor is over. -1 if not over anything. */
     int m_currentIndex;
 
+    /* Cancelled whenever the current index changes so stale searches stop. */
+    CancellationSource m_searchCancel;
+
     /* The index of the last emitted term list. */
     int m_lastEmittedIndex;
 
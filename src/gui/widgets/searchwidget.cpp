@@ -20,7 +20,9 @@
 
 #include "searchwidget.h"
 
+#include <QCheckBox>
 #include <QGuiApplication>
+#include <QHBoxLayout>
 #include <QSettings>
 #include <QThreadPool>
 #include <QVBoxLayout>
@@ -82,9 +84,16 @@ SearchWidget::SearchWidget(QWidget *parent)
 
     m_layoutParent = new QVBoxLayout(this);
 
+    QHBoxLayout *layoutSearch = new QHBoxLayout;
     m_searchEdit = new SearchEdit;
     m_searchEdit->setPlaceholderText("Search");
-    m_layoutParent->addWidget(m_searchEdit);
+    layoutSearch->addWidget(m_searchEdit);
+    m_checkMeaning = new QCheckBox("By meaning");
+    m_checkMeaning->setToolTip(
+        "Searches the definitions of terms instead of their headwords"
+    );
+    layoutSearch->addWidget(m_checkMeaning);
+    m_layoutParent->addLayout(layoutSearch);
 
     m_definition = new DefinitionWidget;
     m_definition->layout()->setContentsMargins(0, 0, 0, 0);
@@ -102,6 +111,16 @@ SearchWidget::SearchWidget(QWidget *parent)
         this, qOverload<const QString &, int>(&SearchWidget::updateSearch),
         Qt::QueuedConnection
     );
+    connect(
+        m_checkMeaning, &QCheckBox::toggled, this,
+        [this] (bool checked)
+        {
+            m_searchEdit->setPlaceholderText(
+                checked ? "Search by meaning" : "Search"
+            );
+            updateSearch(m_searchEdit->text());
+        }
+    );
     connect(
         this, &SearchWidget::searchUpdated,
         m_definition, &DefinitionWidget::setTerms,
@@ -174,11 +193,29 @@ void SearchWidget::updateSearch(const QString &text)
 
 void SearchWidget::updateSearch(const QString &text, const int index)
 {
+    m_searchCancel.cancel();
+    const CancellationToken token = m_searchCancel.token();
+    const bool byMeaning = m_checkMeaning->isChecked();
     QThreadPool::globalInstance()->start(
         [=] {
+            if (byMeaning)
+            {
+                SharedTermList terms =
+                    m_dictionary->searchGlossary(text, token);
+                if (!token.isCancelled())
+                {
+                    Q_EMIT searchUpdated(terms, nullptr);
+                }
+                return;
+            }
+
             const QString query = text.mid(index, MAX_SEARCH_SIZE);
             SharedTermList terms =
-                m_dictionary->searchTerms(query, text, index, &index);
+                m_dictionary->searchTerms(query, text, index, token);
+            if (token.isCancelled())
+            {
+                return;
+            }
 
             SharedKanji kanji = nullptr;
             if (!query.isEmpty() && CharacterUtils::isKanji(query[0]))
@@ -27,8 +27,11 @@
 #include <QSharedPointer>
 #include <QWheelEvent>
 
+#include "dict/cancellationtoken.h"
+
 class DefinitionWidget;
 class Dictionary;
+class QCheckBox;
 class QVBoxLayout;
 
 struct Term;
@@ -174,11 +177,17 @@ private:
     /* The search box */
     SearchEdit *m_searchEdit;
 
+    /* Checked to search definitions instead of headwords */
+    QCheckBox *m_checkMeaning;
+
     /* The definition widget */
     DefinitionWidget *m_definition;
 
     /* Pointer to the global dictionary */
     Dictionary *m_dictionary;
+
+    /* Cancelled whenever a new search starts so stale searches stop */
+    CancellationSource m_searchCancel;
 };
 
 #endif // SEARCHWIDGET_H
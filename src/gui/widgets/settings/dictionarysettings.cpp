@@ -41,6 +41,14 @@ DictionarySettings::DictionarySettings(QWidget *parent)
 
     initIcons();
 
+    m_ui->comboStorage->addItem(Constants::Settings::Database::Profile::DISK);
+    m_ui->comboStorage->addItem(
+        Constants::Settings::Database::Profile::MAPPED
+    );
+    m_ui->comboStorage->addItem(
+        Constants::Settings::Database::Profile::MEMORY
+    );
+
     connect(
         m_ui->buttonBox->button(QDialogButtonBox::StandardButton::Apply),
         &QPushButton::clicked,
@@ -137,6 +145,22 @@ void DictionarySettings::restoreSaved()
 
     setEnabled(false);
 
+    QSettings settings;
+    settings.beginGroup(Constants::Settings::Database::GROUP);
+    m_ui->comboStorage->setCurrentText(
+        settings.value(
+            Constants::Settings::Database::PROFILE,
+            Constants::Settings::Database::PROFILE_DEFAULT
+        ).toString()
+    );
+    m_ui->checkPack->setChecked(
+        settings.value(
+            Constants::Settings::Database::PACK,
+            Constants::Settings::Database::PACK_DEFAULT
+        ).toBool()
+    );
+    settings.endGroup();
+
     QThreadPool::globalInstance()->start(
         [this] {
             Dictionary *dict =
@@ -188,6 +212,17 @@ void DictionarySettings::applySettings()
     }
     settings.endGroup();
 
+    settings.beginGroup(Constants::Settings::Database::GROUP);
+    settings.setValue(
+        Constants::Settings::Database::PROFILE,
+        m_ui->comboStorage->currentText()
+    );
+    settings.setValue(
+        Constants::Settings::Database::PACK,
+        m_ui->checkPack->isChecked()
+    );
+    settings.endGroup();
+
     Dictionary *dict = GlobalMediator::getGlobalMediator()->getDictionary();
     dict->disableDictionaries(dictionaries);
 
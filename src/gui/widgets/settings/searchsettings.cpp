@@ -58,8 +58,18 @@ SearchSettings::SearchSettings(QWidget *parent)
         Constants::Settings::Search::Modifier::SUPER
     );
 
+    connect(
+        m_ui->checkPrefetch, &QCheckBox::toggled,
+        m_ui->framePrefetch, &QWidget::setEnabled
+    );
+    connect(
+        m_ui->checkVocabulary, &QCheckBox::toggled,
+        m_ui->frameVocabulary, &QWidget::setEnabled
+    );
+
 #ifndef MECAB_SUPPORT
     m_ui->checkMecabIpadic->setVisible(false);
+    m_ui->frameMecab->setVisible(false);
 #endif // MECAB_SUPPORT
 
     connect(
@@ -125,6 +135,18 @@ void SearchSettings::restoreSaved()
             Constants::Settings::Search::Matcher::MECAB_IPADIC_DEFAULT
         ).toBool()
     );
+    m_ui->spinMecabCandidates->setValue(
+        settings.value(
+            Constants::Settings::Search::Matcher::MECAB_MAX_CANDIDATES,
+            Constants::Settings::Search::Matcher::MECAB_MAX_CANDIDATES_DEFAULT
+        ).toInt()
+    );
+    m_ui->spinMecabPath->setValue(
+        settings.value(
+            Constants::Settings::Search::Matcher::MECAB_MAX_PATH,
+            Constants::Settings::Search::Matcher::MECAB_MAX_PATH_DEFAULT
+        ).toInt()
+    );
 #endif // MECAB_SUPPORT
 
     m_ui->spinLimitResults->setValue(
@@ -175,6 +197,38 @@ void SearchSettings::restoreSaved()
             Constants::Settings::Search::AUTO_PLAY_AUDIO_DEFAULT
         ).toBool()
     );
+    m_ui->checkPrefetch->setChecked(
+        settings.value(
+            Constants::Settings::Search::PREFETCH,
+            Constants::Settings::Search::PREFETCH_DEFAULT
+        ).toBool()
+    );
+    m_ui->spinPrefetchThreads->setValue(
+        settings.value(
+            Constants::Settings::Search::PREFETCH_THREADS,
+            Constants::Settings::Search::PREFETCH_THREADS_DEFAULT
+        ).toInt()
+    );
+    m_ui->spinPrefetchBudget->setValue(
+        settings.value(
+            Constants::Settings::Search::PREFETCH_BUDGET,
+            Constants::Settings::Search::PREFETCH_BUDGET_DEFAULT
+        ).toInt()
+    );
+    m_ui->framePrefetch->setEnabled(m_ui->checkPrefetch->isChecked());
+    m_ui->checkVocabulary->setChecked(
+        settings.value(
+            Constants::Settings::Search::VOCABULARY,
+            Constants::Settings::Search::VOCABULARY_DEFAULT
+        ).toBool()
+    );
+    m_ui->spinVocabularyThreads->setValue(
+        settings.value(
+            Constants::Settings::Search::VOCABULARY_THREADS,
+            Constants::Settings::Search::VOCABULARY_THREADS_DEFAULT
+        ).toInt()
+    );
+    m_ui->frameVocabulary->setEnabled(m_ui->checkVocabulary->isChecked());
     m_ui->checkReplaceNewLines->setChecked(
         settings.value(
             Constants::Settings::Search::REPLACE_LINES,
@@ -215,6 +269,12 @@ void SearchSettings::restoreDefaults()
     m_ui->checkMecabIpadic->setChecked(
         Constants::Settings::Search::Matcher::MECAB_IPADIC_DEFAULT
     );
+    m_ui->spinMecabCandidates->setValue(
+        Constants::Settings::Search::Matcher::MECAB_MAX_CANDIDATES_DEFAULT
+    );
+    m_ui->spinMecabPath->setValue(
+        Constants::Settings::Search::Matcher::MECAB_MAX_PATH_DEFAULT
+    );
 #endif // MECAB_SUPPORT
 
     m_ui->spinLimitResults->setValue(
@@ -239,6 +299,21 @@ void SearchSettings::restoreDefaults()
     m_ui->checkAutoPlayAudio->setChecked(
         Constants::Settings::Search::AUTO_PLAY_AUDIO_DEFAULT
     );
+    m_ui->checkPrefetch->setChecked(
+        Constants::Settings::Search::PREFETCH_DEFAULT
+    );
+    m_ui->spinPrefetchThreads->setValue(
+        Constants::Settings::Search::PREFETCH_THREADS_DEFAULT
+    );
+    m_ui->spinPrefetchBudget->setValue(
+        Constants::Settings::Search::PREFETCH_BUDGET_DEFAULT
+    );
+    m_ui->checkVocabulary->setChecked(
+        Constants::Settings::Search::VOCABULARY_DEFAULT
+    );
+    m_ui->spinVocabularyThreads->setValue(
+        Constants::Settings::Search::VOCABULARY_THREADS_DEFAULT
+    );
     m_ui->checkReplaceNewLines->setChecked(
         Constants::Settings::Search::REPLACE_LINES_DEFAULT
     );
@@ -271,6 +346,14 @@ void SearchSettings::applySettings()
         Constants::Settings::Search::Matcher::MECAB_IPADIC,
         m_ui->checkMecabIpadic->isChecked()
     );
+    settings.setValue(
+        Constants::Settings::Search::Matcher::MECAB_MAX_CANDIDATES,
+        m_ui->spinMecabCandidates->value()
+    );
+    settings.setValue(
+        Constants::Settings::Search::Matcher::MECAB_MAX_PATH,
+        m_ui->spinMecabPath->value()
+    );
 #endif // MECAB_SUPPORT
 
     settings.setValue(
@@ -305,6 +388,26 @@ void SearchSettings::applySettings()
         Constants::Settings::Search::AUTO_PLAY_AUDIO,
         m_ui->checkAutoPlayAudio->isChecked()
     );
+    settings.setValue(
+        Constants::Settings::Search::PREFETCH,
+        m_ui->checkPrefetch->isChecked()
+    );
+    settings.setValue(
+        Constants::Settings::Search::PREFETCH_THREADS,
+        m_ui->spinPrefetchThreads->value()
+    );
+    settings.setValue(
+        Constants::Settings::Search::PREFETCH_BUDGET,
+        m_ui->spinPrefetchBudget->value()
+    );
+    settings.setValue(
+        Constants::Settings::Search::VOCABULARY,
+        m_ui->checkVocabulary->isChecked()
+    );
+    settings.setValue(
+        Constants::Settings::Search::VOCABULARY_THREADS,
+        m_ui->spinVocabularyThreads->value()
+    );
     settings.setValue(
         Constants::Settings::Search::REPLACE_LINES,
         m_ui->checkReplaceNewLines->isChecked()
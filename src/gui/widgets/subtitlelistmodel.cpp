@@ -0,0 +1,407 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "subtitlelistmodel.h"
+
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <limits>
+
+#include "util/textnormalizer.h"
+
+#define COLUMN_COUNT 2
+
+/* The most runs of rows addSubtitles() inserts one by one before it resets
+ * the model instead */
+#define MAX_INSERT_RUNS 64
+
+/* Begin Helpers */
+
+/**
+ * Converts a time in seconds to a timecode string of the form HH:MM:SS.
+ * @param time The time in seconds.
+ * @returns A timecode fo the format HH:MM:SS.
+ */
+static QString formatTimecode(const int time)
+{
+    const int SECONDS_IN_HOUR = 3600;
+    const int SECONDS_IN_MINUTE = 60;
+
+    const int hours   = time / SECONDS_IN_HOUR;
+    const int minutes = (time % SECONDS_IN_HOUR) / SECONDS_IN_MINUTE;
+    const int seconds = time % SECONDS_IN_MINUTE;
+
+    QString timeStr("%1:%2:%3");
+    return timeStr.arg(hours,   2, 10, QLatin1Char('0'))
+                  .arg(minutes, 2, 10, QLatin1Char('0'))
+                  .arg(seconds, 2, 10, QLatin1Char('0'));
+}
+
+/**
+ * Orders rows by start time.
+ * @param lhs The left hand row.
+ * @param rhs The right hand row.
+ * @return true if lhs starts before rhs, false otherwise.
+ */
+static bool startsBefore(
+    const SubtitleListModel::Row &lhs,
+    const SubtitleListModel::Row &rhs)
+{
+    return lhs.info->start < rhs.info->start;
+}
+
+/* End Helpers */
+/* Begin Constructor */
+
+SubtitleListModel::SubtitleListModel(QObject *parent)
+    : QAbstractTableModel(parent) {}
+
+/* End Constructor */
+/* Begin Model Interface */
+
+int SubtitleListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_text.size();
+}
+
+int SubtitleListModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+QVariant SubtitleListModel::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid))
+    {
+        return QVariant();
+    }
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        if (index.column() == Column::Timecode)
+        {
+            const double time =
+                m_subtitles.at(index.row())->start + m_delay;
+            return formatTimecode(time < 0 ? 0 : time);
+        }
+        /* Every row is one line tall, longer lines are elided by the view */
+        return QString(m_text[index.row()]).replace('\n', ' ');
+
+    case Qt::ToolTipRole:
+        if (index.column() == Column::Subtitle)
+        {
+            return m_text[index.row()];
+        }
+        break;
+    }
+
+    return QVariant();
+}
+
+Qt::ItemFlags SubtitleListModel::flags(const QModelIndex &index) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid) ||
+        index.column() == Column::Timecode)
+    {
+        return Qt::NoItemFlags;
+    }
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+/* End Model Interface */
+/* Begin Accessors */
+
+const SubtitleIndex &SubtitleListModel::subtitles() const
+{
+    return m_subtitles;
+}
+
+const QString &SubtitleListModel::text(int row) const
+{
+    return m_text[row];
+}
+
+QList<int> SubtitleListModel::find(
+    const QString &text,
+    FindMode mode,
+    const QList<int> *within) const
+{
+    QList<int> rows;
+    if (text.isEmpty())
+    {
+        return rows;
+    }
+
+    QString literal = text;
+    QRegularExpression regex;
+    if (mode == FindMode::Regex)
+    {
+        regex = QRegularExpression(
+            text, QRegularExpression::CaseInsensitiveOption
+        );
+        if (!regex.isValid())
+        {
+            return rows;
+        }
+        literal = SubtitleSearchIndex::requiredLiteral(text);
+    }
+
+    /* Only rows that contain every bigram of the text are checked */
+    QList<int> candidates;
+    bool narrowed = true;
+    if (within)
+    {
+        candidates = *within;
+    }
+    else
+    {
+        if (!m_searchValid)
+        {
+            m_search.clear();
+            for (int i = 0; i < m_text.size(); ++i)
+            {
+                m_search.add(i, m_text[i]);
+            }
+            m_searchValid = true;
+        }
+        narrowed = m_search.candidates(literal, candidates);
+    }
+
+    const QString folded =
+        mode == FindMode::Kana ? TextNormalizer::fold(text) : QString();
+    const auto matches = [&] (int row)
+    {
+        switch (mode)
+        {
+        case FindMode::Plain:
+            return m_text[row].contains(text, Qt::CaseInsensitive);
+        case FindMode::Kana:
+            return TextNormalizer::fold(m_text[row]).contains(folded);
+        case FindMode::Regex:
+            return regex.match(m_text[row]).hasMatch();
+        }
+        return false;
+    };
+
+    if (narrowed)
+    {
+        for (int row : candidates)
+        {
+            if (matches(row))
+            {
+                rows.append(row);
+            }
+        }
+    }
+    else
+    {
+        for (int row = 0; row < m_text.size(); ++row)
+        {
+            if (matches(row))
+            {
+                rows.append(row);
+            }
+        }
+    }
+
+    return rows;
+}
+
+/* End Accessors */
+/* Begin Modifiers */
+
+int SubtitleListModel::addSubtitle(const Row &row)
+{
+    const int pos = m_subtitles.upperBound(row.info->start);
+    beginInsertRows(QModelIndex(), pos, pos);
+    m_subtitles.insert(row.info);
+    m_text.insert(pos, row.text);
+    endInsertRows();
+
+    /* Rows after this one moved, so the search index is stale */
+    if (pos != m_text.size() - 1)
+    {
+        m_searchValid = false;
+    }
+    else if (m_searchValid)
+    {
+        m_search.add(pos, row.text);
+    }
+
+    return pos;
+}
+
+void SubtitleListModel::addSubtitles(const std::vector<Row> &rows)
+{
+    if (rows.empty())
+    {
+        return;
+    }
+
+    std::vector<Row> added(rows);
+    if (!std::is_sorted(added.begin(), added.end(), startsBefore))
+    {
+        std::stable_sort(added.begin(), added.end(), startsBefore);
+    }
+
+    /* Parsed chunks mostly land after everything already in the list */
+    const int size = m_text.size();
+    if (size == 0 ||
+        m_subtitles.at(size - 1)->start <= added.front().info->start)
+    {
+        beginInsertRows(QModelIndex(), size, size + (int)added.size() - 1);
+        for (const Row &row : added)
+        {
+            m_subtitles.insert(row.info);
+            m_text.append(row.text);
+            if (m_searchValid)
+            {
+                m_search.add(m_text.size() - 1, row.text);
+            }
+        }
+        endInsertRows();
+        return;
+    }
+
+    /* Otherwise split the rows into runs that land between the same two rows.
+     * Inserting each run keeps the current row, selection and scroll position
+     * of views. */
+    struct Run
+    {
+        /* The position of the run before any rows were added */
+        int pos;
+
+        /* The range of the run in added */
+        size_t begin;
+        size_t end;
+    };
+    std::vector<Run> runs;
+    for (size_t i = 0; i < added.size() && runs.size() <= MAX_INSERT_RUNS; )
+    {
+        const int pos = m_subtitles.upperBound(added[i].info->start);
+        const double next = pos < size ?
+            m_subtitles.at(pos)->start : std::numeric_limits<double>::max();
+        size_t j = i + 1;
+        while (j < added.size() && added[j].info->start < next)
+        {
+            ++j;
+        }
+        runs.push_back({pos, i, j});
+        i = j;
+    }
+
+    if (runs.size() <= MAX_INSERT_RUNS)
+    {
+        int shift = 0;
+        for (const Run &run : runs)
+        {
+            const int pos = run.pos + shift;
+            const int count = run.end - run.begin;
+            std::vector<std::shared_ptr<const SubtitleInfo>> infos;
+            infos.reserve(count);
+            for (size_t i = run.begin; i < run.end; ++i)
+            {
+                infos.push_back(added[i].info);
+            }
+
+            beginInsertRows(QModelIndex(), pos, pos + count - 1);
+            m_subtitles.insert(pos, infos);
+            m_text.insert(pos, count, QString());
+            for (int i = 0; i < count; ++i)
+            {
+                m_text[pos + i] = added[run.begin + i].text;
+            }
+            endInsertRows();
+
+            shift += count;
+        }
+        m_searchValid = false;
+        return;
+    }
+
+    /* Cues are shuffled all over the file, so merge and rebuild instead of
+     * inserting that many runs */
+    std::vector<Row> merged;
+    merged.reserve(size + added.size());
+    for (int i = 0; i < size; ++i)
+    {
+        merged.push_back({m_subtitles.at(i), m_text[i]});
+    }
+    const auto middle = merged.insert(merged.end(), added.begin(), added.end());
+    std::inplace_merge(merged.begin(), middle, merged.end(), startsBefore);
+
+    beginResetModel();
+    m_subtitles.clear();
+    m_text.clear();
+    m_text.reserve(merged.size());
+    for (const Row &row : merged)
+    {
+        m_subtitles.insert(row.info);
+        m_text.append(row.text);
+    }
+    m_searchValid = false;
+    endResetModel();
+}
+
+void SubtitleListModel::setSubtitles(const std::vector<Row> &rows)
+{
+    beginResetModel();
+    m_subtitles.clear();
+    m_text.clear();
+    m_text.reserve(rows.size());
+    for (const Row &row : rows)
+    {
+        m_subtitles.insert(row.info);
+        m_text.append(row.text);
+    }
+    m_search.clear();
+    m_searchValid = m_text.isEmpty();
+    endResetModel();
+}
+
+void SubtitleListModel::setDelay(double delay)
+{
+    m_delay = delay;
+    if (!m_text.isEmpty())
+    {
+        Q_EMIT dataChanged(
+            index(0, Column::Timecode),
+            index(m_text.size() - 1, Column::Timecode),
+            {Qt::DisplayRole}
+        );
+    }
+}
+
+void SubtitleListModel::clear()
+{
+    beginResetModel();
+    m_subtitles.clear();
+    m_text.clear();
+    m_search.clear();
+    m_searchValid = true;
+    endResetModel();
+}
+
+/* End Modifiers */
+
+#undef COLUMN_COUNT
+#undef MAX_INSERT_RUNS
@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SUBTITLELISTMODEL_H
+#define SUBTITLELISTMODEL_H
+
+#include <QAbstractTableModel>
+
+#include <memory>
+#include <vector>
+
+#include "util/subtitleindex.h"
+#include "util/subtitlesearchindex.h"
+
+/**
+ * A table model of the subtitles in a subtitle list. Rows are sorted by start
+ * time. Nothing is stored per cell, timecodes and display text are built when
+ * the view asks for them, so only the rows on screen cost anything.
+ */
+class SubtitleListModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    /* The columns of the model */
+    enum Column
+    {
+        Timecode = 0,
+        Subtitle = 1
+    };
+
+    /* How find() matches text */
+    enum class FindMode
+    {
+        /* Case insensitive text */
+        Plain,
+
+        /* Case and kana insensitive text */
+        Kana,
+
+        /* Case insensitive regular expression */
+        Regex
+    };
+
+    /* A subtitle and the text shown for it */
+    struct Row
+    {
+        /* The subtitle */
+        std::shared_ptr<const SubtitleInfo> info;
+
+        /* The text shown in the list. May differ from the subtitle text if it
+         * was filtered. */
+        QString text;
+    };
+
+    SubtitleListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant data(
+        const QModelIndex &index,
+        int role = Qt::DisplayRole) const override;
+
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    /**
+     * Gets the subtitles in the model. Position i is row i.
+     * @return The index of subtitles in the model.
+     */
+    [[nodiscard]]
+    const SubtitleIndex &subtitles() const;
+
+    /**
+     * Gets the text shown for a row.
+     * @param row The row. Must be in range.
+     * @return The shown text with line breaks.
+     */
+    [[nodiscard]]
+    const QString &text(int row) const;
+
+    /**
+     * Finds the rows whose shown text contains a piece of text.
+     * @param text   The text or regular expression to search for.
+     * @param mode   How to match the text.
+     * @param within If not nullptr, only these rows are searched. Must be in
+     *               ascending order.
+     * @return The matching rows in ascending order. Empty if the regular
+     *         expression is invalid.
+     */
+    [[nodiscard]]
+    QList<int> find(
+        const QString &text,
+        FindMode mode,
+        const QList<int> *within = nullptr) const;
+
+    /**
+     * Adds a subtitle after every subtitle with the same start time.
+     * @param row The subtitle to add.
+     * @return The row the subtitle was added at.
+     */
+    int addSubtitle(const Row &row);
+
+    /**
+     * Adds many subtitles at once. Appending subtitles that start after the
+     * rest of the model is a single insert. Otherwise each run of subtitles
+     * that lands between the same two rows is inserted at once, unless there
+     * are so many runs that resetting the model is cheaper.
+     * @param rows The subtitles to add sorted by start time.
+     */
+    void addSubtitles(const std::vector<Row> &rows);
+
+    /**
+     * Replaces every subtitle in the model with a single reset, so views never
+     * see a partially filled model.
+     * @param rows The new subtitles sorted by start time.
+     */
+    void setSubtitles(const std::vector<Row> &rows);
+
+    /**
+     * Sets the delay added to the shown timecodes.
+     * @param delay The signed delay in seconds.
+     */
+    void setDelay(double delay);
+
+    /**
+     * Removes every subtitle from the model.
+     */
+    void clear();
+
+private:
+    /* The subtitles sorted by start time */
+    SubtitleIndex m_subtitles;
+
+    /* The text shown for each row */
+    QList<QString> m_text;
+
+    /* The delay added to timecodes */
+    double m_delay = 0.0;
+
+    /* Indexes the shown text of every row for find() */
+    mutable SubtitleSearchIndex m_search;
+
+    /* false if rows were inserted before the end of the model since the
+     * search index was built */
+    mutable bool m_searchValid = true;
+};
+
+#endif // SUBTITLELISTMODEL_H
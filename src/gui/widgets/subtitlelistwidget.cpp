@@ -21,23 +21,35 @@
 #include "subtitlelistwidget.h"
 #include "ui_subtitlelistwidget.h"
 
-#include <iterator>
 #include <QApplication>
 #include <QClipboard>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
 #include <QGuiApplication>
+#include <QHeaderView>
 #include <QMimeData>
-#include <QMultiMap>
 #include <QMutexLocker>
 #include <QSettings>
 #include <QShortcut>
 #include <QThreadPool>
+#include <QtConcurrent>
+#include <QUrl>
+
+#include <algorithm>
 
 #include "util/constants.h"
 #include "util/globalmediator.h"
 #include "util/iconfactory.h"
+#include "util/subtitlecache.h"
+#ifdef EMBEDDED_SUBTITLE_SUPPORT
+#include "util/subtitleextractor.h"
+#endif
 #include "util/subtitleparser.h"
 #include "util/utils.h"
 
+#include "subtitlelistmodel.h"
+
 /* Begin Private Class */
 
 /**
@@ -69,6 +81,9 @@ private:
 /* End Private Class */
 /* Begin Constructor/Destructors */
 
+/* Milliseconds to wait after a file loads before prefetching the next one */
+#define PREFETCH_DELAY 5000
+
 SubtitleListWidget::SubtitleListWidget(QWidget *parent)
     : QWidget(parent),
       m_ui(new Ui::SubtitleListWidget),
@@ -80,7 +95,23 @@ SubtitleListWidget::SubtitleListWidget(QWidget *parent)
     m_ui->tabWidget->tabBar()->setExpanding(true);
 
     m_primary.table = m_ui->tablePrim;
+    m_primary.model = new SubtitleListModel(this);
+    m_primary.table->setModel(m_primary.model);
     m_secondary.table = m_ui->tableSec;
+    m_secondary.model = new SubtitleListModel(this);
+    m_secondary.table->setModel(m_secondary.model);
+
+#ifdef EMBEDDED_SUBTITLE_SUPPORT
+    /* Extraction reads the whole file, so keep it out of playback's way */
+    m_extractPool.setMaxThreadCount(1);
+    m_extractPool.setThreadPriority(QThread::LowPriority);
+#endif
+
+    /* Prefetching only reads, but it shouldn't compete with playback */
+    m_prefetchPool.setMaxThreadCount(1);
+    m_prefetchPool.setThreadPriority(QThread::LowPriority);
+    m_prefetchTimer.setSingleShot(true);
+    m_prefetchTimer.setInterval(PREFETCH_DELAY);
 
     m_copyShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_C), this);
     m_copyAudioShortcut =
@@ -95,18 +126,13 @@ SubtitleListWidget::SubtitleListWidget(QWidget *parent)
 
     /* Signals */
     connect(
-        m_ui->tablePrim, &QTableWidget::itemDoubleClicked,
+        m_ui->tablePrim, &QTableView::doubleClicked,
         this,            &SubtitleListWidget::seekToPrimarySubtitle
     );
     connect(
-        m_ui->tableSec, &QTableWidget::itemDoubleClicked,
+        m_ui->tableSec, &QTableView::doubleClicked,
         this,           &SubtitleListWidget::seekToSecondarySubtitle
     );
-    connect(
-        m_ui->tabWidget, &QTabWidget::currentChanged,
-        this,            &SubtitleListWidget::fixTableDimensions,
-        Qt::QueuedConnection
-    );
 
     connect(
         mediator, &GlobalMediator::requestThemeRefresh,
@@ -149,11 +175,13 @@ SubtitleListWidget::SubtitleListWidget(QWidget *parent)
         this,     &SubtitleListWidget::clearPrimarySubtitles,
         Qt::QueuedConnection
     );
+#ifdef EMBEDDED_SUBTITLE_SUPPORT
     connect(
-        mediator, &GlobalMediator::searchSettingsChanged,
-        this,     &SubtitleListWidget::clearPrimarySubtitles,
+        mediator, &GlobalMediator::playerSubtitlesDisabled,
+        this,     &SubtitleListWidget::updateEmbeddedExtraction,
         Qt::QueuedConnection
     );
+#endif
 
     connect(
         mediator, &GlobalMediator::playerSecSubtitleChanged,
@@ -170,6 +198,13 @@ SubtitleListWidget::SubtitleListWidget(QWidget *parent)
         this,     &SubtitleListWidget::clearSecondarySubtitles,
         Qt::QueuedConnection
     );
+#ifdef EMBEDDED_SUBTITLE_SUPPORT
+    connect(
+        mediator, &GlobalMediator::playerSecondSubtitlesDisabled,
+        this,     &SubtitleListWidget::updateEmbeddedExtraction,
+        Qt::QueuedConnection
+    );
+#endif
     connect(
         mediator, &GlobalMediator::playerSecondSubtitleTrackChanged,
         this,     &SubtitleListWidget::showSecondarySubs,
@@ -190,6 +225,21 @@ SubtitleListWidget::SubtitleListWidget(QWidget *parent)
         this,     &SubtitleListWidget::handleTracklistChange
     );
 
+    connect(
+        mediator, &GlobalMediator::playerFileLoaded,
+        this,     &SubtitleListWidget::schedulePrefetch,
+        Qt::QueuedConnection
+    );
+    connect(
+        mediator, &GlobalMediator::playerPlaylistChanged,
+        this,     &SubtitleListWidget::schedulePrefetch,
+        Qt::QueuedConnection
+    );
+    connect(
+        &m_prefetchTimer, &QTimer::timeout,
+        this,             &SubtitleListWidget::prefetchNext
+    );
+
     connect(
         m_copyShortcut, &QShortcut::activated,
         this, &SubtitleListWidget::copyContext,
@@ -216,6 +266,15 @@ SubtitleListWidget::SubtitleListWidget(QWidget *parent)
         this, &SubtitleListWidget::findText,
         Qt::QueuedConnection
     );
+    for (QToolButton *button :
+            {m_ui->buttonSearchKana, m_ui->buttonSearchRegex})
+    {
+        connect(
+            button, &QToolButton::toggled, this,
+            [this] { findText(m_ui->lineEditSearch->text()); },
+            Qt::QueuedConnection
+        );
+    }
     connect(
         m_ui->buttonSearchPrev, &QToolButton::clicked,
         this, &SubtitleListWidget::findPrev,
@@ -232,9 +291,12 @@ SubtitleListWidget::SubtitleListWidget(QWidget *parent)
     );
 }
 
+#undef PREFETCH_DELAY
+
 SubtitleListWidget::~SubtitleListWidget()
 {
     disconnect();
+    m_prefetchSource.cancel();
     clearCachedSubtitles();
     delete m_ui;
 }
@@ -252,10 +314,12 @@ void SubtitleListWidget::initTheme()
         ).toBool();
     if (customStylesheets)
     {
+        /* The list used to be a QTableWidget, so older stylesheets still
+         * select it by that name */
         setStyleSheet(settings.value(
                 Constants::Settings::Interface::Style::SUBTITLE_LIST,
                 Constants::Settings::Interface::Style::SUBTITLE_LIST_DEFAULT
-            ).toString()
+            ).toString().replace("QTableWidget", "QTableView")
         );
     }
     else
@@ -273,6 +337,8 @@ void SubtitleListWidget::initTheme()
     m_ui->tableSec->setColumnHidden (0, showTimestamps);
     settings.endGroup();
 
+    initRowHeights();
+
     /* Update the FindWidget icons */
     IconFactory *icons = IconFactory::create();
     m_ui->buttonSearchPrev->setIcon(icons->getIcon(IconFactory::Icon::up));
@@ -284,16 +350,23 @@ void SubtitleListWidget::initRegex()
 {
     QSettings settings;
     settings.beginGroup(Constants::Settings::Search::GROUP);
-    m_subRegexLock.lock();
-    m_subRegex.setPattern(
-        settings.value(
+    const QString pattern = settings.value(
             Constants::Settings::Search::REMOVE_REGEX,
             Constants::Settings::Search::REMOVE_REGEX_DEFAULT
-        ).toString()
-    );
-    m_subRegexLock.unlock();
+        ).toString();
     settings.endGroup();
 
+    /* Other search settings share the signal, so only a new pattern throws
+     * away the filtered tracks */
+    m_subRegexLock.lock();
+    if (pattern != m_subRegex.pattern())
+    {
+        m_subRegex.setPattern(pattern);
+        ++m_subRegexGeneration;
+        m_subtitleFiltered.clear();
+    }
+    m_subRegexLock.unlock();
+
     PlayerAdapter *player =
         GlobalMediator::getGlobalMediator()->getPlayerAdapter();
     if (player)
@@ -307,6 +380,23 @@ void SubtitleListWidget::initRegex()
     }
 }
 
+#define ROW_PADDING 4
+
+void SubtitleListWidget::initRowHeights()
+{
+    /* Every row is one line tall so the view never has to measure rows */
+    for (QTableView *table : {m_ui->tablePrim, m_ui->tableSec})
+    {
+        const int height = table->fontMetrics().height() + ROW_PADDING;
+        QHeaderView *header = table->verticalHeader();
+        header->setSectionResizeMode(QHeaderView::Fixed);
+        header->setMinimumSectionSize(height);
+        header->setDefaultSectionSize(height);
+    }
+}
+
+#undef ROW_PADDING
+
 /* End Initializers */
 /* Begin Event Handlers */
 
@@ -314,10 +404,9 @@ void SubtitleListWidget::showEvent(QShowEvent *event)
 {
     QWidget::showEvent(event);
 
-    m_ui->tablePrim->scrollToItem(m_ui->tablePrim->currentItem());
-    m_ui->tableSec->scrollToItem(m_ui->tableSec->currentItem());
-    m_ui->tablePrim->resizeRowsToContents();
-    m_ui->tableSec->resizeRowsToContents();
+    initRowHeights();
+    m_ui->tablePrim->scrollTo(m_ui->tablePrim->currentIndex());
+    m_ui->tableSec->scrollTo(m_ui->tableSec->currentIndex());
 
     Q_EMIT widgetShown();
 }
@@ -326,31 +415,60 @@ void SubtitleListWidget::hideEvent(QHideEvent *event)
 {
     QWidget::hideEvent(event);
 
-    QList<QTableWidgetItem *> items = m_ui->tablePrim->selectedItems();
-    if (!items.isEmpty())
-    {
-        m_ui->tablePrim->scrollToItem(items.last());
-    }
-
-    items = m_ui->tableSec->selectedItems();
-    if (!items.isEmpty())
+    for (const SubtitleList *list : {&m_primary, &m_secondary})
     {
-        m_ui->tableSec->scrollToItem(items.last());
+        const QList<int> rows = getSelectedRows(*list);
+        if (!rows.isEmpty())
+        {
+            list->table->scrollTo(
+                list->model->index(rows.last(), SubtitleListModel::Subtitle)
+            );
+        }
     }
 
     Q_EMIT widgetHidden();
 }
 
-void SubtitleListWidget::resizeEvent(QResizeEvent *event)
-{
-    QWidget::resizeEvent(event);
-    m_ui->tablePrim->resizeRowsToContents();
-    m_ui->tableSec->resizeRowsToContents();
-}
-
 /* End Event Handlers */
 /* Begin Adder Methods */
 
+/**
+ * Loads a subtitle file. Files that were opened before come from the subtitle
+ * cache, anything else is parsed and added to it.
+ * @param path    The path of the subtitle file.
+ * @param handler Called with the subtitles as they are loaded. May be empty.
+ * @return The subtitles in the file.
+ */
+static QList<SubtitleInfo> loadSubtitleFile(
+    const QString &path,
+    const SubtitleParser::ChunkHandler &handler =
+        SubtitleParser::ChunkHandler())
+{
+    SubtitleCache cache(DirectoryUtils::getSubtitleCacheDir());
+    const QString key = cache.key(path);
+    QList<SubtitleInfo> subtitles;
+    if (!key.isEmpty() && cache.load(key, subtitles))
+    {
+        if (handler)
+        {
+            handler(subtitles);
+        }
+        return subtitles;
+    }
+
+    SubtitleParser parser;
+    subtitles = parser.parseSubtitles(path, handler);
+    if (!key.isEmpty() && !subtitles.isEmpty())
+    {
+        QString err = cache.save(key, subtitles);
+        if (!err.isEmpty())
+        {
+            qDebug() << err;
+        }
+    }
+    return subtitles;
+}
+
 void SubtitleListWidget::handleTracklistChange(
     const QList<const Track *> &tracks)
 {
@@ -382,38 +500,43 @@ void SubtitleListWidget::handleTracklistChange(
         }
     }
 
-    QThreadPool::globalInstance()->start([=] {
-        SubtitleParser parser;
+    /* Every track is parsed by its own task. Chunks are handed back to the
+     * GUI thread as they finish, so nothing here holds the list locks while
+     * parsing. */
+    bool refresh = false;
+    for (int i = 0; i < extTracks.size(); ++i)
+    {
+        const int64_t sid = extSids[i];
+        if (!claimTrack(sid, refresh))
+        {
+            continue;
+        }
 
-        m_primary.lock.lock();
-        m_secondary.lock.lock();
+        const QString path = extTracks[i];
+        const int generation = m_parseGeneration;
 
-        for (int i = 0; i < extTracks.size(); ++i)
+        /* Files prefetched while the last file played are ready to go */
+        auto it = m_prefetched.find(QFileInfo(path).absoluteFilePath());
+        if (it != m_prefetched.end())
         {
-            if (!m_subtitleMap.contains(extSids[i]))
-            {
-                m_subtitleMap[extSids[i]] = std::make_shared<
-                    std::vector<std::shared_ptr<SubtitleInfo>>>();
-                m_subtitleParsed[extSids[i]] = std::make_shared<bool>(false);
-            }
-            QList<SubtitleInfo> subtitles = parser.parseSubtitles(extTracks[i]);
-            std::transform(
-                std::begin(subtitles), std::end(subtitles),
-                std::back_inserter(*m_subtitleMap[extSids[i]]),
-                [] (SubtitleInfo &info)
-                {
-                    return std::make_shared<SubtitleInfo>(info);
-                }
-            );
-            *m_subtitleParsed[extSids[i]] =
-                !m_subtitleMap[extSids[i]]->empty();
+            const PrefetchedSubtitles prefetched = it.value();
+            m_prefetched.erase(it);
+            addParsedSubtitles(generation, sid, prefetched.subtitles, true);
+            finishParsedSubtitles(generation, sid, true);
+            m_subtitleFiltered[sid] = prefetched.filtered;
+            continue;
         }
 
-        m_secondary.lock.unlock();
-        m_primary.lock.unlock();
-
+        QThreadPool::globalInstance()->start([=] {
+            const QList<SubtitleInfo> subtitles =
+                loadSubtitleFile(path, postChunkHandler(generation, sid));
+            postFinished(generation, sid, !subtitles.isEmpty());
+        });
+    }
+    if (refresh)
+    {
         Q_EMIT requestRefresh();
-    });
+    }
 
     if (primarySid != -1)
     {
@@ -442,76 +565,163 @@ void SubtitleListWidget::handleRefresh()
     }
 }
 
-QString SubtitleListWidget::formatTimecode(const int time)
+int SubtitleListWidget::addRow(
+    SubtitleList &list,
+    const std::shared_ptr<SubtitleInfo> &info,
+    bool regex)
 {
-    const int SECONDS_IN_HOUR = 3600;
-    const int SECONDS_IN_MINUTE = 60;
-
-    const int hours   = time / SECONDS_IN_HOUR;
-    const int minutes = (time % SECONDS_IN_HOUR) / SECONDS_IN_MINUTE;
-    const int seconds = time % SECONDS_IN_MINUTE;
+    QString text = info->text;
+    if (regex && text.remove(m_subRegex).isEmpty())
+    {
+        return -1;
+    }
 
-    QString timeStr("%1:%2:%3");
-    return timeStr.arg(hours,   2, 10, QLatin1Char('0'))
-                  .arg(minutes, 2, 10, QLatin1Char('0'))
-                  .arg(seconds, 2, 10, QLatin1Char('0'));
+    /* Subtitles that start at the same time are assumed to have been added
+     * in order, so the new one goes after the others */
+    list.modified = true;
+    return list.model->addSubtitle({info, text});
 }
 
-QTableWidgetItem *SubtitleListWidget::addTableItem(
+void SubtitleListWidget::addRows(
     SubtitleList &list,
-    const std::shared_ptr<SubtitleInfo> &info,
-    double delay,
+    const std::vector<std::shared_ptr<SubtitleInfo>> &subtitles,
     bool regex)
 {
-    QTableWidgetItem *subtitleItem;
-    if (regex)
+    std::vector<SubtitleListModel::Row> rows;
+    rows.reserve(subtitles.size());
+    for (const std::shared_ptr<SubtitleInfo> &info : subtitles)
     {
-        QString text = QString(info->text).remove(m_subRegex);
-        if (text.isEmpty())
+        QString text = info->text;
+        if (regex && text.remove(m_subRegex).isEmpty())
         {
-            return nullptr;
+            continue;
         }
-        subtitleItem = new QTableWidgetItem(text);
+        rows.push_back({info, text});
     }
-    else
+    list.model->addSubtitles(rows);
+    list.modified = true;
+}
+
+/**
+ * Filters subtitles with a regular expression. Subtitles are filtered in
+ * parallel on the global thread pool, with the calling thread helping out.
+ * @param subtitles The subtitles to filter.
+ * @param regex     The regular expression to remove from the text.
+ * @return The subtitles with text left after filtering sorted by start time.
+ */
+static std::vector<SubtitleListModel::Row> filterSubtitles(
+    const std::vector<std::shared_ptr<SubtitleInfo>> &subtitles,
+    const QRegularExpression &regex)
+{
+    const std::vector<QString> texts =
+        QtConcurrent::blockingMapped<std::vector<QString>>(
+            subtitles,
+            [&regex] (const std::shared_ptr<SubtitleInfo> &info)
+            {
+                return QString(info->text).remove(regex);
+            }
+        );
+
+    std::vector<SubtitleListModel::Row> rows;
+    rows.reserve(subtitles.size());
+    for (size_t i = 0; i < subtitles.size(); ++i)
     {
-        subtitleItem = new QTableWidgetItem(info->text);
+        if (!texts[i].isEmpty())
+        {
+            rows.push_back({subtitles[i], texts[i]});
+        }
     }
-    list.itemToSub.insert(subtitleItem, info);
-    QStringList lines = info->text.split('\n');
-    for (const QString &line : lines)
+    std::stable_sort(rows.begin(), rows.end(),
+        [] (const SubtitleListModel::Row &lhs,
+            const SubtitleListModel::Row &rhs)
+        {
+            return lhs.info->start < rhs.info->start;
+        }
+    );
+    return rows;
+}
+
+void SubtitleListWidget::refilterSubtitles(int64_t sid)
+{
+    if (!m_subtitleMap.contains(sid) || m_subtitleFiltering.contains(sid))
     {
-        list.lineToItem.insert(line, subtitleItem);
+        return;
     }
-    auto endIt = list.startToItem.insert(info->start, subtitleItem);
+    m_subtitleFiltering << sid;
 
-    /* This is a bit of a hack to get the subtitles to appear in order.
-     * If a subtitle starts at the same start time as another, the subtitle
-     * that appears later will be closer to seenSubs.begin() than the
-     * earlier subtitle. To get around this, we assume the subtitle being
-     * added came after all subtitles with the same start time. This isn't
-     * going to work 100% of the time, but it's right enough of the time to
-     * be worth it.
-     */
-    size_t i = std::distance(list.startToItem.begin(), endIt);
-    for (++endIt;
-         endIt != list.startToItem.end() && endIt.key() == info->start;
-         ++endIt)
+    /* The worker gets its own copy of the track, new chunks are added to the
+     * track while it runs */
+    std::shared_ptr<std::vector<std::shared_ptr<SubtitleInfo>>> subList =
+        m_subtitleMap[sid];
+    const std::vector<std::shared_ptr<SubtitleInfo>> subtitles = *subList;
+    m_subRegexLock.lock();
+    const QRegularExpression regex = m_subRegex;
+    m_subRegexLock.unlock();
+    const int generation = m_subRegexGeneration;
+
+    QThreadPool::globalInstance()->start([=] {
+        std::shared_ptr<FilteredSubtitles> filtered =
+            std::make_shared<FilteredSubtitles>();
+        filtered->generation = generation;
+        filtered->sourceSize = subtitles.size();
+        filtered->rows = filterSubtitles(subtitles, regex);
+        QMetaObject::invokeMethod(
+            this,
+            [=] { finishRefilter(sid, subList, filtered); },
+            Qt::QueuedConnection
+        );
+    });
+}
+
+void SubtitleListWidget::finishRefilter(
+    int64_t sid,
+    std::shared_ptr<std::vector<std::shared_ptr<SubtitleInfo>>> subList,
+    std::shared_ptr<const FilteredSubtitles> filtered)
+{
+    m_subtitleFiltering.remove(sid);
+    if (m_subtitleMap.value(sid) != subList)
     {
-        ++i;
+        return;
     }
 
-    QTableWidgetItem *timecodeItem =
-        new QTableWidgetItem(formatTimecode(info->start + delay));
-    timecodeItem->setFlags(Qt::NoItemFlags);
+    QMutexLocker locker(&m_primary.lock);
+    const bool shown = m_primary.subList == subList;
 
-    list.table->insertRow(i);
-    list.table->setItem(i, 1, subtitleItem);
-    list.table->setItem(i, 0, timecodeItem);
-    list.table->resizeRowToContents(i);
-    list.modified = true;
+    /* The regex or the track changed while filtering */
+    if (filtered->generation != m_subRegexGeneration ||
+        filtered->sourceSize != subList->size())
+    {
+        if (shown)
+        {
+            refilterSubtitles(sid);
+        }
+        return;
+    }
 
-    return subtitleItem;
+    m_subtitleFiltered[sid] = filtered;
+    if (shown)
+    {
+        m_primary.model->setSubtitles(filtered->rows);
+        m_primary.modified = true;
+        emitPrimaryLoaded();
+    }
+}
+
+void SubtitleListWidget::emitPrimaryLoaded()
+{
+    if (!m_primary.subsParsed || !*m_primary.subsParsed)
+    {
+        return;
+    }
+
+    const SubtitleListModel *model = m_primary.model;
+    QStringList lines;
+    lines.reserve(model->rowCount());
+    for (int i = 0; i < model->rowCount(); ++i)
+    {
+        lines << model->text(i);
+    }
+    Q_EMIT GlobalMediator::getGlobalMediator()->subtitleListLoaded(lines);
 }
 
 #define TIME_DELTA 0.0001
@@ -521,22 +731,22 @@ void SubtitleListWidget::addSubtitle(
     const QString &subtitle,
     const double start,
     const double end,
-    const double delay,
     const bool regex)
 {
     /* Check if we have already seen this subtitle. Finds it if we have. */
-    auto it = list.startToItem.lowerBound(start - TIME_DELTA);
-    while (it != list.startToItem.end() && it.key() - start <= TIME_DELTA)
+    const SubtitleIndex &index = list.model->subtitles();
+    qsizetype i = index.lowerBound(start - TIME_DELTA);
+    while (i < index.size() && index.at(i)->start - start <= TIME_DELTA)
     {
-        if ((*it)->text() == subtitle)
+        if (index.at(i)->text == subtitle)
         {
             break;
         }
-        ++it;
+        ++i;
     }
 
-    QTableWidgetItem *subtitleItem = nullptr;
-    if (it == list.startToItem.end() || it.key() - start > TIME_DELTA)
+    int row = -1;
+    if (i == index.size() || index.at(i)->start - start > TIME_DELTA)
     {
         std::shared_ptr<SubtitleInfo> info = std::make_shared<SubtitleInfo>();
         info->text = subtitle;
@@ -548,7 +758,7 @@ void SubtitleListWidget::addSubtitle(
         {
             m_subRegexLock.lock();
         }
-        subtitleItem = addTableItem(list, list.subList->back(), delay, regex);
+        row = addRow(list, list.subList->back(), regex);
         if (regex)
         {
             m_subRegexLock.unlock();
@@ -556,15 +766,281 @@ void SubtitleListWidget::addSubtitle(
     }
     else
     {
-        subtitleItem = *it;
+        row = i;
     }
 
     list.table->clearSelection();
-    list.table->setCurrentItem(subtitleItem);
+    if (row != -1)
+    {
+        list.table->setCurrentIndex(
+            list.model->index(row, SubtitleListModel::Subtitle)
+        );
+    }
 }
 
 #undef TIME_DELTA
 
+bool SubtitleListWidget::claimTrack(int64_t sid, bool &refresh)
+{
+    if (!m_subtitleMap.contains(sid))
+    {
+        m_subtitleMap[sid] =
+            std::make_shared<std::vector<std::shared_ptr<SubtitleInfo>>>();
+        m_subtitleParsed[sid] = std::make_shared<bool>(false);
+    }
+    else if (m_subtitleParsing.contains(sid))
+    {
+        return false;
+    }
+    else if (*m_subtitleParsed[sid])
+    {
+        /* Already parsed, but the lists may have been cleared since */
+        refresh = true;
+        return false;
+    }
+    m_subtitleParsing << sid;
+    return true;
+}
+
+SubtitleParser::ChunkHandler SubtitleListWidget::postChunkHandler(
+    int generation,
+    int64_t sid,
+    const CancellationToken &token)
+{
+    std::shared_ptr<bool> first = std::make_shared<bool>(true);
+    return [=] (const QList<SubtitleInfo> &chunk)
+    {
+        std::vector<std::shared_ptr<SubtitleInfo>> infos;
+        infos.reserve(chunk.size());
+        for (const SubtitleInfo &info : chunk)
+        {
+            infos.emplace_back(std::make_shared<SubtitleInfo>(info));
+        }
+
+        /* Checked on the GUI thread since that's where tokens are cancelled */
+        const bool isFirst = *first;
+        QMetaObject::invokeMethod(
+            this,
+            [=] {
+                if (!token.isCancelled())
+                {
+                    addParsedSubtitles(generation, sid, infos, isFirst);
+                }
+            },
+            Qt::QueuedConnection
+        );
+        *first = false;
+    };
+}
+
+void SubtitleListWidget::postFinished(
+    int generation,
+    int64_t sid,
+    bool ok,
+    const CancellationToken &token)
+{
+    QMetaObject::invokeMethod(
+        this,
+        [=] {
+            if (!token.isCancelled())
+            {
+                finishParsedSubtitles(generation, sid, ok);
+            }
+        },
+        Qt::QueuedConnection
+    );
+}
+
+#ifdef EMBEDDED_SUBTITLE_SUPPORT
+void SubtitleListWidget::updateEmbeddedExtraction()
+{
+    PlayerAdapter *player =
+        GlobalMediator::getGlobalMediator()->getPlayerAdapter();
+    const int64_t primarySid = player->getSubtitleTrack();
+    const int64_t secondarySid = player->getSecondarySubtitleTrack();
+
+    QList<int64_t> sids;
+    QList<int64_t> indices;
+    QList<const Track *> tracks = player->getTracks();
+    for (const Track *track : tracks)
+    {
+        if (track->type == Track::subtitle &&
+            !track->external &&
+            track->ffIndex >= 0 &&
+            (track->id == primarySid || track->id == secondarySid))
+        {
+            sids << track->id;
+            indices << track->ffIndex;
+        }
+        delete track;
+    }
+
+    /* The track handlers already show whatever was extracted before, so
+     * there is nothing to refresh */
+    bool refresh = false;
+    extractEmbeddedSubtitles(sids, indices, refresh);
+}
+
+void SubtitleListWidget::extractEmbeddedSubtitles(
+    const QList<int64_t> &sids,
+    const QList<int64_t> &indices,
+    bool &refresh)
+{
+    /* Stop extracting tracks that are no longer selected. Whatever was read
+     * stays, and the player fills in the rest. */
+    for (auto it = m_subtitleExtractions.begin();
+         it != m_subtitleExtractions.end(); )
+    {
+        if (sids.contains(it.key()))
+        {
+            ++it;
+            continue;
+        }
+        it->cancel();
+        m_subtitleParsing.remove(it.key());
+        if (m_subtitleParsed.contains(it.key()))
+        {
+            *m_subtitleParsed[it.key()] = false;
+        }
+        it = m_subtitleExtractions.erase(it);
+    }
+
+    if (sids.isEmpty())
+    {
+        return;
+    }
+
+    /* Streams would have to be downloaded in full, so only extract from
+     * local files */
+    const QString file =
+        GlobalMediator::getGlobalMediator()->getPlayerAdapter()->getPath();
+    const QUrl url(file);
+    const QString path = url.isLocalFile() ? url.toLocalFile() : file;
+    if (!QFileInfo::exists(path))
+    {
+        return;
+    }
+
+    for (int i = 0; i < sids.size(); ++i)
+    {
+        const int64_t sid = sids[i];
+        if (!claimTrack(sid, refresh))
+        {
+            continue;
+        }
+
+        CancellationSource source;
+        m_subtitleExtractions.insert(sid, source);
+
+        const CancellationToken token = source.token();
+        const int ffIndex = indices[i];
+        const int generation = m_parseGeneration;
+        m_extractPool.start([=] {
+            const QList<SubtitleInfo> subtitles = SubtitleExtractor::extract(
+                path, ffIndex, token, postChunkHandler(generation, sid, token)
+            );
+            postFinished(generation, sid, !subtitles.isEmpty(), token);
+        });
+    }
+}
+#endif // EMBEDDED_SUBTITLE_SUPPORT
+
+void SubtitleListWidget::addParsedSubtitles(
+    int generation,
+    int64_t sid,
+    const std::vector<std::shared_ptr<SubtitleInfo>> &subtitles,
+    bool first)
+{
+    if (generation != m_parseGeneration || !m_subtitleMap.contains(sid))
+    {
+        return;
+    }
+
+    /* The first chunk replaces anything added from the player while the file
+     * was being opened. Once the start of the file is in, the rest is
+     * treated as parsed so the player stops adding lines of its own. */
+    std::shared_ptr<std::vector<std::shared_ptr<SubtitleInfo>>> subList =
+        m_subtitleMap[sid];
+    m_subtitleFiltered.remove(sid);
+    if (first)
+    {
+        subList->clear();
+        *m_subtitleParsed[sid] = true;
+    }
+    subList->insert(subList->end(), subtitles.begin(), subtitles.end());
+
+    for (SubtitleList *list : {&m_primary, &m_secondary})
+    {
+        QMutexLocker locker(&list->lock);
+        if (list->subList != subList)
+        {
+            continue;
+        }
+
+        const bool regex = list == &m_primary;
+        if (regex)
+        {
+            m_subRegexLock.lock();
+        }
+        if (first)
+        {
+            std::shared_ptr<bool> subsParsed = list->subsParsed;
+            clearSubtitles(*list);
+            list->subList = subList;
+            list->subsParsed = subsParsed;
+        }
+        addRows(*list, subtitles, regex);
+        if (regex)
+        {
+            m_subRegexLock.unlock();
+        }
+    }
+}
+
+void SubtitleListWidget::finishParsedSubtitles(
+    int generation,
+    int64_t sid,
+    bool ok)
+{
+    if (generation != m_parseGeneration)
+    {
+        return;
+    }
+    m_subtitleParsing.remove(sid);
+#ifdef EMBEDDED_SUBTITLE_SUPPORT
+    m_subtitleExtractions.remove(sid);
+#endif
+    if (!m_subtitleMap.contains(sid))
+    {
+        return;
+    }
+
+    /* Chunks arrive in file order and are each sorted, so this only has to
+     * interleave the edges of neighbouring chunks. A file that failed part
+     * way through keeps the chunks before the error, and the player fills in
+     * the rest. */
+    std::shared_ptr<std::vector<std::shared_ptr<SubtitleInfo>>> subList =
+        m_subtitleMap[sid];
+    std::stable_sort(subList->begin(), subList->end(),
+        [] (const std::shared_ptr<SubtitleInfo> &lhs,
+            const std::shared_ptr<SubtitleInfo> &rhs)
+        {
+            return lhs->start < rhs->start;
+        }
+    );
+    *m_subtitleParsed[sid] = ok && !subList->empty();
+
+    /* A running refilter emits once its rows are in */
+    QMutexLocker locker(&m_primary.lock);
+    if (m_primary.subList == subList && !m_subtitleFiltering.contains(sid))
+    {
+        emitPrimaryLoaded();
+    }
+}
+
+/* Tracks at least this long are filtered on the thread pool */
+#define PARALLEL_FILTER_SIZE 1000
+
 void SubtitleListWidget::handlePrimaryTrackChange(int64_t sid)
 {
     m_primary.lock.lock();
@@ -580,18 +1056,47 @@ void SubtitleListWidget::handlePrimaryTrackChange(int64_t sid)
     m_primary.subList = m_subtitleMap[sid];
     m_primary.subsParsed = m_subtitleParsed[sid];
 
-    double delay =
-        GlobalMediator::getGlobalMediator()->getPlayerAdapter()->getSubDelay();
-    m_subRegexLock.lock();
-    for (const auto &info : *m_primary.subList)
+    m_primary.model->setDelay(
+        GlobalMediator::getGlobalMediator()->getPlayerAdapter()->getSubDelay()
+    );
+
+    /* Tracks filtered since the last regex change are swapped in as is.
+     * Large parsed tracks are filtered off the GUI thread and show up once
+     * they're done. Tracks filled in by the player aren't, since the player
+     * would add its lines again while the list is empty. */
+    std::shared_ptr<const FilteredSubtitles> filtered =
+        m_subtitleFiltered.value(sid);
+    if (filtered && filtered->generation == m_subRegexGeneration &&
+        filtered->sourceSize == m_primary.subList->size())
     {
-        addTableItem(m_primary, info, delay, true);
+        m_primary.model->setSubtitles(filtered->rows);
+        m_primary.modified = true;
+    }
+    else if (*m_primary.subsParsed &&
+             m_primary.subList->size() >= PARALLEL_FILTER_SIZE)
+    {
+        refilterSubtitles(sid);
+    }
+    else
+    {
+        m_subRegexLock.lock();
+        addRows(m_primary, *m_primary.subList, true);
+        m_subRegexLock.unlock();
+    }
+    if (!m_subtitleFiltering.contains(sid))
+    {
+        emitPrimaryLoaded();
     }
-    m_subRegexLock.unlock();
 
     m_primary.lock.unlock();
+
+#ifdef EMBEDDED_SUBTITLE_SUPPORT
+    updateEmbeddedExtraction();
+#endif
 }
 
+#undef PARALLEL_FILTER_SIZE
+
 void SubtitleListWidget::handleSecondaryTrackChange(int64_t sid)
 {
     m_secondary.lock.lock();
@@ -607,14 +1112,16 @@ void SubtitleListWidget::handleSecondaryTrackChange(int64_t sid)
     m_secondary.subList = m_subtitleMap[sid];
     m_secondary.subsParsed = m_subtitleParsed[sid];
 
-    double delay =
-        GlobalMediator::getGlobalMediator()->getPlayerAdapter()->getSubDelay();
-    for (const auto &info : *m_secondary.subList)
-    {
-        addTableItem(m_secondary, info, delay);
-    }
+    m_secondary.model->setDelay(
+        GlobalMediator::getGlobalMediator()->getPlayerAdapter()->getSubDelay()
+    );
+    addRows(m_secondary, *m_secondary.subList);
 
     m_secondary.lock.unlock();
+
+#ifdef EMBEDDED_SUBTITLE_SUPPORT
+    updateEmbeddedExtraction();
+#endif
 }
 
 #define TIME_DELTA 0.001
@@ -629,30 +1136,39 @@ void SubtitleListWidget::selectSubtitles(SubtitleList &list,
 
     list.table->clearSelection();
 
+    /* Overlapping cues are shown together, so select every cue on screen
+     * that has a line in the subtitle */
     QList<int> rows;
-    QStringList lines = subtitle.split('\n');
-    for (const QString &line : lines)
+    const QStringList lines = subtitle.split('\n');
+    const SubtitleIndex &index = list.model->subtitles();
+    const QList<qsizetype> shown =
+        index.overlapping(time - TIME_DELTA, time + TIME_DELTA);
+    for (qsizetype i : shown)
     {
-        QList<QTableWidgetItem *> items = list.lineToItem.values(line);
-        for (QTableWidgetItem *item : items)
+        const QList<QStringView> cueLines =
+            QStringView(index.at(i)->text).split('\n');
+        for (QStringView line : cueLines)
         {
-            const auto &info = list.itemToSub[item];
-            if (info->start <= time + TIME_DELTA &&
-                info->end >= time - TIME_DELTA)
+            if (lines.contains(line))
             {
-                list.table->scrollToItem(item);
-                rows << list.table->row(item);
+                rows << i;
+                break;
             }
         }
     }
-    std::sort(rows.begin(), rows.end());
     if (!rows.isEmpty())
     {
-        list.table->setCurrentCell(rows.first(), 1);
+        list.table->setCurrentIndex(
+            list.model->index(rows.first(), SubtitleListModel::Subtitle)
+        );
         for (int i = 1; i < rows.size(); ++i)
         {
-            list.table->setCurrentCell(rows[i], 1, QItemSelectionModel::Select);
+            list.table->selectionModel()->setCurrentIndex(
+                list.model->index(rows[i], SubtitleListModel::Subtitle),
+                QItemSelectionModel::Select
+            );
         }
+        list.table->scrollTo(list.table->currentIndex());
     }
 }
 
@@ -673,7 +1189,7 @@ void SubtitleListWidget::updatePrimarySubtitle(const QString &subtitle,
     }
     else
     {
-        addSubtitle(m_primary, subtitle, start, end, delay, true);
+        addSubtitle(m_primary, subtitle, start, end, true);
     }
     m_primary.lock.unlock();
 }
@@ -693,57 +1209,47 @@ void SubtitleListWidget::updateSecondarySubtitle(const QString &subtitle,
     }
     else
     {
-        addSubtitle(m_secondary, subtitle, start, end, delay, false);
+        addSubtitle(m_secondary, subtitle, start, end, false);
     }
     m_secondary.lock.unlock();
 }
 
-void SubtitleListWidget::updateTimestampsHelper(SubtitleList &list,
-                                                double delay)
-{
-    size_t i = 0;
-    for (auto it = list.startToItem.keyBegin();
-         it != list.startToItem.keyEnd();
-         ++it)
-    {
-        const double time = *it + delay < 0 ? 0 : *it + delay;
-        QTableWidgetItem *timecodeItem =
-            new QTableWidgetItem(formatTimecode(time));
-        timecodeItem->setFlags(Qt::NoItemFlags);
-        list.table->setItem(i, 0, timecodeItem);
-
-        i++;
-    }
-    list.table->resizeRowsToContents();
-}
-
 void SubtitleListWidget::updatePrimaryTimestamps(const double delay)
 {
-    updateTimestampsHelper(m_primary, delay);
+    m_primary.model->setDelay(delay);
 }
 
 void SubtitleListWidget::updateSecondaryTimestamps(const double delay)
 {
-    updateTimestampsHelper(m_secondary, delay);
+    m_secondary.model->setDelay(delay);
 }
 
 /* End Adder Methods */
 /* Begin Context Methods */
 
+QList<int> SubtitleListWidget::getSelectedRows(const SubtitleList &list) const
+{
+    QList<int> rows;
+    const QModelIndexList indices =
+        list.table->selectionModel()->selectedIndexes();
+    for (const QModelIndex &index : indices)
+    {
+        rows << index.row();
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
 QString SubtitleListWidget::getContext(const SubtitleList *list,
                                        const QString      &separator) const
 {
-    QList<QTableWidgetItem *> items = list->table->selectedItems();
-    std::sort(items.begin(), items.end(),
-        [=] (QTableWidgetItem *lhs, QTableWidgetItem *rhs)
-        {
-            return list->table->row(lhs) < list->table->row(rhs);
-        }
-    );
+    const QList<int> rows = getSelectedRows(*list);
     QString context;
-    for (const QTableWidgetItem *item : items)
+    for (int row : rows)
     {
-        context += item->text().replace('\n', separator) + separator;
+        context +=
+            QString(list->model->text(row)).replace('\n', separator) +
+            separator;
     }
     return context;
 }
@@ -764,17 +1270,17 @@ inline QPair<double, double> SubtitleListWidget::getContextTime(
     double start = 0.0;
     double end = 0.0;
 
-    QList<QTableWidgetItem *> items = list.table->selectedItems();
-    if (!items.isEmpty())
+    /* Rows are sorted by start time, so only the end has to be searched */
+    const SubtitleIndex &index = list.model->subtitles();
+    const QList<int> rows = getSelectedRows(list);
+    if (!rows.isEmpty())
     {
-        start = list.itemToSub[items.first()]->start;
-        end = list.itemToSub[items.last()]->end;
+        start = index.at(rows.first())->start;
     }
-    for (QTableWidgetItem *item : items)
+    for (int row : rows)
     {
-        const auto &info = list.itemToSub[item];
-        start = start < info->start ? start : info->start;
-        end = end > info->end ? end : info->end;
+        const double rowEnd = index.at(row)->end;
+        end = end > rowEnd ? end : rowEnd;
     }
 
     return QPair<double, double>(start, end);
@@ -790,13 +1296,13 @@ QPair<double, double> SubtitleListWidget::getPrimaryContextTime() const
 
 #define SEEK_ERROR 0.028
 
-void SubtitleListWidget::seekToSubtitle(QTableWidgetItem *item,
+void SubtitleListWidget::seekToSubtitle(const QModelIndex &index,
                                         const SubtitleList &list) const
 {
     PlayerAdapter *player =
         GlobalMediator::getGlobalMediator()->getPlayerAdapter();
     double pos =
-        list.itemToSub[item]->start +
+        list.model->subtitles().at(index.row())->start +
         player->getSubDelay() +
         SEEK_ERROR;
     if (pos < 0)
@@ -808,14 +1314,15 @@ void SubtitleListWidget::seekToSubtitle(QTableWidgetItem *item,
 
 #undef SEEK_ERROR
 
-void SubtitleListWidget::seekToPrimarySubtitle(QTableWidgetItem *item) const
+void SubtitleListWidget::seekToPrimarySubtitle(const QModelIndex &index) const
 {
-    seekToSubtitle(item, m_primary);
+    seekToSubtitle(index, m_primary);
 }
 
-void SubtitleListWidget::seekToSecondarySubtitle(QTableWidgetItem *item) const
+void SubtitleListWidget::seekToSecondarySubtitle(
+    const QModelIndex &index) const
 {
-    seekToSubtitle(item, m_secondary);
+    seekToSubtitle(index, m_secondary);
 }
 
 /* End Seek Methods */
@@ -880,13 +1387,9 @@ void SubtitleListWidget::copyAudioContext() const
 
 void SubtitleListWidget::clearSubtitles(SubtitleList &list)
 {
-    list.table->clearContents();
-    list.table->setRowCount(0);
+    list.model->clear();
     list.subList = nullptr;
     list.subsParsed = nullptr;
-    list.startToItem.clear();
-    list.itemToSub.clear();
-    list.lineToItem.clear();
     list.modified = true;
     list.foundRows.clear();
     list.currentFind = 0;
@@ -912,9 +1415,158 @@ void SubtitleListWidget::clearCachedSubtitles()
     clearSecondarySubtitles();
     m_subtitleMap.clear();
     m_subtitleParsed.clear();
+    m_subtitleParsing.clear();
+    m_subtitleFiltered.clear();
+    m_subtitleFiltering.clear();
+#ifdef EMBEDDED_SUBTITLE_SUPPORT
+    for (CancellationSource &source : m_subtitleExtractions)
+    {
+        source.cancel();
+    }
+    m_subtitleExtractions.clear();
+#endif
+    ++m_parseGeneration;
 }
 
 /* End Clear Methods */
+/* Begin Prefetch Methods */
+
+/* Bytes read from either end of a file to bring its headers and index into
+ * the OS cache */
+#define WARM_SIZE (4 * 1024 * 1024)
+#define WARM_BLOCK_SIZE (64 * 1024)
+
+/**
+ * Reads the start and end of a file and throws the data away, so opening the
+ * file later doesn't have to wait on the disk.
+ * @param path  The path of the file.
+ * @param token Stops reading when cancelled.
+ */
+static void warmFile(const QString &path, const CancellationToken &token)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    /* Containers keep their index at either end */
+    QByteArray block(WARM_BLOCK_SIZE, Qt::Uninitialized);
+    const qint64 tail = std::max<qint64>(file.size() - WARM_SIZE, WARM_SIZE);
+    for (const qint64 start : {qint64(0), tail})
+    {
+        if (!file.seek(start))
+        {
+            break;
+        }
+        for (qint64 read = 0;
+             read < WARM_SIZE && !token.isCancelled();
+             read += WARM_BLOCK_SIZE)
+        {
+            if (file.read(block.data(), block.size()) <= 0)
+            {
+                break;
+            }
+        }
+    }
+}
+
+#undef WARM_SIZE
+#undef WARM_BLOCK_SIZE
+
+void SubtitleListWidget::schedulePrefetch()
+{
+    m_prefetchTimer.start();
+}
+
+void SubtitleListWidget::prefetchNext()
+{
+    PlayerAdapter *player =
+        GlobalMediator::getGlobalMediator()->getPlayerAdapter();
+    if (!player)
+    {
+        return;
+    }
+
+    m_prefetchSource.cancel();
+    const QString media = player->getNextPath();
+    if (media != m_prefetchMedia)
+    {
+        m_prefetched.clear();
+        m_prefetchMedia = media;
+    }
+    if (media.isEmpty())
+    {
+        return;
+    }
+
+    const QStringList paths = player->getExternalSubtitles(media);
+    m_subRegexLock.lock();
+    const QRegularExpression regex = m_subRegex;
+    m_subRegexLock.unlock();
+    const int generation = m_subRegexGeneration;
+    const CancellationToken token = m_prefetchSource.token();
+    m_prefetchPool.start([=] {
+        warmFile(media, token);
+
+        QHash<QString, PrefetchedSubtitles> prefetched;
+        for (const QString &path : paths)
+        {
+            if (token.isCancelled())
+            {
+                return;
+            }
+
+            const QList<SubtitleInfo> subtitles = loadSubtitleFile(path);
+            if (subtitles.isEmpty())
+            {
+                continue;
+            }
+
+            PrefetchedSubtitles entry;
+            entry.subtitles.reserve(subtitles.size());
+            for (const SubtitleInfo &info : subtitles)
+            {
+                entry.subtitles.emplace_back(
+                    std::make_shared<SubtitleInfo>(info)
+                );
+            }
+
+            std::shared_ptr<FilteredSubtitles> filtered =
+                std::make_shared<FilteredSubtitles>();
+            filtered->generation = generation;
+            filtered->sourceSize = entry.subtitles.size();
+            filtered->rows = filterSubtitles(entry.subtitles, regex);
+            entry.filtered = filtered;
+
+            prefetched[path] = entry;
+        }
+
+        QMetaObject::invokeMethod(
+            this,
+            [=] {
+                if (!token.isCancelled())
+                {
+                    finishPrefetch(media, prefetched);
+                }
+            },
+            Qt::QueuedConnection
+        );
+    });
+}
+
+void SubtitleListWidget::finishPrefetch(
+    const QString &media,
+    const QHash<QString, PrefetchedSubtitles> &prefetched)
+{
+    if (media != m_prefetchMedia)
+    {
+        return;
+    }
+    m_prefetched.insert(prefetched);
+}
+
+/* End Prefetch Methods */
 /* Begin Helper Slots */
 
 void SubtitleListWidget::hideSecondarySubs()
@@ -933,19 +1585,6 @@ void SubtitleListWidget::showSecondarySubs()
     }
 }
 
-void SubtitleListWidget::fixTableDimensions(const int index)
-{
-    switch(index)
-    {
-    case 0:
-        m_ui->tablePrim->resizeRowsToContents();
-        break;
-    case 1:
-        m_ui->tableSec->resizeRowsToContents();
-        break;
-    }
-}
-
 /* End Helper Slots */
 /* Begin Find Widget Slots */
 
@@ -954,7 +1593,21 @@ void SubtitleListWidget::fixTableDimensions(const int index)
 
 void SubtitleListWidget::findTextHelper(SubtitleList &list, const QString &text)
 {
+    const SubtitleListModel::FindMode mode = getFindMode();
+
+    /* Typing more of the last search can only narrow its results, so only
+     * those rows have to be checked again */
+    const bool refine =
+        !list.modified &&
+        mode != SubtitleListModel::FindMode::Regex &&
+        mode == list.lastFindMode &&
+        !list.lastFind.isEmpty() &&
+        text.contains(list.lastFind, Qt::CaseInsensitive);
+    const QList<int> previous = refine ? list.foundRows : QList<int>();
+
     list.modified = false;
+    list.lastFind = text;
+    list.lastFindMode = mode;
     list.foundRows.clear();
     list.currentFind = 0;
 
@@ -964,14 +1617,8 @@ void SubtitleListWidget::findTextHelper(SubtitleList &list, const QString &text)
         return;
     }
 
-    for (int i = 0; i < list.table->rowCount(); ++i)
-    {
-        QTableWidgetItem *item = list.table->item(i, 1);
-        if (item->text().contains(text, Qt::CaseInsensitive))
-        {
-            list.foundRows << i;
-        }
-    }
+    list.foundRows =
+        list.model->find(text, mode, refine ? &previous : nullptr);
 
     if (list.foundRows.isEmpty())
     {
@@ -980,7 +1627,9 @@ void SubtitleListWidget::findTextHelper(SubtitleList &list, const QString &text)
     else
     {
         list.currentFind = 0;
-        list.table->setCurrentCell(list.foundRows[0], 1);
+        list.table->setCurrentIndex(
+            list.model->index(list.foundRows[0], SubtitleListModel::Subtitle)
+        );
         m_ui->labelSearchMatch->setText(
             MATCH_FORMAT.arg(1).arg(list.foundRows.size())
         );
@@ -997,6 +1646,19 @@ void SubtitleListWidget::findText(const QString &text)
     list.lock.unlock();
 }
 
+SubtitleListModel::FindMode SubtitleListWidget::getFindMode() const
+{
+    if (m_ui->buttonSearchRegex->isChecked())
+    {
+        return SubtitleListModel::FindMode::Regex;
+    }
+    else if (m_ui->buttonSearchKana->isChecked())
+    {
+        return SubtitleListModel::FindMode::Kana;
+    }
+    return SubtitleListModel::FindMode::Plain;
+}
+
 /**
  * A sanitary macro for doing mod. This is necessary because % in C++ can return
  * negative numbers.
@@ -1027,7 +1689,11 @@ void SubtitleListWidget::findRowHelper(int offset)
     }
 
     list.currentFind = mod(list.currentFind + offset, list.foundRows.size());
-    list.table->setCurrentCell(list.foundRows[list.currentFind], 1);
+    list.table->setCurrentIndex(
+        list.model->index(
+            list.foundRows[list.currentFind], SubtitleListModel::Subtitle
+        )
+    );
     m_ui->labelSearchMatch->setText(
         MATCH_FORMAT.arg(list.currentFind + 1).arg(list.foundRows.size())
     );
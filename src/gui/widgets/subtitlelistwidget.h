@@ -27,17 +27,22 @@
 #include <vector>
 
 #include <QHash>
-#include <QMultiHash>
-#include <QMultiMap>
 #include <QMutex>
 #include <QRegularExpression>
+#include <QSet>
+#include <QThreadPool>
+#include <QTimer>
 
 #include "anki/ankiclient.h"
+#include "dict/cancellationtoken.h"
 #include "player/playeradapter.h"
+#include "util/subtitleparser.h"
 
+#include "subtitlelistmodel.h"
+
+class QModelIndex;
 class QShortcut;
-class QTableWidget;
-class QTableWidgetItem;
+class QTableView;
 
 struct SubtitleInfo;
 
@@ -100,13 +105,6 @@ protected:
      */
     void hideEvent(QHideEvent *event) override;
 
-    /**
-     * Maintains well sized rows and avoids the need for horizontal scrolling or
-     * wasted space.
-     * @param event The resize event, not used.
-     */
-    void resizeEvent(QResizeEvent *event) override;
-
 Q_SIGNALS:
     /**
      * Requests that the subtitle list be refreshed.
@@ -198,13 +196,6 @@ private Q_SLOTS:
      */
     void updateSecondaryTimestamps(const double delay);
 
-    /**
-     * Resizes rows to contents.
-     * @param index The index of the table to update. 0 for primary,
-     *              1 for secondary.
-     */
-    void fixTableDimensions(const int index);
-
     /**
      * Removes all the subtitles in the primary subtitle list.
      */
@@ -221,18 +212,27 @@ private Q_SLOTS:
     void clearCachedSubtitles();
 
     /**
-     * Seeks to the primary subtitle belonging to the item.
-     * @param item The item belonging to the subtitle to seek to. Not the
-     *             timestamp item.
+     * Restarts the countdown to prefetching the next file in the playlist.
      */
-    void seekToPrimarySubtitle(QTableWidgetItem *item) const;
+    void schedulePrefetch();
 
     /**
-     * Seeks to the secondary subtitle belonging to the item.
-     * @param item The item belonging to the subtitle to seek to. Not the
-     *             timestamp item.
+     * Parses the subtitles of the next file in the playlist in the background
+     * and reads the start and end of the file so it opens quickly.
      */
-    void seekToSecondarySubtitle(QTableWidgetItem *item) const;
+    void prefetchNext();
+
+    /**
+     * Seeks to the primary subtitle in a row.
+     * @param index An index in the row of the subtitle to seek to.
+     */
+    void seekToPrimarySubtitle(const QModelIndex &index) const;
+
+    /**
+     * Seeks to the secondary subtitle in a row.
+     * @param index An index in the row of the subtitle to seek to.
+     */
+    void seekToSecondarySubtitle(const QModelIndex &index) const;
 
     /**
      * Copys the currently selected context to clipboard.
@@ -264,8 +264,11 @@ private:
     /* Holds all structures relating to a subtitle list. */
     struct SubtitleList
     {
-        /* The table to populate subtitles with */
-        QTableWidget *table = nullptr;
+        /* The table showing the subtitles */
+        QTableView *table = nullptr;
+
+        /* The subtitles in the table. Belongs to the widget. */
+        SubtitleListModel *model = nullptr;
 
         /* Locks all structures related to the subtitle. */
         QMutex lock;
@@ -276,18 +279,6 @@ private:
         /* true if subtitles were parsed, false otherwise */
         std::shared_ptr<bool> subsParsed = nullptr;
 
-        /* Maps timecodes to table widget items for the subtitles. */
-        QMultiMap<double, QTableWidgetItem *> startToItem;
-
-        /* Maps table widget items to subtitle infos. */
-        QHash<
-            QTableWidgetItem *,
-            std::shared_ptr<const SubtitleInfo>
-        > itemToSub;
-
-        /* Maps subtitle lines to table widget items for parsed subtitles. */
-        QMultiHash<QString, QTableWidgetItem *> lineToItem;
-
         /* Begin Search Values */
 
         /* true if the widget has been modified since the last search */
@@ -298,8 +289,43 @@ private:
 
         /* the currently found row */
         int currentFind;
+
+        /* the text of the last search */
+        QString lastFind;
+
+        /* the mode of the last search */
+        SubtitleListModel::FindMode lastFindMode =
+            SubtitleListModel::FindMode::Plain;
     };
 
+    /* The subtitles of a track after filtering with the subtitle regex */
+    struct FilteredSubtitles
+    {
+        /* The value of m_subRegexGeneration the rows were filtered with */
+        int generation;
+
+        /* The size of the track when it was filtered */
+        size_t sourceSize;
+
+        /* The rows left after filtering sorted by start time */
+        std::vector<SubtitleListModel::Row> rows;
+    };
+
+    /* A subtitle file of the next file in the playlist parsed ahead of time */
+    struct PrefetchedSubtitles
+    {
+        /* The subtitles in file order */
+        std::vector<std::shared_ptr<SubtitleInfo>> subtitles;
+
+        /* The subtitles filtered with the subtitle regex */
+        std::shared_ptr<const FilteredSubtitles> filtered;
+    };
+
+    /**
+     * Sizes every row of the tables to a single line of the current font.
+     */
+    void initRowHeights();
+
     /**
      * Hides the secondary subtitle list and tabs.
      */
@@ -322,6 +348,13 @@ private:
                          const QString &subtitle,
                          double delay);
 
+    /**
+     * Gets the rows of the selected subtitles in a list.
+     * @param list The list to get selected rows from.
+     * @return The selected rows in ascending order.
+     */
+    QList<int> getSelectedRows(const SubtitleList &list) const;
+
     /**
      * Helper method for getting a context string from a subtitle list.
      * @param list      The list to get selected rows from.
@@ -361,7 +394,6 @@ private:
      * @param subtitle The subtitle to add.
      * @param start    The start time of the subtitle.
      * @param end      The end time of the subtitle.
-     * @param delay    The signed delay of the subtitle.
      * @param regex    True if regex should be used to filter the subtitle,
      *                 false otherwise.
      */
@@ -369,38 +401,147 @@ private:
                      const QString &subtitle,
                      double start,
                      double end,
-                     double delay,
                      bool regex = false);
 
     /**
-     * Adds an item to a subtitle table. Assumes the subtitle is not already in
+     * Adds a row to a subtitle table. Assumes the subtitle is not already in
      * the table.
-     * @param list       The subtitle list to add the item to.
-     * @param info       The subtitle information.
-     * @param delay      The signed delay of the subtitle.
-     * @param regex      Filter the subtitle with the subtitle regex.
-     * @return The constructed QTableWidgetItem. Belongs to table. nullptr if
-     *         regex is true and the text is empty.
+     * @param list  The subtitle list to add the row to.
+     * @param info  The subtitle information.
+     * @param regex Filter the subtitle with the subtitle regex.
+     * @return The row of the subtitle. -1 if regex is true and the text is
+     *         empty.
      */
-    QTableWidgetItem *addTableItem(SubtitleList &list,
-                                   const std::shared_ptr<SubtitleInfo> &info,
-                                   double delay,
-                                   bool regex = false);
+    int addRow(SubtitleList &list,
+               const std::shared_ptr<SubtitleInfo> &info,
+               bool regex = false);
 
     /**
-     * Helper method that converts a time in seconds to a timecode string of the
-     * form HH:MM:SS.
-     * @param time The time in seconds.
-     * @returns A timecode fo the format HH:MM:SS.
+     * Adds rows to a subtitle table at once. Assumes the subtitles are not
+     * already in the table.
+     * @param list      The subtitle list to add the rows to.
+     * @param subtitles The subtitles to add sorted by start time.
+     * @param regex     Filter the subtitles with the subtitle regex.
      */
-    QString formatTimecode(const int time);
+    void addRows(SubtitleList &list,
+                 const std::vector<std::shared_ptr<SubtitleInfo>> &subtitles,
+                 bool regex = false);
 
     /**
-     * Updates the timestamps in a table with a new delay.
-     * @param list     The list to update the timestamps of.
-     * @param delay    The signed delay of the subtitle.
+     * Filters every subtitle of a track with the subtitle regex on the thread
+     * pool. The primary list is swapped to the filtered rows in one go once
+     * they are ready, if it still shows the track.
+     * @param sid The sid of the track.
      */
-    void updateTimestampsHelper(SubtitleList &list, double delay);
+    void refilterSubtitles(int64_t sid);
+
+    /**
+     * Caches the filtered rows of a track and shows them in the primary list.
+     * Must be called from the GUI thread.
+     * @param sid      The sid of the track.
+     * @param subList  The subtitles of the track that were filtered.
+     * @param filtered The filtered rows.
+     */
+    void finishRefilter(
+        int64_t sid,
+        std::shared_ptr<std::vector<std::shared_ptr<SubtitleInfo>>> subList,
+        std::shared_ptr<const FilteredSubtitles> filtered);
+
+    /**
+     * Emits subtitleListLoaded() with the lines of the primary list if its
+     * track is parsed. Must be called from the GUI thread.
+     */
+    void emitPrimaryLoaded();
+
+    /**
+     * Keeps the prefetched subtitle files of the next file in the playlist.
+     * Must be called from the GUI thread.
+     * @param media      The path of the file they were prefetched for.
+     * @param prefetched Maps absolute subtitle file paths to their subtitles.
+     */
+    void finishPrefetch(
+        const QString &media,
+        const QHash<QString, PrefetchedSubtitles> &prefetched);
+
+    /**
+     * Marks a track as being parsed, creating its cache entries if needed.
+     * @param      sid     The sid of the track.
+     * @param[out] refresh Set to true if the track was already parsed and the
+     *                     lists should be refreshed.
+     * @return true if the track should be parsed, false if it already was or
+     *         is being parsed.
+     */
+    bool claimTrack(int64_t sid, bool &refresh);
+
+    /**
+     * Creates a chunk handler that posts chunks of a track to the GUI thread.
+     * Safe to call from any thread.
+     * @param generation The value of m_parseGeneration when parsing started.
+     * @param sid        The sid of the track.
+     * @param token      Chunks are dropped if this is cancelled.
+     * @return A chunk handler for a single parse of the track.
+     */
+    SubtitleParser::ChunkHandler postChunkHandler(
+        int generation,
+        int64_t sid,
+        const CancellationToken &token = CancellationToken());
+
+    /**
+     * Posts that a track is done parsing to the GUI thread. Safe to call from
+     * any thread.
+     * @param generation The value of m_parseGeneration when parsing started.
+     * @param sid        The sid of the track.
+     * @param ok         true if the whole file parsed, false otherwise.
+     * @param token      Nothing is posted if this is cancelled.
+     */
+    void postFinished(
+        int generation,
+        int64_t sid,
+        bool ok,
+        const CancellationToken &token = CancellationToken());
+
+#ifdef EMBEDDED_SUBTITLE_SUPPORT
+    /**
+     * Extracts the embedded tracks currently selected as the primary or
+     * secondary subtitles. Cancels extractions of tracks that were
+     * deselected. Called whenever either selection changes.
+     */
+    void updateEmbeddedExtraction();
+
+    /**
+     * Extracts the selected embedded subtitle tracks of the current file in
+     * the background. Cancels extractions of tracks that aren't selected.
+     * @param      sids    The sids of the selected embedded tracks.
+     * @param      indices The FFmpeg stream indices of the tracks.
+     * @param[out] refresh Set to true if the lists should be refreshed.
+     */
+    void extractEmbeddedSubtitles(
+        const QList<int64_t> &sids,
+        const QList<int64_t> &indices,
+        bool &refresh);
+#endif
+
+    /**
+     * Adds a chunk of parsed subtitles to a track and to the lists showing
+     * the track. Must be called from the GUI thread.
+     * @param generation The value of m_parseGeneration when parsing started.
+     * @param sid        The sid of the track.
+     * @param subtitles  The subtitles in the chunk.
+     * @param first      true if this is the first chunk of the track.
+     */
+    void addParsedSubtitles(
+        int generation,
+        int64_t sid,
+        const std::vector<std::shared_ptr<SubtitleInfo>> &subtitles,
+        bool first);
+
+    /**
+     * Marks a track as done parsing. Must be called from the GUI thread.
+     * @param generation The value of m_parseGeneration when parsing started.
+     * @param sid        The sid of the track.
+     * @param ok         true if the whole file parsed, false otherwise.
+     */
+    void finishParsedSubtitles(int generation, int64_t sid, bool ok);
 
     /**
      * Removes all the information in the table and cleans up metadata.
@@ -409,12 +550,12 @@ private:
     void clearSubtitles(SubtitleList &list);
 
     /**
-     * Seeks to the subtitle belonging to the item.
-     * @param item       The item belonging to the subtitle to seek to. Not a
-     *                   timestamp item.
-     * @param startTimes Maps an item to a timecode.
+     * Seeks to the subtitle in a row.
+     * @param index An index in the row of the subtitle to seek to.
+     * @param list  The list the row belongs to.
      */
-    void seekToSubtitle(QTableWidgetItem *item, const SubtitleList &list) const;
+    void seekToSubtitle(const QModelIndex &index,
+                        const SubtitleList &list) const;
 
     /**
      * Finds the text in the list without locking the list.
@@ -423,6 +564,12 @@ private:
      */
     void findTextHelper(SubtitleList &list, const QString &text);
 
+    /**
+     * Gets the search mode selected in the find widget.
+     * @return The selected search mode.
+     */
+    SubtitleListModel::FindMode getFindMode() const;
+
     /**
      * Selects the row of the current table with the offset from the currently
      * currently found row.
@@ -448,6 +595,9 @@ private:
     /* Lock for the regular expression */
     QMutex m_subRegexLock;
 
+    /* Incremented when the pattern of m_subRegex changes */
+    int m_subRegexGeneration = 0;
+
     /* Maps sid to a list of subtitles */
     QHash<
         int64_t,
@@ -457,6 +607,43 @@ private:
     /* Maps sid to whether or not the subtitle was parsed. */
     QHash<int64_t, std::shared_ptr<bool>> m_subtitleParsed;
 
+    /* The sids of the external tracks that are being parsed */
+    QSet<int64_t> m_subtitleParsing;
+
+    /* Maps sid to its subtitles filtered with the subtitle regex */
+    QHash<int64_t, std::shared_ptr<const FilteredSubtitles>>
+        m_subtitleFiltered;
+
+    /* The sids of the tracks that are being filtered */
+    QSet<int64_t> m_subtitleFiltering;
+
+    /* Incremented when cached subtitles are cleared so chunks from parses
+     * that started before then are dropped */
+    int m_parseGeneration = 0;
+
+#ifdef EMBEDDED_SUBTITLE_SUPPORT
+    /* Maps sid to the cancellation source of its running extraction */
+    QHash<int64_t, CancellationSource> m_subtitleExtractions;
+
+    /* Low priority pool embedded subtitles are extracted on */
+    QThreadPool m_extractPool;
+#endif
+
+    /* Fires once playback of a file has settled to prefetch the next one */
+    QTimer m_prefetchTimer;
+
+    /* Low priority pool the next file in the playlist is prefetched on */
+    QThreadPool m_prefetchPool;
+
+    /* Cancels the running prefetch */
+    CancellationSource m_prefetchSource;
+
+    /* The path of the file the subtitles in m_prefetched belong to */
+    QString m_prefetchMedia;
+
+    /* Maps absolute subtitle file paths to their prefetched subtitles */
+    QHash<QString, PrefetchedSubtitles> m_prefetched;
+
     /* The primary subtitle list */
     SubtitleList m_primary;
 
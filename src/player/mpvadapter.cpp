@@ -22,6 +22,8 @@
 
 #include <QApplication>
 #include <QDebug>
+#include <QDir>
+#include <QFileInfo>
 #include <QSettings>
 #include <QTemporaryFile>
 
@@ -159,6 +161,10 @@ MpvAdapter::MpvAdapter(MpvWidget *mpv, QObject *parent)
         m_mpv,    &MpvWidget::fileChanged,
         mediator, &GlobalMediator::playerFileChanged
     );
+    connect(
+        m_mpv,    &MpvWidget::playlistChanged,
+        mediator, &GlobalMediator::playerPlaylistChanged
+    );
 
     connect(
         m_mpv,    &MpvWidget::mouseMoved,
@@ -548,6 +554,83 @@ QString MpvAdapter::getTitle() const
     return title_str;
 }
 
+QString MpvAdapter::getNextPath() const
+{
+    int64_t pos = -1;
+    int64_t count = 0;
+    if (mpv_get_property(m_handle, "playlist-pos", MPV_FORMAT_INT64, &pos) < 0 ||
+        mpv_get_property(m_handle, "playlist-count", MPV_FORMAT_INT64, &count) < 0)
+    {
+        return "";
+    }
+    if (pos < 0 || pos + 1 >= count)
+    {
+        return "";
+    }
+
+    const QByteArray prop = QString("playlist/%1/filename").arg(pos + 1).toUtf8();
+    char *path = NULL;
+    if (mpv_get_property(m_handle, prop.constData(), MPV_FORMAT_STRING, &path) < 0)
+    {
+        return "";
+    }
+    QString path_str(path);
+    mpv_free(path);
+    return path_str;
+}
+
+QStringList MpvAdapter::getExternalSubtitles(const QString &path) const
+{
+    QStringList subtitles;
+    const QFileInfo media(path);
+    if (!media.isFile())
+    {
+        return subtitles;
+    }
+
+    char *mode = mpv_get_property_string(m_handle, "sub-auto");
+    const QString subAuto = mode ? mode : "exact";
+    mpv_free(mode);
+    if (subAuto == "no")
+    {
+        return subtitles;
+    }
+
+    /* Mirrors how mpv matches names in the directory of the file. Paths in
+     * sub-file-paths aren't searched. */
+    const QString base = media.completeBaseName();
+    const QFileInfoList entries =
+        media.dir().entryInfoList(QDir::Files | QDir::Readable, QDir::Name);
+    for (const QFileInfo &entry : entries)
+    {
+        if (!m_subExts.contains(entry.suffix().toLower()))
+        {
+            continue;
+        }
+
+        const QString name = entry.completeBaseName();
+        bool match = false;
+        if (subAuto == "all")
+        {
+            match = true;
+        }
+        else if (subAuto == "fuzzy")
+        {
+            match = name.contains(base, Qt::CaseInsensitive);
+        }
+        else
+        {
+            match = name.compare(base, Qt::CaseInsensitive) == 0 ||
+                name.startsWith(base + '.', Qt::CaseInsensitive);
+        }
+        if (match)
+        {
+            subtitles << entry.absoluteFilePath();
+        }
+    }
+    return subtitles;
+}
+
 bool MpvAdapter::isFullscreen() const
 {
     int flag;
@@ -1254,6 +1337,11 @@ QList<const Track *> MpvAdapter::processTracks(const mpv_node *node)
                         if (node->u.list->values[i].u.list->values[n].format == MPV_FORMAT_INT64)
                             track->srcId = node->u.list->values[i].u.list->values[n].u.int64;
                     }
+                    else if (QString(node->u.list->values[i].u.list->keys[n]) == "ff-index")
+                    {
+                        if (node->u.list->values[i].u.list->values[n].format == MPV_FORMAT_INT64)
+                            track->ffIndex = node->u.list->values[i].u.list->values[n].u.int64;
+                    }
                     else if (QString(node->u.list->values[i].u.list->keys[n]) == "title")
                     {
                         if (node->u.list->values[i].u.list->values[n].format == MPV_FORMAT_STRING)
@@ -71,6 +71,10 @@ public:
 
     QString getTitle() const override;
 
+    QString getNextPath() const override;
+
+    QStringList getExternalSubtitles(const QString &path) const override;
+
     bool isFullscreen() const override;
 
     bool isPaused() const override;
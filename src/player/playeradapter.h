@@ -141,6 +141,22 @@ public:
      */
     virtual QString getTitle() const = 0;
 
+    /**
+     * Gets the path of the file after the current one in the playlist.
+     * @return The path of the next file, empty if there is none.
+     */
+    virtual QString getNextPath() const = 0;
+
+    /**
+     * Finds the subtitle files the player would load alongside a media file.
+     * Reads the player's subtitle auto-loading setting and lists the directory
+     * of the file, so it should not be called in a tight loop.
+     * @param path The path of the media file.
+     * @return The paths of the subtitle files. Empty if the player doesn't
+     *         load subtitles on its own or the file isn't local.
+     */
+    virtual QStringList getExternalSubtitles(const QString &path) const = 0;
+
     /**
      * Returns if the player is fullscreened.
      * @return true if the player is fullscreened, false otherwise.
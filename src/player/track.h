@@ -47,6 +47,11 @@ struct Track
     /* Track ID as used in the source file. Not always available. */
     int64_t srcId;
 
+    /* The index of the stream in the file as seen by FFmpeg. -1 if the track
+     * doesn't come from FFmpeg's demuxer.
+     */
+    int64_t ffIndex = -1;
+
     /* Track title as it is stored in the file. Not always available. */
     QString title;
 
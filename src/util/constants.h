@@ -137,6 +137,24 @@ namespace Constants
             constexpr const char *GROUP = "dictionaries";
         }
 
+        namespace Database
+        {
+            constexpr const char *GROUP = "database";
+
+            namespace Profile
+            {
+                constexpr const char *DISK = "Disk";
+                constexpr const char *MAPPED = "Memory-mapped";
+                constexpr const char *MEMORY = "In-memory";
+            }
+
+            constexpr const char *PROFILE = "storage-profile";
+            constexpr const char *PROFILE_DEFAULT = Profile::DISK;
+
+            constexpr const char *PACK = "compiled-pack";
+            constexpr bool PACK_DEFAULT = false;
+        }
+
         namespace Search
         {
             constexpr const char *GROUP = "search";
@@ -152,6 +170,12 @@ namespace Constants
 #ifdef MECAB_SUPPORT
                 constexpr const char *MECAB_IPADIC = "ipadic-matcher";
                 constexpr bool MECAB_IPADIC_DEFAULT = true;
+
+                constexpr const char *MECAB_MAX_CANDIDATES = "ipadic-max-candidates";
+                constexpr int MECAB_MAX_CANDIDATES_DEFAULT = 512;
+
+                constexpr const char *MECAB_MAX_PATH = "ipadic-max-path";
+                constexpr int MECAB_MAX_PATH_DEFAULT = 16;
 #endif // MECAB_SUPPORT
             }
 
@@ -193,6 +217,22 @@ namespace Constants
             constexpr const char *AUTO_PLAY_AUDIO = "auto-play-audio";
             constexpr bool AUTO_PLAY_AUDIO_DEFAULT = false;
 
+            constexpr const char *PREFETCH = "prefetch";
+            constexpr bool PREFETCH_DEFAULT = false;
+
+            constexpr const char *PREFETCH_THREADS = "prefetch-threads";
+            constexpr int PREFETCH_THREADS_DEFAULT = 1;
+
+            constexpr const char *PREFETCH_BUDGET = "prefetch-budget";
+            constexpr int PREFETCH_BUDGET_DEFAULT = 5000;
+
+            constexpr const char *VOCABULARY = "episode-vocabulary";
+            constexpr bool VOCABULARY_DEFAULT = false;
+
+            constexpr const char *VOCABULARY_THREADS =
+                "episode-vocabulary-threads";
+            constexpr int VOCABULARY_THREADS_DEFAULT = 1;
+
             constexpr const char *LIST_GLOSSARY = "list-result";
             constexpr GlossaryStyle LIST_GLOSSARY_DEFAULT = GlossaryStyle::Bullet;
 
@@ -292,7 +332,7 @@ namespace Constants
 "    color: gray;\n"
 "}\n"
 "\n"
-"QTableWidget {\n"
+"QTableView {\n"
 "    background: black;\n"
 "    color: white;\n"
 "    font-family: \"Noto Sans\", \"Noto Sans JP\", \"Noto Sans CJK JP\", \"Noto Color Emoji\", sans-serif;\n"
@@ -319,7 +359,7 @@ namespace Constants
 "    color: gray;\n"
 "}\n"
 "\n"
-"QTableWidget {\n"
+"QTableView {\n"
 "    background: black;\n"
 "    color: white;\n"
 "    font-family: \"Meiryo\", \"Noto Sans\", \"Noto Sans JP\", \"Noto Sans CJK JP\", \"Noto Color Emoji\", sans-serif;\n"
@@ -346,7 +386,7 @@ namespace Constants
 "    color: gray;\n"
 "}\n"
 "\n"
-"QTableWidget {\n"
+"QTableView {\n"
 "    background: black;\n"
 "    color: white;\n"
 "    font-family: \"Noto Sans\", \"Noto Sans JP\", \"Noto Sans CJK JP\", \"Noto Color Emoji\", sans-serif;\n"
@@ -24,6 +24,7 @@
 #include <QObject>
 
 #include <QSharedPointer>
+#include <QStringList>
 
 #include "player/track.h"
 
@@ -345,6 +346,11 @@ Q_SIGNALS:
      */
     void playerFileChanged(QString path) const;
 
+    /**
+     * Emitted when files are added to or removed from the playlist.
+     */
+    void playerPlaylistChanged() const;
+
     /**
      * Emitted when the mouse is moved over the player.
      */
@@ -571,6 +577,13 @@ Q_SIGNALS:
      */
     void subtitleListShown() const;
 
+    /**
+     * Emitted when every subtitle of a parsed primary subtitle track is in the
+     * subtitle list.
+     * @param lines The filtered text of every subtitle in the track.
+     */
+    void subtitleListLoaded(const QStringList &lines) const;
+
     /* End Subtitle List Signals */
     /* Begin Search Widget Signals */
 
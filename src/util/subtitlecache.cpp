@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "subtitlecache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QUrl>
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#define SUBTITLE_CACHE_MAGIC    "MMSUBC01"
+#define SUBTITLE_CACHE_VERSION  1
+#define SUBTITLE_CACHE_SUFFIX   ".subcache"
+
+/* The size the cache is trimmed to after every save */
+#define SUBTITLE_CACHE_MAX_SIZE (64 * 1024 * 1024)
+
+static_assert(std::is_trivially_copyable_v<SubtitleCacheHeader>);
+static_assert(std::is_trivially_copyable_v<SubtitleCacheCue>);
+static_assert(sizeof(SubtitleCacheHeader) == 24);
+static_assert(sizeof(SubtitleCacheCue) == 24);
+static_assert(
+    sizeof(SUBTITLE_CACHE_MAGIC) - 1 == sizeof(SubtitleCacheHeader::magic)
+);
+
+SubtitleCache::SubtitleCache(const QString &dir) : m_dir(dir) {}
+
+QString SubtitleCache::entryPath(const QString &key) const
+{
+    return QDir(m_dir).filePath(key + SUBTITLE_CACHE_SUFFIX);
+}
+
+QString SubtitleCache::key(const QString &path) const
+{
+    QUrl url(path);
+    QFile file(url.isLocalFile() ? url.toLocalFile() : path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return QString();
+    }
+
+    /* The size and modification time go in first so an edited file can't
+     * match an old entry even if its contents collide */
+    const QFileInfo info(file);
+    const int64_t size = info.size();
+    const int64_t modified = info.lastModified().toMSecsSinceEpoch();
+    QCryptographicHash hasher(QCryptographicHash::Md5);
+    hasher.addData(QByteArrayView((const char *)&size, sizeof(size)));
+    hasher.addData(QByteArrayView((const char *)&modified, sizeof(modified)));
+    if (!hasher.addData(&file))
+    {
+        return QString();
+    }
+    return hasher.result().toHex();
+}
+
+bool SubtitleCache::load(
+    const QString &key,
+    QList<SubtitleInfo> &subtitles) const
+{
+    QFile file(entryPath(key));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size < (qint64)sizeof(SubtitleCacheHeader))
+    {
+        return false;
+    }
+    const uchar *data = file.map(0, size);
+    if (data == nullptr)
+    {
+        return false;
+    }
+
+    /* Validate the tables against the size of the file before reading any
+     * of them */
+    const SubtitleCacheHeader *header = (const SubtitleCacheHeader *)data;
+    const uint64_t cuesSize =
+        (uint64_t)header->cueCount * sizeof(SubtitleCacheCue);
+    const uint64_t tableSize = size - sizeof(SubtitleCacheHeader);
+    if (std::memcmp(
+            header->magic, SUBTITLE_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != SUBTITLE_CACHE_VERSION ||
+        cuesSize > tableSize ||
+        (tableSize - cuesSize) / sizeof(char16_t) < header->textSize)
+    {
+        file.unmap((uchar *)data);
+        return false;
+    }
+
+    const SubtitleCacheCue *cues =
+        (const SubtitleCacheCue *)(data + sizeof(SubtitleCacheHeader));
+    const QChar *text = (const QChar *)(data + sizeof(SubtitleCacheHeader) +
+        cuesSize);
+
+    QList<SubtitleInfo> cached;
+    cached.reserve(header->cueCount);
+    for (uint32_t i = 0; i < header->cueCount; ++i)
+    {
+        const SubtitleCacheCue &cue = cues[i];
+        if ((uint64_t)cue.textOffset + cue.textSize > header->textSize)
+        {
+            file.unmap((uchar *)data);
+            return false;
+        }
+
+        SubtitleInfo info;
+        info.text = QString(text + cue.textOffset, cue.textSize);
+        info.start = cue.start;
+        info.end = cue.end;
+        cached.append(info);
+    }
+    file.unmap((uchar *)data);
+
+    /* Mark the entry as recently used for eviction */
+    file.setFileTime(
+        QDateTime::currentDateTime(), QFileDevice::FileModificationTime
+    );
+
+    subtitles.append(cached);
+    return true;
+}
+
+QString SubtitleCache::save(
+    const QString &key,
+    const QList<SubtitleInfo> &subtitles) const
+{
+    std::vector<SubtitleCacheCue> cues;
+    cues.reserve(subtitles.size());
+    QString text;
+    for (const SubtitleInfo &info : subtitles)
+    {
+        SubtitleCacheCue cue;
+        std::memset(&cue, 0, sizeof(cue));
+        cue.start = info.start;
+        cue.end = info.end;
+        cue.textOffset = text.size();
+        cue.textSize = info.text.size();
+        cues.push_back(cue);
+        text += info.text;
+    }
+
+    SubtitleCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SUBTITLE_CACHE_MAGIC, sizeof(header.magic));
+    header.version  = SUBTITLE_CACHE_VERSION;
+    header.cueCount = cues.size();
+    header.textSize = text.size();
+
+    const QString path = entryPath(key);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return "Could not open " + path + ": " + file.errorString();
+    }
+    file.write((const char *)&header, sizeof(header));
+    file.write(
+        (const char *)cues.data(), cues.size() * sizeof(SubtitleCacheCue)
+    );
+    file.write((const char *)text.constData(), text.size() * sizeof(QChar));
+    if (!file.commit())
+    {
+        return "Could not write " + path + ": " + file.errorString();
+    }
+
+    evict();
+
+    return "";
+}
+
+void SubtitleCache::evict() const
+{
+    const QFileInfoList entries = QDir(m_dir).entryInfoList(
+        {"*" SUBTITLE_CACHE_SUFFIX}, QDir::Files, QDir::Time
+    );
+
+    /* Entries are sorted newest first, so keep everything until the cache is
+     * full and remove the rest */
+    qint64 total = 0;
+    for (const QFileInfo &entry : entries)
+    {
+        total += entry.size();
+        if (total > SUBTITLE_CACHE_MAX_SIZE)
+        {
+            QFile::remove(entry.filePath());
+        }
+    }
+}
+
+#undef SUBTITLE_CACHE_MAGIC
+#undef SUBTITLE_CACHE_VERSION
+#undef SUBTITLE_CACHE_SUFFIX
+#undef SUBTITLE_CACHE_MAX_SIZE
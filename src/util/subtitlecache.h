@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SUBTITLECACHE_H
+#define SUBTITLECACHE_H
+
+#include <QList>
+#include <QString>
+
+#include <cstdint>
+
+#include "subtitleparser.h"
+
+/* Begin On Disk Layout */
+
+/**
+ * The header at the start of every cache file.
+ */
+struct SubtitleCacheHeader
+{
+    /* Always SUBTITLE_CACHE_MAGIC */
+    char magic[8];
+
+    /* The version of the layout */
+    uint32_t version;
+
+    /* The number of cues */
+    uint32_t cueCount;
+
+    /* The size of the text table in UTF-16 code units */
+    uint64_t textSize;
+};
+
+/**
+ * A cue in a cache file. Cues are stored sorted by start time.
+ */
+struct SubtitleCacheCue
+{
+    /* The start time of the cue in seconds */
+    double start;
+
+    /* The end time of the cue in seconds */
+    double end;
+
+    /* The offset of the text of the cue in the text table */
+    uint32_t textOffset;
+
+    /* The length of the text of the cue in UTF-16 code units. Line breaks
+     * are kept in the text. */
+    uint32_t textSize;
+};
+
+/* End On Disk Layout */
+
+/**
+ * An on-disk cache of parsed subtitle files. Entries are keyed by the
+ * contents, size, and modification time of the subtitle file, so renamed
+ * files still hit and edited files never do. The least recently used
+ * entries are removed once the cache grows past a fixed size.
+ */
+class SubtitleCache
+{
+public:
+    /**
+     * Creates a cache stored in a directory.
+     * @param dir The directory to store the cache in. Must exist.
+     */
+    SubtitleCache(const QString &dir);
+
+    /**
+     * Computes the key of a subtitle file.
+     * @param path The path or local file URL of the subtitle file.
+     * @return The key of the file, empty string if the file can't be read.
+     */
+    [[nodiscard]]
+    QString key(const QString &path) const;
+
+    /**
+     * Loads the subtitles of a file from the cache.
+     * @param      key       The key of the subtitle file.
+     * @param[out] subtitles The cached subtitles sorted by start time.
+     * @return true if the file was cached, false otherwise.
+     */
+    bool load(const QString &key, QList<SubtitleInfo> &subtitles) const;
+
+    /**
+     * Saves the subtitles of a file to the cache, then evicts the least
+     * recently used entries if the cache is too big.
+     * @param key       The key of the subtitle file.
+     * @param subtitles The subtitles sorted by start time.
+     * @return Empty string on success, error string on error.
+     */
+    QString save(
+        const QString &key,
+        const QList<SubtitleInfo> &subtitles) const;
+
+private:
+    /**
+     * Gets the path of a cache entry.
+     * @param key The key of the entry.
+     * @return The path to the entry.
+     */
+    [[nodiscard]]
+    QString entryPath(const QString &key) const;
+
+    /**
+     * Removes the least recently used entries until the cache is under its
+     * maximum size.
+     */
+    void evict() const;
+
+    /* The directory the cache is stored in */
+    const QString m_dir;
+};
+
+#endif // SUBTITLECACHE_H
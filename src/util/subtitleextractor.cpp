@@ -0,0 +1,312 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "subtitleextractor.h"
+
+#include <QDebug>
+#include <QStringList>
+#include <QUrl>
+
+#include <algorithm>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+/* The size of the first batch. Kept small so the list fills quickly. */
+#define FIRST_BATCH_SIZE    64
+
+/* The size of every batch after the first */
+#define BATCH_SIZE          1024
+
+/* The number of fields before the text in a decoded ASS event */
+#define ASS_TEXT_FIELD      8
+
+/* Begin Helpers */
+
+/**
+ * Interrupts blocking FFmpeg calls when the extraction is cancelled.
+ * @param opaque The CancellationToken of the extraction.
+ * @return 1 if cancelled, 0 otherwise.
+ */
+static int interruptCallback(void *opaque)
+{
+    return ((const CancellationToken *)opaque)->isCancelled() ? 1 : 0;
+}
+
+/**
+ * Gets the text of a decoded subtitle rectangle.
+ * @param rect The rectangle.
+ * @return The text of the rectangle without formatting.
+ */
+static QString rectText(const AVSubtitleRect *rect)
+{
+    if (rect->type == SUBTITLE_TEXT && rect->text)
+    {
+        return QString::fromUtf8(rect->text);
+    }
+    else if (rect->type != SUBTITLE_ASS || rect->ass == nullptr)
+    {
+        return QString();
+    }
+
+    /* Decoders turn every text format into an ASS event of the form
+     * ReadOrder,Layer,Style,Name,MarginL,MarginR,MarginV,Effect,Text */
+    const QString event = QString::fromUtf8(rect->ass);
+    qsizetype pos = 0;
+    for (int i = 0; i < ASS_TEXT_FIELD; ++i)
+    {
+        pos = event.indexOf(',', pos);
+        if (pos == -1)
+        {
+            return QString();
+        }
+        ++pos;
+    }
+    return SubtitleParser::filterASSText(QStringView(event).sliced(pos));
+}
+
+/**
+ * Decodes a subtitle packet.
+ * @param      codec     The decoder of the subtitle stream.
+ * @param      stream    The subtitle stream.
+ * @param      startTime The start time of the container in the time base of
+ *                       the stream.
+ * @param      packet    The packet to decode.
+ * @param[out] out       The list to add the decoded cue to.
+ */
+static void decodePacket(
+    AVCodecContext *codec,
+    const AVStream *stream,
+    int64_t startTime,
+    AVPacket *packet,
+    QList<SubtitleInfo> &out)
+{
+    AVSubtitle subtitle;
+    int gotSubtitle = 0;
+    if (avcodec_decode_subtitle2(codec, &subtitle, &gotSubtitle, packet) < 0 ||
+        !gotSubtitle)
+    {
+        return;
+    }
+
+    QStringList lines;
+    for (unsigned int i = 0; i < subtitle.num_rects; ++i)
+    {
+        QString line = rectText(subtitle.rects[i]);
+        if (!QStringView(line).trimmed().isEmpty())
+        {
+            lines << line;
+        }
+    }
+
+    if (packet->pts != AV_NOPTS_VALUE && !lines.isEmpty())
+    {
+        /* mpv rebases time-pos to the start of the container */
+        const double timeBase = av_q2d(stream->time_base);
+        const double pts = (packet->pts - startTime) * timeBase;
+
+        SubtitleInfo info;
+        info.text = lines.join('\n');
+        info.start = std::max(pts + subtitle.start_display_time / 1000.0, 0.0);
+        info.end = packet->duration > 0 ?
+            pts + packet->duration * timeBase :
+            pts + subtitle.end_display_time / 1000.0;
+        info.end = std::max(info.end, info.start);
+        out.append(info);
+    }
+
+    avsubtitle_free(&subtitle);
+}
+
+/**
+ * Sorts a batch of cues and hands it to the handler.
+ * @param      handler The handler to call. May be empty.
+ * @param[out] batch   The batch. Emptied.
+ * @param[out] out     The list to add the batch to.
+ */
+static void flushBatch(
+    const SubtitleParser::ChunkHandler &handler,
+    QList<SubtitleInfo> &batch,
+    QList<SubtitleInfo> &out)
+{
+    std::stable_sort(batch.begin(), batch.end(),
+        [] (const SubtitleInfo &lhs, const SubtitleInfo &rhs)
+        {
+            return lhs.start < rhs.start;
+        }
+    );
+    if (handler)
+    {
+        handler(batch);
+    }
+    out.append(batch);
+    batch.clear();
+}
+
+/* End Helpers */
+
+QList<SubtitleInfo> SubtitleExtractor::extract(
+    const QString &path,
+    int ffIndex,
+    const CancellationToken &token,
+    const SubtitleParser::ChunkHandler &handler)
+{
+    QList<SubtitleInfo> subtitles;
+    QList<SubtitleInfo> batch;
+    qsizetype batchSize = FIRST_BATCH_SIZE;
+    bool ok = false;
+
+    AVFormatContext *format = nullptr;
+    AVCodecContext *codec = nullptr;
+    AVPacket *packet = nullptr;
+    const AVCodec *decoder = nullptr;
+    const AVCodecDescriptor *descriptor = nullptr;
+    AVStream *stream = nullptr;
+    int64_t startTime = 0;
+
+    const QUrl url(path);
+    const QByteArray file =
+        (url.isLocalFile() ? url.toLocalFile() : path).toUtf8();
+
+    format = avformat_alloc_context();
+    if (format == nullptr)
+    {
+        goto cleanup;
+    }
+    format->interrupt_callback.callback = interruptCallback;
+    format->interrupt_callback.opaque = (void *)&token;
+    if (avformat_open_input(&format, file.constData(), nullptr, nullptr) < 0)
+    {
+        qDebug() << "Subtitle Extractor: Could not open" << path;
+        goto cleanup;
+    }
+    if (ffIndex < 0 || (unsigned int)ffIndex >= format->nb_streams)
+    {
+        qDebug() << "Subtitle Extractor: No stream" << ffIndex;
+        goto cleanup;
+    }
+
+    /* Only the subtitle stream is read into packets, everything else is
+     * skipped by the demuxer */
+    for (unsigned int i = 0; i < format->nb_streams; ++i)
+    {
+        format->streams[i]->discard =
+            i == (unsigned int)ffIndex ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+    }
+    stream = format->streams[ffIndex];
+    if (format->start_time != AV_NOPTS_VALUE)
+    {
+        /* AV_TIME_BASE_Q is a compound literal, which is not valid C++ */
+        startTime = av_rescale_q(
+            format->start_time, AVRational{1, AV_TIME_BASE}, stream->time_base
+        );
+    }
+
+    /* Bitmap subtitles have no text to list */
+    descriptor = avcodec_descriptor_get(stream->codecpar->codec_id);
+    if (stream->codecpar->codec_type != AVMEDIA_TYPE_SUBTITLE ||
+        descriptor == nullptr ||
+        !(descriptor->props & AV_CODEC_PROP_TEXT_SUB))
+    {
+        goto cleanup;
+    }
+
+    decoder = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (decoder == nullptr)
+    {
+        qDebug() << "Subtitle Extractor: No decoder for" << descriptor->name;
+        goto cleanup;
+    }
+    codec = avcodec_alloc_context3(decoder);
+    if (codec == nullptr ||
+        avcodec_parameters_to_context(codec, stream->codecpar) < 0)
+    {
+        goto cleanup;
+    }
+    codec->pkt_timebase = stream->time_base;
+    if (avcodec_open2(codec, decoder, nullptr) < 0)
+    {
+        qDebug() << "Subtitle Extractor: Could not open decoder";
+        goto cleanup;
+    }
+
+    packet = av_packet_alloc();
+    if (packet == nullptr)
+    {
+        goto cleanup;
+    }
+    while (!token.isCancelled())
+    {
+        const int ret = av_read_frame(format, packet);
+        if (ret == AVERROR_EOF)
+        {
+            ok = true;
+            break;
+        }
+        else if (ret < 0)
+        {
+            qDebug() << "Subtitle Extractor: Read error" << ret;
+            break;
+        }
+
+        if (packet->stream_index == ffIndex)
+        {
+            decodePacket(codec, stream, startTime, packet, batch);
+        }
+        av_packet_unref(packet);
+
+        if (batch.size() >= batchSize)
+        {
+            flushBatch(handler, batch, subtitles);
+            batchSize = BATCH_SIZE;
+        }
+    }
+    ok = ok && !token.isCancelled();
+    if (ok && !batch.isEmpty())
+    {
+        flushBatch(handler, batch, subtitles);
+    }
+
+cleanup:
+    av_packet_free(&packet);
+    avcodec_free_context(&codec);
+    avformat_close_input(&format);
+
+    if (!ok)
+    {
+        return QList<SubtitleInfo>();
+    }
+
+    /* Batches are in packet order, which is only roughly by start time */
+    std::stable_sort(subtitles.begin(), subtitles.end(),
+        [] (const SubtitleInfo &lhs, const SubtitleInfo &rhs)
+        {
+            return lhs.start < rhs.start;
+        }
+    );
+    return subtitles;
+}
+
+#undef FIRST_BATCH_SIZE
+#undef BATCH_SIZE
+#undef ASS_TEXT_FIELD
@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SUBTITLEEXTRACTOR_H
+#define SUBTITLEEXTRACTOR_H
+
+#include <QList>
+#include <QString>
+
+#include "dict/cancellationtoken.h"
+#include "subtitleparser.h"
+
+/**
+ * Reads embedded text subtitle tracks straight out of a media file. Every
+ * stream but the subtitle track is discarded by the demuxer and only subtitle
+ * packets are decoded, so a whole episode takes seconds instead of its
+ * runtime.
+ */
+class SubtitleExtractor
+{
+public:
+    /**
+     * Extracts every cue of an embedded text subtitle track.
+     * @param path    The path or local file URL of the media file.
+     * @param ffIndex The FFmpeg stream index of the track.
+     * @param token   Stops the extraction when cancelled.
+     * @param handler If set, called with cues in batches as they are read.
+     *                Batches follow the same rules as
+     *                SubtitleParser::ChunkHandler.
+     * @return The cues sorted by start time. Empty if the track isn't a text
+     *         track, the file can't be read, or the extraction was cancelled.
+     */
+    static QList<SubtitleInfo> extract(
+        const QString &path,
+        int ffIndex,
+        const CancellationToken &token,
+        const SubtitleParser::ChunkHandler &handler =
+            SubtitleParser::ChunkHandler());
+
+private:
+    SubtitleExtractor() {}
+};
+
+#endif // SUBTITLEEXTRACTOR_H
@@ -0,0 +1,233 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "subtitleindex.h"
+
+#include <algorithm>
+#include <cstdint>
+
+/* Subtrees at or below this level are scanned linearly instead of walked */
+#define SCAN_LEVEL 3
+
+/* Deeper than any tree over a 64-bit index can get */
+#define STACK_SIZE 128
+
+/* Begin Modifiers */
+
+qsizetype SubtitleIndex::insert(const std::shared_ptr<const SubtitleInfo> &info)
+{
+    const qsizetype pos = upperBound(info->start);
+    m_nodes.insert(
+        m_nodes.begin() + pos, Node{info->start, info->end, info->end, info}
+    );
+    m_dirty = true;
+    return pos;
+}
+
+void SubtitleIndex::insert(
+    qsizetype pos,
+    const std::vector<std::shared_ptr<const SubtitleInfo>> &infos)
+{
+    std::vector<Node> nodes;
+    nodes.reserve(infos.size());
+    for (const std::shared_ptr<const SubtitleInfo> &info : infos)
+    {
+        nodes.push_back(Node{info->start, info->end, info->end, info});
+    }
+    m_nodes.insert(m_nodes.begin() + pos, nodes.begin(), nodes.end());
+    m_dirty = true;
+}
+
+void SubtitleIndex::clear()
+{
+    m_nodes.clear();
+    m_rootLevel = 0;
+    m_dirty = false;
+}
+
+/* End Modifiers */
+/* Begin Accessors */
+
+qsizetype SubtitleIndex::size() const
+{
+    return m_nodes.size();
+}
+
+bool SubtitleIndex::isEmpty() const
+{
+    return m_nodes.empty();
+}
+
+const std::shared_ptr<const SubtitleInfo> &SubtitleIndex::at(
+    qsizetype pos) const
+{
+    return m_nodes[pos].info;
+}
+
+qsizetype SubtitleIndex::lowerBound(double time) const
+{
+    auto it = std::lower_bound(m_nodes.begin(), m_nodes.end(), time,
+        [] (const Node &node, double value)
+        {
+            return node.start < value;
+        }
+    );
+    return std::distance(m_nodes.begin(), it);
+}
+
+qsizetype SubtitleIndex::upperBound(double time) const
+{
+    auto it = std::upper_bound(m_nodes.begin(), m_nodes.end(), time,
+        [] (double value, const Node &node)
+        {
+            return value < node.start;
+        }
+    );
+    return std::distance(m_nodes.begin(), it);
+}
+
+/* End Accessors */
+/* Begin Queries */
+
+/* The tree is implicit in the sorted array. Leaves are at even positions and
+ * a node at level k is at a position whose lowest k bits are set, with its
+ * children 2^(k - 1) positions to either side. When the size isn't a power of
+ * two, some nodes are past the end of the array and only their left subtree
+ * exists. */
+
+void SubtitleIndex::build() const
+{
+    m_dirty = false;
+    const int64_t n = m_nodes.size();
+    if (n == 0)
+    {
+        m_rootLevel = 0;
+        return;
+    }
+
+    /* Tracks the maxEnd of the last node that exists on the path to the
+     * nodes past the end of the array */
+    int64_t lastPos = 0;
+    double lastEnd = 0.0;
+    for (int64_t i = 0; i < n; i += 2)
+    {
+        lastPos = i;
+        lastEnd = m_nodes[i].maxEnd = m_nodes[i].end;
+    }
+
+    int level = 1;
+    for (; (int64_t(1) << level) <= n; ++level)
+    {
+        const int64_t offset = int64_t(1) << (level - 1);
+        const int64_t step = offset << 2;
+        for (int64_t i = (offset << 1) - 1; i < n; i += step)
+        {
+            const double left = m_nodes[i - offset].maxEnd;
+            const double right =
+                i + offset < n ? m_nodes[i + offset].maxEnd : lastEnd;
+            m_nodes[i].maxEnd = std::max({m_nodes[i].end, left, right});
+        }
+
+        lastPos = (lastPos >> level) & 1 ? lastPos - offset : lastPos + offset;
+        if (lastPos < n && m_nodes[lastPos].maxEnd > lastEnd)
+        {
+            lastEnd = m_nodes[lastPos].maxEnd;
+        }
+    }
+    m_rootLevel = level - 1;
+}
+
+QList<qsizetype> SubtitleIndex::overlapping(double from, double to) const
+{
+    QList<qsizetype> positions;
+    if (m_nodes.empty())
+    {
+        return positions;
+    }
+    if (m_dirty)
+    {
+        build();
+    }
+
+    struct Frame
+    {
+        int64_t pos;
+        int level;
+        bool visited;
+    };
+    Frame stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = {(int64_t(1) << m_rootLevel) - 1, m_rootLevel, false};
+
+    /* An in-order walk, so positions come out sorted */
+    const int64_t n = m_nodes.size();
+    while (top > 0)
+    {
+        const Frame frame = stack[--top];
+        if (frame.level <= SCAN_LEVEL)
+        {
+            const int64_t begin = frame.pos >> frame.level << frame.level;
+            const int64_t end =
+                std::min(begin + (int64_t(1) << (frame.level + 1)) - 1, n);
+            for (int64_t i = begin; i < end && m_nodes[i].start <= to; ++i)
+            {
+                if (m_nodes[i].end >= from)
+                {
+                    positions.append(i);
+                }
+            }
+        }
+        else if (!frame.visited)
+        {
+            /* Skip the left subtree if everything in it ends too early */
+            const int64_t left = frame.pos - (int64_t(1) << (frame.level - 1));
+            stack[top++] = {frame.pos, frame.level, true};
+            if (left >= n || m_nodes[left].maxEnd >= from)
+            {
+                stack[top++] = {left, frame.level - 1, false};
+            }
+        }
+        else if (frame.pos < n && m_nodes[frame.pos].start <= to)
+        {
+            /* Everything in the right subtree starts after this node */
+            if (m_nodes[frame.pos].end >= from)
+            {
+                positions.append(frame.pos);
+            }
+            stack[top++] = {
+                frame.pos + (int64_t(1) << (frame.level - 1)),
+                frame.level - 1,
+                false
+            };
+        }
+    }
+
+    return positions;
+}
+
+QList<qsizetype> SubtitleIndex::covering(double time) const
+{
+    return overlapping(time, time);
+}
+
+/* End Queries */
+
+#undef SCAN_LEVEL
+#undef STACK_SIZE
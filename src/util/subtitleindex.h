@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SUBTITLEINDEX_H
+#define SUBTITLEINDEX_H
+
+#include <QList>
+
+#include <memory>
+#include <vector>
+
+#include "subtitleparser.h"
+
+/**
+ * An interval index over subtitles. Subtitles are kept sorted by start time,
+ * with subtitles that start at the same time kept in insertion order, so the
+ * position of a subtitle doubles as its row in a list.
+ *
+ * Time queries use an implicit interval tree laid over the sorted array. Every
+ * node stores the latest end time in its subtree, so finding the k subtitles
+ * that overlap a range takes O(log n + k) no matter how many cues overlap.
+ * The tree is rebuilt in O(n) by the first query after a change.
+ */
+class SubtitleIndex
+{
+public:
+    /**
+     * Adds a subtitle to the index after every subtitle with the same start
+     * time.
+     * @param info The subtitle to add.
+     * @return The position of the subtitle.
+     */
+    qsizetype insert(const std::shared_ptr<const SubtitleInfo> &info);
+
+    /**
+     * Adds subtitles that all belong at the same position in one move, as if
+     * insert() was called on each of them in order.
+     * @param pos   The position upperBound() gives for every subtitle.
+     * @param infos The subtitles sorted by start time.
+     */
+    void insert(
+        qsizetype pos,
+        const std::vector<std::shared_ptr<const SubtitleInfo>> &infos);
+
+    /**
+     * Removes every subtitle from the index.
+     */
+    void clear();
+
+    /**
+     * @return The number of subtitles in the index.
+     */
+    [[nodiscard]]
+    qsizetype size() const;
+
+    /**
+     * @return true if the index is empty, false otherwise.
+     */
+    [[nodiscard]]
+    bool isEmpty() const;
+
+    /**
+     * Gets the subtitle at a position.
+     * @param pos The position of the subtitle. Must be in range.
+     * @return The subtitle.
+     */
+    [[nodiscard]]
+    const std::shared_ptr<const SubtitleInfo> &at(qsizetype pos) const;
+
+    /**
+     * Finds the first subtitle that starts at or after a time.
+     * @param time The time in seconds.
+     * @return The position of the subtitle, size() if there is none.
+     */
+    [[nodiscard]]
+    qsizetype lowerBound(double time) const;
+
+    /**
+     * Finds the first subtitle that starts after a time.
+     * @param time The time in seconds.
+     * @return The position of the subtitle, size() if there is none.
+     */
+    [[nodiscard]]
+    qsizetype upperBound(double time) const;
+
+    /**
+     * Finds every subtitle that is shown at some point in a time range.
+     * @param from The start of the range in seconds.
+     * @param to   The end of the range in seconds. Inclusive.
+     * @return The positions of the subtitles in ascending order.
+     */
+    [[nodiscard]]
+    QList<qsizetype> overlapping(double from, double to) const;
+
+    /**
+     * Finds every subtitle that is shown at a time.
+     * @param time The time in seconds.
+     * @return The positions of the subtitles in ascending order.
+     */
+    [[nodiscard]]
+    QList<qsizetype> covering(double time) const;
+
+private:
+    /**
+     * Recomputes the latest end time of every subtree.
+     */
+    void build() const;
+
+    /* A subtitle in the index */
+    struct Node
+    {
+        /* The start time of the subtitle. Copied for locality. */
+        double start;
+
+        /* The end time of the subtitle. Copied for locality. */
+        double end;
+
+        /* The latest end time in the subtree rooted at this node */
+        double maxEnd;
+
+        /* The subtitle */
+        std::shared_ptr<const SubtitleInfo> info;
+    };
+
+    /* Subtitles sorted by start time */
+    mutable std::vector<Node> m_nodes;
+
+    /* The level of the root of the tree */
+    mutable int m_rootLevel = 0;
+
+    /* true if the tree must be rebuilt before the next query */
+    mutable bool m_dirty = false;
+};
+
+#endif // SUBTITLEINDEX_H
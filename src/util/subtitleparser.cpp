@@ -22,11 +22,500 @@
 
 #include <QDebug>
 #include <QFile>
-#include <QSet>
+#include <QStringDecoder>
+#include <QThreadPool>
 #include <QUrl>
+#include <QtConcurrent>
 
+#include <algorithm>
+#include <array>
 #include <limits>
 
+/* Begin Scanning Helpers */
+
+/**
+ * Reads lines out of text without copying them. Lines are returned without
+ * their trailing "\n" or "\r\n", the same as QTextStream::readLine().
+ */
+class LineReader
+{
+public:
+    /**
+     * Creates a reader over text.
+     * @param text       The text to read.
+     * @param lineNumber The line number of the line before text.
+     */
+    LineReader(QStringView text, int lineNumber = 0)
+        : m_text(text), m_lineNumber(lineNumber) {}
+
+    /**
+     * Returns if there are no more lines.
+     * @return true if every line has been read, false otherwise.
+     */
+    inline bool atEnd() const
+    {
+        return m_pos >= m_text.size();
+    }
+
+    /**
+     * Reads the next line.
+     * @return A view of the next line.
+     */
+    QStringView readLine()
+    {
+        qsizetype end = m_text.indexOf(u'\n', m_pos);
+        if (end == -1)
+        {
+            end = m_text.size();
+        }
+        QStringView line = m_text.sliced(m_pos, end - m_pos);
+        if (line.endsWith(u'\r'))
+        {
+            line.chop(1);
+        }
+        m_pos = end + 1;
+        ++m_lineNumber;
+        return line;
+    }
+
+    /**
+     * Returns the line number of the last line read.
+     * @return The 1-indexed line number of the last line read.
+     */
+    inline int lineNumber() const
+    {
+        return m_lineNumber;
+    }
+
+    /**
+     * Returns the position of the start of the next line.
+     * @return The index of the next line in the text.
+     */
+    inline qsizetype position() const
+    {
+        return std::min(m_pos, m_text.size());
+    }
+
+private:
+    /* The text being read */
+    QStringView m_text;
+
+    /* The position of the start of the next line */
+    qsizetype m_pos = 0;
+
+    /* The number of lines read */
+    int m_lineNumber;
+};
+
+/**
+ * Splits text like QString::split() without allocating.
+ * @param      text   The text to split.
+ * @param      sep    The separator to split on.
+ * @param[out] fields The first fields.size() fields of the text.
+ * @return The total number of fields in the text.
+ */
+template <size_t N>
+static qsizetype splitView(
+    QStringView text,
+    QChar sep,
+    std::array<QStringView, N> &fields)
+{
+    qsizetype count = 0;
+    qsizetype start = 0;
+    while (true)
+    {
+        qsizetype end = text.indexOf(sep, start);
+        if (count < (qsizetype)N)
+        {
+            fields[count] = text.sliced(
+                start, (end == -1 ? text.size() : end) - start
+            );
+        }
+        ++count;
+        if (end == -1)
+        {
+            return count;
+        }
+        start = end + 1;
+    }
+}
+
+/**
+ * Decodes a subtitle file. Files are assumed to be UTF-8 unless they start
+ * with a byte order mark.
+ * @param file The open file to decode.
+ * @return The decoded file.
+ */
+static QString decodeFile(QFile &file)
+{
+    const qint64 size = file.size();
+    if (size <= 0)
+    {
+        return QString();
+    }
+
+    /* Mapping avoids copying the whole file before decoding it */
+    QByteArray buffer;
+    const uchar *mapped = file.map(0, size);
+    QByteArrayView data;
+    if (mapped)
+    {
+        data = QByteArrayView(mapped, size);
+    }
+    else
+    {
+        buffer = file.readAll();
+        data = buffer;
+    }
+
+    QStringDecoder decoder(
+        QStringConverter::encodingForData(data)
+            .value_or(QStringConverter::Utf8)
+    );
+    QString text = decoder(data);
+
+    if (mapped)
+    {
+        file.unmap((uchar *)mapped);
+    }
+    return text;
+}
+
+/* End Scanning Helpers */
+/* Begin Tag Filters */
+
+/**
+ * Removes ASS override blocks ({\...}) and replaces \n and \N with newlines.
+ * @param text The text of an ASS dialogue line.
+ * @return The text without formatting.
+ */
+static QString filterASS(QStringView text)
+{
+    QString out;
+    out.reserve(text.size());
+    for (qsizetype i = 0; i < text.size(); ++i)
+    {
+        const QChar ch = text[i];
+        if (ch == u'{' && i + 1 < text.size() && text[i + 1] == u'\\')
+        {
+            const qsizetype close = text.indexOf(u'}', i + 2);
+            if (close != -1)
+            {
+                i = close;
+                continue;
+            }
+        }
+        else if ((ch == u'n' || ch == u'N') &&
+                 !out.isEmpty() && out.back() == u'\\')
+        {
+            /* Checked against the output so escapes split by an override
+             * block are still replaced */
+            out.back() = u'\n';
+            continue;
+        }
+        out += ch;
+    }
+    return out;
+}
+
+/**
+ * Returns if text starts with an optional '/' followed by b, i, or u and a
+ * closing character.
+ * @param text  The text after the opening character.
+ * @param close The closing character.
+ * @return The length of the tag after the opening character, 0 if there is
+ *         none.
+ */
+static qsizetype matchStyleTag(QStringView text, QChar close)
+{
+    qsizetype i = text.startsWith(u'/') ? 1 : 0;
+    if (i + 1 < text.size() &&
+        (text[i] == u'b' || text[i] == u'i' || text[i] == u'u') &&
+        text[i + 1] == close)
+    {
+        return i + 2;
+    }
+    return 0;
+}
+
+/**
+ * Removes SRT formatting. Matches <b> <i> <u> {b} {i} {u}, their closing
+ * tags, <font ...> </font>, and {\a#} {\an#}.
+ * @param text The text of an SRT subtitle.
+ * @return The text without formatting.
+ */
+static QString filterSRT(QStringView text)
+{
+    QString out;
+    out.reserve(text.size());
+    for (qsizetype i = 0; i < text.size(); ++i)
+    {
+        const QChar ch = text[i];
+        const QStringView rest = text.sliced(i + 1);
+        qsizetype length = 0;
+        if (ch == u'<')
+        {
+            length = matchStyleTag(rest, u'>');
+            const qsizetype font = rest.startsWith(u'/') ? 1 : 0;
+            if (length == 0 && rest.sliced(font).startsWith(u"font"))
+            {
+                /* Font tags end at the first '>' on the same line */
+                for (qsizetype j = font + 4; j < rest.size(); ++j)
+                {
+                    if (rest[j] == u'\n')
+                    {
+                        break;
+                    }
+                    else if (rest[j] == u'>')
+                    {
+                        length = j + 1;
+                        break;
+                    }
+                }
+            }
+        }
+        else if (ch == u'{')
+        {
+            length = matchStyleTag(rest, u'}');
+            if (length == 0 && rest.startsWith(u"\\a"))
+            {
+                const qsizetype digit = rest.sliced(2).startsWith(u'n') ?
+                    3 : 2;
+                if (digit + 1 < rest.size() &&
+                    rest[digit].isDigit() &&
+                    rest[digit + 1] == u'}')
+                {
+                    length = digit + 2;
+                }
+            }
+        }
+
+        if (length)
+        {
+            i += length;
+            continue;
+        }
+        out += ch;
+    }
+    return out;
+}
+
+/**
+ * Removes everything between angle braces.
+ * @param text The text of a VTT subtitle.
+ * @return The text without formatting.
+ */
+static QString filterVTT(QStringView text)
+{
+    QString out;
+    out.reserve(text.size());
+    qsizetype i = 0;
+    while (i < text.size())
+    {
+        const qsizetype open = text.indexOf(u'<', i);
+        const qsizetype close = open == -1 ? -1 : text.indexOf(u'>', open);
+        if (close == -1)
+        {
+            out += text.sliced(i);
+            break;
+        }
+        out += text.sliced(i, open - i);
+        i = close + 1;
+    }
+    return out;
+}
+
+/* End Tag Filters */
+/* Begin Chunking */
+
+/* Files smaller than twice this many characters are parsed in one piece */
+#define CHUNK_MIN_SIZE      (1 << 16)
+
+/* Chunks to aim for per thread so a slow chunk doesn't hold up the rest */
+#define CHUNKS_PER_THREAD   4
+
+/**
+ * Parses whole lines or cues of a subtitle file.
+ * @param      text      The text to parse.
+ * @param      firstLine The line number of the line before text.
+ * @param[out] out       The list the resulting SubtitleInfos are saved to.
+ * @return true on success, false on error.
+ */
+using ChunkParser =
+    std::function<bool(QStringView, int, QList<SubtitleInfo> &)>;
+
+/**
+ * A piece of a subtitle file that can be parsed on its own.
+ */
+struct SubtitleChunk
+{
+    /* The text of the chunk */
+    QStringView text;
+
+    /* The line number of the line before the chunk */
+    int firstLine;
+};
+
+/**
+ * Finds the end of the chunk that contains a position.
+ * @param text The text being split.
+ * @param from The position the chunk should at least reach.
+ * @param cues true if chunks have to end on an empty line, false if any line
+ *             break will do.
+ * @return The position after the end of the chunk.
+ */
+static qsizetype findChunkEnd(QStringView text, qsizetype from, bool cues)
+{
+    qsizetype end = text.indexOf(u'\n', from);
+    while (cues && end != -1)
+    {
+        /* Every parser ends a cue on an empty line, so the line after one
+         * always starts a new cue */
+        const QStringView next = text.sliced(end + 1);
+        if (next.startsWith(u'\n'))
+        {
+            return end + 2;
+        }
+        else if (next.startsWith(u"\r\n"))
+        {
+            return end + 3;
+        }
+        end = text.indexOf(u'\n', end + 1);
+    }
+    return end == -1 ? text.size() : end + 1;
+}
+
+/**
+ * Splits text into chunks that can be parsed independently.
+ * @param text      The text to split.
+ * @param firstLine The line number of the line before text.
+ * @param cues      true if chunks have to end on an empty line, false if any
+ *                  line break will do.
+ * @return The chunks in file order. Never empty.
+ */
+static QList<SubtitleChunk> splitChunks(
+    QStringView text,
+    int firstLine,
+    bool cues)
+{
+    const qsizetype threads =
+        std::max(QThreadPool::globalInstance()->maxThreadCount(), 1);
+    const qsizetype chunkSize = std::max<qsizetype>(
+        CHUNK_MIN_SIZE, text.size() / (threads * CHUNKS_PER_THREAD)
+    );
+
+    QList<SubtitleChunk> chunks;
+
+    /* The first chunk is kept small so the start of the file is ready as
+     * soon as possible */
+    qsizetype target = CHUNK_MIN_SIZE;
+    qsizetype start = 0;
+    while (start < text.size())
+    {
+        const qsizetype end = text.size() - start < target + CHUNK_MIN_SIZE ?
+            text.size() : findChunkEnd(text, start + target, cues);
+        const QStringView chunk = text.sliced(start, end - start);
+        chunks.append({chunk, firstLine});
+        firstLine += chunk.count(u'\n');
+        start = end;
+        target = chunkSize;
+    }
+    if (chunks.isEmpty())
+    {
+        chunks.append({text, firstLine});
+    }
+    return chunks;
+}
+
+/**
+ * Parses text a chunk at a time. Chunks are parsed concurrently when there is
+ * more than one.
+ * @param      text      The text to parse.
+ * @param      firstLine The line number of the line before text.
+ * @param      cues      true if chunks have to end on an empty line, false if
+ *                       any line break will do.
+ * @param      parse     Parses a single chunk.
+ * @param      handler   Called with each chunk in order. May be empty.
+ * @param[out] out       The list the resulting SubtitleInfos are saved to,
+ *                       sorted by start time.
+ * @return true if every chunk parsed, false otherwise.
+ */
+static bool parseChunks(
+    QStringView text,
+    int firstLine,
+    bool cues,
+    const ChunkParser &parse,
+    const SubtitleParser::ChunkHandler &handler,
+    QList<SubtitleInfo> &out)
+{
+    const QList<SubtitleChunk> chunks = splitChunks(text, firstLine, cues);
+    if (chunks.size() == 1)
+    {
+        if (!parse(text, firstLine, out))
+        {
+            return false;
+        }
+        if (handler)
+        {
+            handler(out);
+        }
+        return true;
+    }
+
+    using ChunkResult = std::pair<bool, QList<SubtitleInfo>>;
+    QList<QFuture<ChunkResult>> futures;
+    futures.reserve(chunks.size());
+    for (const SubtitleChunk &chunk : chunks)
+    {
+        futures.append(QtConcurrent::run(
+            [parse, chunk]
+            {
+                ChunkResult result;
+                result.first =
+                    parse(chunk.text, chunk.firstLine, result.second);
+                return result;
+            }
+        ));
+    }
+
+    /* Collect in file order so the handler sees the start of the file first.
+     * Every future has to finish before returning since they all view the
+     * same text. */
+    bool ok = true;
+    for (QFuture<ChunkResult> &future : futures)
+    {
+        const ChunkResult result = future.result();
+        ok = ok && result.first;
+        if (!ok)
+        {
+            continue;
+        }
+        out.append(result.second);
+        if (handler)
+        {
+            handler(result.second);
+        }
+    }
+    if (!ok)
+    {
+        return false;
+    }
+
+    /* Chunks are already sorted, so keep ties in file order */
+    std::stable_sort(out.begin(), out.end(),
+        [] (const SubtitleInfo &lhs, const SubtitleInfo &rhs)
+        {
+            return lhs.start < rhs.start;
+        }
+    );
+    return true;
+}
+
+#undef CHUNK_MIN_SIZE
+#undef CHUNKS_PER_THREAD
+
+/* End Chunking */
+
 /**
  * Information about an SRT subtitle.
  */
@@ -51,30 +540,20 @@ struct SRTInfo : public SubtitleInfo
     }
 };
 
-SubtitleParser::SubtitleParser()
-    : m_timecodeSplitter(QRegularExpression("[:\\.,]")),
-      m_assFilter(QRegularExpression("{\\\\.*?}")),
-      m_assNewLineReplacer(QRegularExpression("\\\\n|\\\\N")),
-      m_srtFilter(
-          QRegularExpression(
-              "<\\/?[biu]>|"   // Removes <b></b> <i></i> <u></u>
-              "{\\/?[biu]}|"   // Removes {b}{/b} {i}{/i} {u}{/u}
-              "<\\/?font.*?>|" // Removes <font color=“white”> </font>
-              "{\\\\an?\\d}"   // Removes {\a#} {\an#}
-          )
-      ),
-      m_angleBraceCleaner(QRegularExpression("<[^>]*>"))
+QString SubtitleParser::filterASSText(QStringView text)
 {
-    m_vttSections << "NOTE" << "STYLE" << "REGION";
+    return filterASS(text);
 }
 
-QList<SubtitleInfo> SubtitleParser::parseSubtitles(const QString &path) const
+QList<SubtitleInfo> SubtitleParser::parseSubtitles(
+    const QString &path,
+    const ChunkHandler &handler) const
 {
     QList<SubtitleInfo> subtitles;
 
     QUrl url(path);
     QFile file(url.isLocalFile() ? url.toLocalFile() : path);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    if (!file.open(QIODevice::ReadOnly))
     {
         qDebug() << "Subtitle Parser: Could not open file";
         qDebug() << path;
@@ -82,29 +561,47 @@ QList<SubtitleInfo> SubtitleParser::parseSubtitles(const QString &path) const
         return subtitles;
     }
 
+    bool ok = true;
     QString lowerPath = path.toLower();
     if (lowerPath.endsWith(".ass"))
     {
-        if (!parseASS(file, subtitles))
-        {
-            return QList<SubtitleInfo>();
-        }
+        const QString text = decodeFile(file);
+        LineReader in(text);
+        ASSFormat format;
+        ok = parseASSHeader(in, format) &&
+            parseChunks(
+                QStringView(text).sliced(in.position()), in.lineNumber(),
+                false,
+                [&format] (
+                    QStringView chunk,
+                    int firstLine,
+                    QList<SubtitleInfo> &out)
+                {
+                    return parseASSEvents(chunk, firstLine, format, out);
+                },
+                handler, subtitles
+            );
     }
     else if (lowerPath.endsWith(".srt"))
     {
-        if (!parseSRT(file, subtitles))
-        {
-            return QList<SubtitleInfo>();
-        }
+        const QString text = decodeFile(file);
+        ok = parseChunks(text, 0, true, &parseSRT, handler, subtitles);
     }
     else if (lowerPath.endsWith(".vtt"))
     {
-        if (!parseVTT(file, subtitles))
-        {
-            return QList<SubtitleInfo>();
-        }
+        const QString text = decodeFile(file);
+        LineReader in(text);
+        ok = parseVTTHeader(in) &&
+            parseChunks(
+                QStringView(text).sliced(in.position()), in.lineNumber(),
+                true, &parseVTT, handler, subtitles
+            );
     }
 
+    if (!ok)
+    {
+        return QList<SubtitleInfo>();
+    }
     return subtitles;
 }
 
@@ -120,11 +617,8 @@ QList<SubtitleInfo> SubtitleParser::parseSubtitles(const QString &path) const
 #define END_FORMAT      "End"
 #define TEXT_FORMAT     "Text"
 
-bool SubtitleParser::parseASS(QFile &file, QList<SubtitleInfo> &out) const
+bool SubtitleParser::parseASSHeader(LineReader &in, ASSFormat &format)
 {
-    QTextStream in(&file);
-    int lineNumber = 0;
-
     /* Make sure the file isn't empty */
     if (in.atEnd())
     {
@@ -133,12 +627,11 @@ bool SubtitleParser::parseASS(QFile &file, QList<SubtitleInfo> &out) const
     }
 
     /* Check for the header */
-    ++lineNumber;
-    QString currentLine = in.readLine();
-    if (currentLine.trimmed() != ASS_HEADER)
+    QStringView currentLine = in.readLine();
+    if (currentLine.trimmed() != QLatin1String(ASS_HEADER))
     {
         qDebug() << "ASS Parser: Missing ASS header";
-        qDebug() << "Line Number " << lineNumber;
+        qDebug() << "Line Number " << in.lineNumber();
         qDebug() << currentLine;
         return false;
     }
@@ -146,9 +639,8 @@ bool SubtitleParser::parseASS(QFile &file, QList<SubtitleInfo> &out) const
     /* Skip to the [Events] section */
     while (!in.atEnd())
     {
-        ++lineNumber;
         currentLine = in.readLine();
-        if (currentLine.trimmed() == EVENT_HEADER)
+        if (currentLine.trimmed() == QLatin1String(EVENT_HEADER))
         {
             break;
         }
@@ -161,94 +653,134 @@ bool SubtitleParser::parseASS(QFile &file, QList<SubtitleInfo> &out) const
     }
 
     /* Get format section */
-    ++lineNumber;
     currentLine = in.readLine();
-    if (!currentLine.startsWith(FORMAT_PREFIX))
+    if (!currentLine.startsWith(QLatin1String(FORMAT_PREFIX)))
     {
         qDebug() << "ASS Parser: Missing Format line in the [Events] section";
-        qDebug() << "Line Number " << lineNumber;
+        qDebug() << "Line Number " << in.lineNumber();
         qDebug() << currentLine;
         return false;
     }
-    int startIndex = -1;
-    int endIndex = -1;
-    int textIndex = -1;
-    QStringList format =
-        currentLine
-            .right(currentLine.size() - sizeof(FORMAT_PREFIX) + 1)
-            .split(',');
-    for (int i = 0; i < format.size(); ++i)
+    const QStringView formatLine =
+        currentLine.sliced(sizeof(FORMAT_PREFIX) - 1);
+    for (qsizetype pos = 0; pos <= formatLine.size(); ++format.size)
     {
-        if (format[i].trimmed() == START_FORMAT)
+        qsizetype comma = formatLine.indexOf(u',', pos);
+        if (comma == -1)
         {
-            if (startIndex != -1)
+            comma = formatLine.size();
+        }
+        const QStringView field =
+            formatLine.sliced(pos, comma - pos).trimmed();
+        pos = comma + 1;
+
+        if (field == QLatin1String(START_FORMAT))
+        {
+            if (format.start != -1)
             {
                 qDebug() << "ASS Parser: Start format redefinition";
-                qDebug() << "Line Number " << lineNumber;
+                qDebug() << "Line Number " << in.lineNumber();
                 return false;
             }
-            startIndex = i;
+            format.start = format.size;
         }
-        else if (format[i].trimmed() == END_FORMAT)
+        else if (field == QLatin1String(END_FORMAT))
         {
-            if (endIndex != -1)
+            if (format.end != -1)
             {
                 qDebug() << "ASS Parser: End format redefinition";
-                qDebug() << "Line Number " << lineNumber;
+                qDebug() << "Line Number " << in.lineNumber();
                 return false;
             }
-            endIndex = i;
+            format.end = format.size;
         }
-        else if (format[i].trimmed() == TEXT_FORMAT)
+        else if (field == QLatin1String(TEXT_FORMAT))
         {
-            if (textIndex != -1)
+            if (format.text != -1)
             {
                 qDebug() << "ASS Parser: Text format redefinition";
-                qDebug() << "Line Number " << lineNumber;
+                qDebug() << "Line Number " << in.lineNumber();
                 return false;
             }
-            textIndex = i;
+            format.text = format.size;
         }
     }
-    if (startIndex == -1)
+    if (format.start == -1)
     {
         qDebug() << "ASS Parser: Format missing start section";
-        qDebug() << "Line Number " << lineNumber;
+        qDebug() << "Line Number " << in.lineNumber();
         return false;
     }
-    else if (endIndex == -1)
+    else if (format.end == -1)
     {
         qDebug() << "ASS Parser: Format missing end section";
-        qDebug() << "Line Number " << lineNumber;
+        qDebug() << "Line Number " << in.lineNumber();
         return false;
     }
-    else if (textIndex == -1)
+    else if (format.text == -1)
     {
         qDebug() << "ASS Parser: Format missing text section";
-        qDebug() << "Line Number " << lineNumber;
+        qDebug() << "Line Number " << in.lineNumber();
         return false;
     }
 
+    return true;
+}
+
+bool SubtitleParser::parseASSEvents(
+    QStringView text,
+    int firstLine,
+    const ASSFormat &format,
+    QList<SubtitleInfo> &out)
+{
+    LineReader in(text, firstLine);
+
     /* Get dialogue */
     while (!in.atEnd())
     {
         /* Skip non-dialogue lines */
-        ++lineNumber;
-        currentLine = in.readLine();
-        if (!currentLine.startsWith(DIALOGUE_PREFIX))
+        const QStringView currentLine = in.readLine();
+        if (!currentLine.startsWith(QLatin1String(DIALOGUE_PREFIX)))
         {
             continue;
         }
 
-        /* Split dialogue line */
-        QStringList dialogue =
-            currentLine
-                .right(currentLine.size() - sizeof(DIALOGUE_PREFIX) + 1)
-                .split(',');
-        if (dialogue.size() < format.size())
+        /* Find the fields of the dialogue line. Text is everything from the
+         * start of the text field to the end of the line. */
+        const QStringView dialogue =
+            currentLine.sliced(sizeof(DIALOGUE_PREFIX) - 1);
+        QStringView startField;
+        QStringView endField;
+        qsizetype textStart = -1;
+        qsizetype pos = 0;
+        int field = 0;
+        for (; field < format.size; ++field)
+        {
+            qsizetype comma = dialogue.indexOf(u',', pos);
+            const qsizetype fieldEnd = comma == -1 ? dialogue.size() : comma;
+            if (field == format.start)
+            {
+                startField = dialogue.sliced(pos, fieldEnd - pos);
+            }
+            else if (field == format.end)
+            {
+                endField = dialogue.sliced(pos, fieldEnd - pos);
+            }
+            else if (field == format.text)
+            {
+                textStart = pos;
+            }
+
+            if (comma == -1)
+            {
+                break;
+            }
+            pos = comma + 1;
+        }
+        if (field < format.size - 1)
         {
             qDebug() << "ASS Parser: Dialogue-Format mismatch";
-            qDebug() << "Line Number " << lineNumber;
+            qDebug() << "Line Number " << in.lineNumber();
             return false;
         }
 
@@ -257,35 +789,33 @@ bool SubtitleParser::parseASS(QFile &file, QList<SubtitleInfo> &out) const
 
         /* Get timings */
         bool ok = false;
-        info.start = timecodeToDouble(dialogue[startIndex], &ok);
+        info.start = timecodeToDouble(startField, &ok);
         if (!ok || info.start < 0)
         {
             qDebug() << "ASS Parser: Invalid start time";
-            qDebug() << "Line Number " << lineNumber;
-            qDebug() << dialogue[startIndex];
+            qDebug() << "Line Number " << in.lineNumber();
+            qDebug() << startField;
             return false;
         }
-        info.end = timecodeToDouble(dialogue[endIndex], &ok);
+        info.end = timecodeToDouble(endField, &ok);
         if (!ok || info.end < info.start)
         {
             qDebug() << "ASS Parser: Invalid end time";
-            qDebug() << "Line Number " << lineNumber;
-            qDebug() << dialogue[endIndex];
+            qDebug() << "Line Number " << in.lineNumber();
+            qDebug() << endField;
             return false;
         }
 
-        /* Get Text */
-        info.text = dialogue[textIndex];
-        for (int i = textIndex + 1; i < dialogue.size(); ++i)
+        /* Throw out empty subtitles before allocating anything */
+        const QStringView rawText = dialogue.sliced(textStart);
+        if (rawText.trimmed().isEmpty())
         {
-            info.text += ',';
-            info.text += dialogue[i];
+            continue;
         }
-        info.text.remove(m_assFilter);
-        info.text.replace(m_assNewLineReplacer, "\n");
 
-        /* Throw out empty subtitles */
-        if (info.text.trimmed().isEmpty())
+        /* Get Text */
+        info.text = filterASS(rawText);
+        if (QStringView(info.text).trimmed().isEmpty())
         {
             continue;
         }
@@ -321,22 +851,25 @@ bool SubtitleParser::parseASS(QFile &file, QList<SubtitleInfo> &out) const
 
 #define TIMING_ARROW "-->"
 
-bool SubtitleParser::parseSRT(QFile &file, QList<SubtitleInfo> &out) const
+bool SubtitleParser::parseSRT(
+    QStringView text,
+    int firstLine,
+    QList<SubtitleInfo> &out)
 {
     QList<SRTInfo> subs;
 
-    QTextStream in(&file);
-    int lineNumber = 0;
+    /* Reused between subtitles to join lines without allocating */
+    QString lines;
+
+    LineReader in(text, firstLine);
     while (!in.atEnd())
     {
         SRTInfo info;
 
         /* Skip all new lines */
-        ++lineNumber;
-        QString currentLine = in.readLine();
+        QStringView currentLine = in.readLine();
         while (!in.atEnd() && currentLine.isEmpty())
         {
-            ++lineNumber;
             currentLine = in.readLine();
         }
         if (in.atEnd())
@@ -350,7 +883,7 @@ bool SubtitleParser::parseSRT(QFile &file, QList<SubtitleInfo> &out) const
         if (!ok || info.position < 0)
         {
             qDebug() << "SRT Parser: Invalid position";
-            qDebug() << "Line Number " << lineNumber;
+            qDebug() << "Line Number " << in.lineNumber();
             qDebug() << currentLine;
             return false;
         }
@@ -359,23 +892,22 @@ bool SubtitleParser::parseSRT(QFile &file, QList<SubtitleInfo> &out) const
         if (in.atEnd())
         {
             qDebug() << "SRT Parser: Unexpected file end after position";
-            qDebug() << "Line Number " << lineNumber;
+            qDebug() << "Line Number " << in.lineNumber();
             return false;
         }
-        ++lineNumber;
         currentLine = in.readLine();
-        QStringList timing = currentLine.trimmed().split(' ');
-        if (timing.size() != 3)
+        std::array<QStringView, 3> timing;
+        if (splitView(currentLine.trimmed(), u' ', timing) != 3)
         {
             qDebug() << "SRT Parser: Invalid timing";
-            qDebug() << "Line Number " << lineNumber;
+            qDebug() << "Line Number " << in.lineNumber();
             qDebug() << currentLine;
             return false;
         }
-        if (timing[TIMING_ARROW_INDEX] != TIMING_ARROW)
+        if (timing[TIMING_ARROW_INDEX] != QLatin1String(TIMING_ARROW))
         {
             qDebug() << "SRT Parser: Missing timing arrow";
-            qDebug() << "Line Number " << lineNumber;
+            qDebug() << "Line Number " << in.lineNumber();
             qDebug() << currentLine;
             return false;
         }
@@ -383,7 +915,7 @@ bool SubtitleParser::parseSRT(QFile &file, QList<SubtitleInfo> &out) const
         if (!ok || info.start < 0.0)
         {
             qDebug() << "SRT Parser: Invalid start time";
-            qDebug() << "Line Number " << lineNumber;
+            qDebug() << "Line Number " << in.lineNumber();
             qDebug() << timing[TIMING_START_INDEX];
             return false;
         }
@@ -391,7 +923,7 @@ bool SubtitleParser::parseSRT(QFile &file, QList<SubtitleInfo> &out) const
         if (!ok || info.end < info.start)
         {
             qDebug() << "SRT Parser: Invalid end time";
-            qDebug() << "Line Number " << lineNumber;
+            qDebug() << "Line Number " << in.lineNumber();
             qDebug() << timing[TIMING_END_INDEX];
             return false;
         }
@@ -400,25 +932,26 @@ bool SubtitleParser::parseSRT(QFile &file, QList<SubtitleInfo> &out) const
         if (in.atEnd())
         {
             qDebug() << "SRT Parser: Unexpected file end after timings";
-            qDebug() << "Line Number " << lineNumber;
+            qDebug() << "Line Number " << in.lineNumber();
             return false;
         }
+        lines.resize(0);
         while (!in.atEnd())
         {
-            if (++lineNumber; (currentLine = in.readLine()).isEmpty())
+            if ((currentLine = in.readLine()).isEmpty())
             {
                 break;
             }
-            info.text += currentLine;
-            info.text += '\n';
+            lines += currentLine;
+            lines += u'\n';
         }
-        info.text.chop(1);
+        lines.chop(1);
 
         /* Filter out SRT formatting */
-        info.text.remove(m_srtFilter);
+        info.text = filterSRT(lines);
 
         /* Don't add if the subtitle is only whitespace */
-        if (info.text.trimmed().isEmpty())
+        if (QStringView(info.text).trimmed().isEmpty())
         {
             continue;
         }
@@ -435,6 +968,7 @@ bool SubtitleParser::parseSRT(QFile &file, QList<SubtitleInfo> &out) const
                    lhs.position < rhs.position);
         }
     );
+    out.reserve(out.size() + subs.size());
     for (const SRTInfo &info : subs)
     {
         out << info;
@@ -455,11 +989,23 @@ bool SubtitleParser::parseSRT(QFile &file, QList<SubtitleInfo> &out) const
 #define VTT_HEADER      "WEBVTT"
 #define TIMING_ARROW    "-->"
 
-bool SubtitleParser::parseVTT(QFile &file, QList<SubtitleInfo> &out) const
+/**
+ * Returns if a line starts a special VTT section.
+ * @param line The line to check.
+ * @return true if the line starts a NOTE, STYLE, or REGION block, false
+ *         otherwise.
+ */
+static bool isVTTSection(QStringView line)
 {
-    int lineNumber = 0;
-    QTextStream in(&file);
+    const qsizetype space = line.indexOf(u' ');
+    const QStringView word = space == -1 ? line : line.first(space);
+    return word == QLatin1String("NOTE") ||
+           word == QLatin1String("STYLE") ||
+           word == QLatin1String("REGION");
+}
 
+bool SubtitleParser::parseVTTHeader(LineReader &in)
+{
     /* Exit if the file is empty */
     if (in.atEnd())
     {
@@ -467,38 +1013,49 @@ bool SubtitleParser::parseVTT(QFile &file, QList<SubtitleInfo> &out) const
         return false;
     }
     /* Exit if the file is missing the header */
-    else if (++lineNumber; !in.readLine().startsWith(VTT_HEADER))
+    else if (!in.readLine().startsWith(QLatin1String(VTT_HEADER)))
     {
         qDebug() << "VTT Parser: Missing VTT header";
-        qDebug() << "Line Number " << lineNumber;
+        qDebug() << "Line Number " << in.lineNumber();
         return false;
     }
 
     /* Skip past header info */
     while (!in.atEnd())
     {
-        if (++lineNumber; in.readLine().trimmed().isEmpty())
+        if (in.readLine().trimmed().isEmpty())
         {
             break;
         }
     }
 
+    return true;
+}
+
+bool SubtitleParser::parseVTT(
+    QStringView text,
+    int firstLine,
+    QList<SubtitleInfo> &out)
+{
+    LineReader in(text, firstLine);
+
+    /* Reused between subtitles to join lines without allocating */
+    QString lines;
+
     /* Read subtitles */
     while (!in.atEnd())
     {
-        ++lineNumber;
-        QString currentLine = in.readLine().trimmed();
+        QStringView currentLine = in.readLine().trimmed();
         /* Skip empty lines */
         if (currentLine.isEmpty())
         {
             continue;
         }
         /* Skip non-subtitle sections */
-        else if (m_vttSections.contains(currentLine.split(' ')[0]))
+        else if (isVTTSection(currentLine))
         {
             while (!in.atEnd())
             {
-                ++lineNumber;
                 currentLine = in.readLine();
                 if (currentLine.trimmed().isEmpty())
                 {
@@ -511,22 +1068,22 @@ bool SubtitleParser::parseVTT(QFile &file, QList<SubtitleInfo> &out) const
         SubtitleInfo info;
 
         /* Get timings */
-        QStringList timings = currentLine.split(' ');
-        if (timings.size() < 3 || timings[TIMING_ARROW_INDEX] != TIMING_ARROW)
+        std::array<QStringView, 3> timings;
+        if (splitView(currentLine, u' ', timings) < 3 ||
+            timings[TIMING_ARROW_INDEX] != QLatin1String(TIMING_ARROW))
         {
             if (in.atEnd())
             {
                 qDebug() << "VTT Parser: Unexpected file end after cue";
-                qDebug() << "Line Number " << lineNumber;
+                qDebug() << "Line Number " << in.lineNumber();
                 return false;
             }
-            ++lineNumber;
             currentLine = in.readLine();
-            timings = currentLine.split(' ');
-            if (timings.size() < 3 || timings[TIMING_ARROW_INDEX] != TIMING_ARROW)
+            if (splitView(currentLine, u' ', timings) < 3 ||
+                timings[TIMING_ARROW_INDEX] != QLatin1String(TIMING_ARROW))
             {
                 qDebug() << "VTT Parser: Invalid timing line";
-                qDebug() << "Line Number " << lineNumber;
+                qDebug() << "Line Number " << in.lineNumber();
                 qDebug() << currentLine;
                 return false;
             }
@@ -536,7 +1093,7 @@ bool SubtitleParser::parseVTT(QFile &file, QList<SubtitleInfo> &out) const
         if (!ok || info.start < 0.0)
         {
             qDebug() << "VTT Parser: Invalid start time";
-            qDebug() << "Line Number " << lineNumber;
+            qDebug() << "Line Number " << in.lineNumber();
             qDebug() << timings[TIMING_START_INDEX];
             return false;
         }
@@ -544,7 +1101,7 @@ bool SubtitleParser::parseVTT(QFile &file, QList<SubtitleInfo> &out) const
         if (!ok || info.end < info.start)
         {
             qDebug() << "VTT Parser: Invalid end time";
-            qDebug() << "Line Number " << lineNumber;
+            qDebug() << "Line Number " << in.lineNumber();
             qDebug() << timings[TIMING_END_INDEX];
             return false;
         }
@@ -553,25 +1110,26 @@ bool SubtitleParser::parseVTT(QFile &file, QList<SubtitleInfo> &out) const
         if (in.atEnd())
         {
             qDebug() << "VTT Parser: Unexpected file end after timings";
-            qDebug() << "Line Number " << lineNumber;
+            qDebug() << "Line Number " << in.lineNumber();
             return false;
         }
+        lines.resize(0);
         while (!in.atEnd())
         {
-            if (++lineNumber; (currentLine = in.readLine()).isEmpty())
+            if ((currentLine = in.readLine()).isEmpty())
             {
                 break;
             }
-            info.text += currentLine;
-            info.text += '\n';
+            lines += currentLine;
+            lines += u'\n';
         }
-        info.text.chop(1);
+        lines.chop(1);
 
         /* Filter out VTT angle brace formatting */
-        info.text.remove(m_angleBraceCleaner);
+        info.text = filterVTT(lines);
 
         /* Don't add if the subtitle is only whitespace */
-        if (info.text.trimmed().isEmpty())
+        if (QStringView(info.text).trimmed().isEmpty())
         {
             continue;
         }
@@ -601,20 +1159,37 @@ bool SubtitleParser::parseVTT(QFile &file, QList<SubtitleInfo> &out) const
 #define SECONDS_IN_MILLISECOND  0.001
 #define SECONDS_IN_HUNDREDTH    0.01
 
-double SubtitleParser::timecodeToDouble(const QString &timecode, bool *ok) const
+double SubtitleParser::timecodeToDouble(QStringView timecode, bool *ok)
 {
     double timeDouble = 0.0;
     int tmp;
+    bool localOk;
 
-    QStringList pieces = timecode.trimmed().split(m_timecodeSplitter);
-    std::reverse(pieces.begin(), pieces.end());
-    if (pieces.length() != 3 && pieces.length() != 4)
+    /* Split on ':', '.', and ',' from the right, so pieces[0] is the
+     * sub-second value */
+    std::array<QStringView, 4> pieces;
+    qsizetype count = 0;
+    timecode = timecode.trimmed();
+    qsizetype end = timecode.size();
+    for (qsizetype i = timecode.size() - 1; i >= -1; --i)
+    {
+        if (i == -1 ||
+            timecode[i] == u':' || timecode[i] == u'.' || timecode[i] == u',')
+        {
+            if (count == (qsizetype)pieces.size())
+            {
+                goto error;
+            }
+            pieces[count++] = timecode.sliced(i + 1, end - i - 1);
+            end = i;
+        }
+    }
+    if (count != 3 && count != 4)
     {
         goto error;
     }
 
     /* Get sub-second values */
-    bool localOk;
     if (pieces[0].size() == 2)
     {
         tmp = pieces[0].toInt(&localOk);
@@ -655,7 +1230,7 @@ double SubtitleParser::timecodeToDouble(const QString &timecode, bool *ok) const
     timeDouble += tmp * SECONDS_IN_MINUTE;
 
     /* Get Hours */
-    if (pieces.length() == 4)
+    if (count == 4)
     {
         tmp = pieces[3].toInt(&localOk);
         if (!localOk || tmp < 0)
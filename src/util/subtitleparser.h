@@ -22,11 +22,12 @@
 #define SUBTITLEPARSER_H
 
 #include <QList>
-#include <QRegularExpression>
-#include <QSet>
 #include <QString>
+#include <QStringView>
 
-class QFile;
+#include <functional>
+
+class LineReader;
 
 /**
  * Information about a subtitle.
@@ -60,45 +61,116 @@ struct SubtitleInfo
 };
 
 /**
- * Object for parsing subtitles of various formats.
+ * Object for parsing subtitles of various formats. Subtitle files are mapped
+ * into memory, decoded once, and scanned in place, so the only strings
+ * allocated are the texts of the subtitles themselves. Large files are split
+ * at cue boundaries and the pieces are parsed concurrently.
  */
 class SubtitleParser
 {
 public:
-    SubtitleParser();
+    /**
+     * Receives the subtitles of a file a chunk at a time. Chunks are handed
+     * over in file order and each is sorted by start time, but chunks are not
+     * sorted relative to each other. Called from the parsing thread.
+     */
+    using ChunkHandler = std::function<void(const QList<SubtitleInfo> &)>;
 
     /**
      * Parses the subtitles at the given path if possible and returns text,
      * start, and end times for each subtitle.
-     * @param path     The path to the subtitle.
+     * @param path    The path to the subtitle.
+     * @param handler If set, called with the subtitles of each chunk as soon
+     *                as it and every chunk before it are parsed. A file that
+     *                fails to parse part way through may have already handed
+     *                over some chunks.
      * @return A list of SubtitleInfos extracted from the subtitle file.
      */
-    QList<SubtitleInfo> parseSubtitles(const QString &path) const;
+    QList<SubtitleInfo> parseSubtitles(
+        const QString &path,
+        const ChunkHandler &handler = ChunkHandler()) const;
+
+    /**
+     * Removes ASS override blocks ({\...}) and replaces \n and \N with
+     * newlines.
+     * @param text The text field of an ASS dialogue line.
+     * @return The text without formatting.
+     */
+    static QString filterASSText(QStringView text);
 
 private:
     /**
-     * Parses ASS subtitles.
-     * @param      file The file containing the raw ass.
-     * @param[out] out  The list the resulting SubtitleInfos are saved to.
+     * The positions of the fields in ASS dialogue lines.
+     */
+    struct ASSFormat
+    {
+        /* The index of the start time field */
+        int start = -1;
+
+        /* The index of the end time field */
+        int end = -1;
+
+        /* The index of the text field */
+        int text = -1;
+
+        /* The number of fields */
+        int size = 0;
+    };
+
+    /**
+     * Parses everything in an ASS file before the first dialogue line.
+     * @param[in,out] in     The reader at the start of the file. Left at the
+     *                       start of the dialogue lines.
+     * @param[out]    format The layout of the dialogue lines.
      * @return true on success, false on error.
      */
-    bool parseASS(QFile &file, QList<SubtitleInfo> &out) const;
+    static bool parseASSHeader(LineReader &in, ASSFormat &format);
+
+    /**
+     * Parses ASS dialogue lines.
+     * @param      text      Whole lines from the [Events] section.
+     * @param      firstLine The line number of the line before text.
+     * @param      format    The layout of the dialogue lines.
+     * @param[out] out       The list the resulting SubtitleInfos are saved to.
+     * @return true on success, false on error.
+     */
+    static bool parseASSEvents(
+        QStringView text,
+        int firstLine,
+        const ASSFormat &format,
+        QList<SubtitleInfo> &out);
 
     /**
      * Parses SRT subtitles.
-     * @param      file The file containing the raw srt.
-     * @param[out] out  The list the resulting SubtitleInfos are saved to.
+     * @param      text      Whole cues from an srt file.
+     * @param      firstLine The line number of the line before text.
+     * @param[out] out       The list the resulting SubtitleInfos are saved to.
+     * @return true on success, false on error.
+     */
+    static bool parseSRT(
+        QStringView text,
+        int firstLine,
+        QList<SubtitleInfo> &out);
+
+    /**
+     * Parses the header of a VTT file.
+     * @param[in,out] in The reader at the start of the file. Left at the start
+     *                   of the first cue.
      * @return true on success, false on error.
      */
-    bool parseSRT(QFile &file, QList<SubtitleInfo> &out) const;
+    static bool parseVTTHeader(LineReader &in);
 
     /**
-     * Parses VTT subtitles.
-     * @param      file The file containing the raw vtt.
-     * @param[out] out  The list the resulting SubtitleInfos are saved to.
+     * Parses VTT cues.
+     * @param      text      Whole cues from a vtt file after the header.
+     * @param      firstLine The line number of the line before text.
+     * @param[out] out       The list the resulting SubtitleInfos are saved to.
      * @return true on success, false on error.
      */
-    bool parseVTT(QFile &file, QList<SubtitleInfo> &out) const;
+    static bool parseVTT(
+        QStringView text,
+        int firstLine,
+        QList<SubtitleInfo> &out);
 
     /**
      * Converts a timecode of the format HH:MM:SS,MsMsMs
@@ -106,25 +178,7 @@ private:
      * @param[out] ok       Set to true on success, false on error.
      * @return The timecode in seconds.
      */
-    double timecodeToDouble(const QString &timecode, bool *ok = nullptr) const;
-
-    /* The regular expression for splitting timecodes */
-    QRegularExpression m_timecodeSplitter;
-
-    /* Removes ASS styling overrides */
-    QRegularExpression m_assFilter;
-
-    /* Adds newlines to ASS subtitles */
-    QRegularExpression m_assNewLineReplacer;
-
-    /* The regular expression for removing SRT formatting */
-    QRegularExpression m_srtFilter;
-
-    /* Removes everything between angle braces */
-    QRegularExpression m_angleBraceCleaner;
-
-    /* A set of special VTT sections */
-    QSet<QString> m_vttSections;
+    static double timecodeToDouble(QStringView timecode, bool *ok = nullptr);
 };
 
 #endif // SUBTITLEPARSER_H
@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "subtitlesearchindex.h"
+
+#include <algorithm>
+
+#include "textnormalizer.h"
+
+/* Begin Indexing */
+
+void SubtitleSearchIndex::add(int row, QStringView text)
+{
+    const QString folded = TextNormalizer::fold(text);
+    const auto post = [this, row] (uint32_t k)
+    {
+        QList<int> &rows = m_postings[k];
+        if (rows.isEmpty() || rows.last() != row)
+        {
+            rows.append(row);
+        }
+    };
+
+    for (qsizetype i = 0; i < folded.size(); ++i)
+    {
+        post(key(folded[i].unicode()));
+        if (i + 1 < folded.size())
+        {
+            post(key(folded[i].unicode(), folded[i + 1].unicode()));
+        }
+    }
+}
+
+void SubtitleSearchIndex::clear()
+{
+    m_postings.clear();
+}
+
+/* End Indexing */
+/* Begin Searching */
+
+bool SubtitleSearchIndex::candidates(QStringView text, QList<int> &rows) const
+{
+    rows.clear();
+    const QString folded = TextNormalizer::fold(text);
+    if (folded.isEmpty())
+    {
+        return false;
+    }
+
+    /* Every bigram of the text has to be in a matching row. Single characters
+     * only have themselves to go on. */
+    QList<const QList<int> *> postings;
+    for (qsizetype i = 0; i < std::max<qsizetype>(folded.size() - 1, 1); ++i)
+    {
+        const uint32_t k = i + 1 < folded.size() ?
+            key(folded[i].unicode(), folded[i + 1].unicode()) :
+            key(folded[i].unicode());
+        auto it = m_postings.constFind(k);
+        if (it == m_postings.constEnd())
+        {
+            return true;
+        }
+        postings.append(&it.value());
+    }
+
+    /* Walk the rarest bigram and look each row up in the rest */
+    std::sort(postings.begin(), postings.end(),
+        [] (const QList<int> *lhs, const QList<int> *rhs)
+        {
+            return lhs->size() < rhs->size();
+        }
+    );
+    for (int row : *postings.first())
+    {
+        bool found = true;
+        for (qsizetype i = 1; i < postings.size() && found; ++i)
+        {
+            found = std::binary_search(
+                postings[i]->begin(), postings[i]->end(), row
+            );
+        }
+        if (found)
+        {
+            rows.append(row);
+        }
+    }
+
+    return true;
+}
+
+QString SubtitleSearchIndex::requiredLiteral(const QString &pattern)
+{
+    QString best;
+    QString run;
+    const auto finish = [&best, &run]
+    {
+        if (run.size() > best.size())
+        {
+            best = run;
+        }
+        run.clear();
+    };
+
+    int depth = 0;
+    for (qsizetype i = 0; i < pattern.size(); ++i)
+    {
+        switch (pattern[i].unicode())
+        {
+        case '\\':
+            /* Escapes are skipped rather than decoded */
+            finish();
+            ++i;
+            break;
+
+        case '[':
+            finish();
+            ++i;
+            if (i < pattern.size() && pattern[i] == '^')
+            {
+                ++i;
+            }
+            if (i < pattern.size() && pattern[i] == ']')
+            {
+                ++i;
+            }
+            for (; i < pattern.size() && pattern[i] != ']'; ++i)
+            {
+                if (pattern[i] == '\\')
+                {
+                    ++i;
+                }
+            }
+            break;
+
+        case '(':
+            finish();
+            ++depth;
+            break;
+
+        case ')':
+            finish();
+            depth = std::max(depth - 1, 0);
+            break;
+
+        case '|':
+            /* Any branch could match, so nothing is required */
+            if (depth == 0)
+            {
+                return QString();
+            }
+            finish();
+            break;
+
+        case '?':
+        case '*':
+        case '{':
+            /* The character before the quantifier may not appear */
+            run.chop(1);
+            finish();
+            if (pattern[i] == '{')
+            {
+                while (i < pattern.size() && pattern[i] != '}')
+                {
+                    ++i;
+                }
+            }
+            break;
+
+        case '+':
+        case '.':
+        case '^':
+        case '$':
+            finish();
+            break;
+
+        default:
+            if (depth == 0)
+            {
+                run += pattern[i];
+            }
+        }
+    }
+    finish();
+
+    return best;
+}
+
+/* End Searching */
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SUBTITLESEARCHINDEX_H
+#define SUBTITLESEARCHINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+#include <cstdint>
+
+/**
+ * An inverted index from the characters and bigrams of subtitle text to the
+ * rows containing them. Text is folded with TextNormalizer::fold() before it
+ * is indexed, so one index serves case and kana insensitive searches alike.
+ *
+ * The index only narrows a search down to candidate rows. Callers still have
+ * to check each candidate against the text they're looking for.
+ */
+class SubtitleSearchIndex
+{
+public:
+    /**
+     * Adds the text of a row to the index. Rows must be added in ascending
+     * order.
+     * @param row  The row.
+     * @param text The text of the row.
+     */
+    void add(int row, QStringView text);
+
+    /**
+     * Removes every row from the index.
+     */
+    void clear();
+
+    /**
+     * Finds the rows that may contain a piece of text.
+     * @param      text The text to search for. Doesn't need to be folded.
+     * @param[out] rows The candidate rows in ascending order.
+     * @return false if the text is empty and every row is a candidate, true
+     *         otherwise.
+     */
+    bool candidates(QStringView text, QList<int> &rows) const;
+
+    /**
+     * Finds a piece of text that every match of a regular expression must
+     * contain. Only looks at literals outside of groups, classes, and
+     * alternations, so it is often shorter than it could be.
+     * @param pattern The regular expression.
+     * @return The longest required literal, empty if there is none.
+     */
+    [[nodiscard]]
+    static QString requiredLiteral(const QString &pattern);
+
+private:
+    /**
+     * Gets the key of a character or bigram.
+     * @param first  The first code unit.
+     * @param second The second code unit. 0 for a single character.
+     * @return The key.
+     */
+    [[nodiscard]]
+    static inline uint32_t key(char16_t first, char16_t second = 0)
+    {
+        return (uint32_t(first) << 16) | second;
+    }
+
+    /* Maps keys to the rows containing them in ascending order */
+    QHash<uint32_t, QList<int>> m_postings;
+};
+
+#endif // SUBTITLESEARCHINDEX_H
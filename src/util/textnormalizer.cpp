@@ -0,0 +1,452 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "textnormalizer.h"
+
+#include <cstdint>
+#include <cstring>
+
+/* Begin Tables */
+
+#define KANA_BLOCK_SPACE        0x00
+#define HIRAGANA_LOW            0x41
+#define KATAKANA_LOW            0xA0
+
+static constexpr std::array<TextNormalizer::CharacterClass, 0x100>
+buildKanaBlockClasses()
+{
+    std::array<TextNormalizer::CharacterClass, 0x100> classes{};
+    for (size_t i = 0; i < classes.size(); ++i)
+    {
+        if (i == KANA_BLOCK_SPACE)
+        {
+            classes[i] = TextNormalizer::CharacterClass::space;
+        }
+        else if (i >= KATAKANA_LOW)
+        {
+            classes[i] = TextNormalizer::CharacterClass::katakana;
+        }
+        else if (i >= HIRAGANA_LOW)
+        {
+            classes[i] = TextNormalizer::CharacterClass::hiragana;
+        }
+        else
+        {
+            classes[i] = TextNormalizer::CharacterClass::other;
+        }
+    }
+    return classes;
+}
+
+#undef KANA_BLOCK_SPACE
+#undef HIRAGANA_LOW
+#undef KATAKANA_LOW
+
+const std::array<TextNormalizer::CharacterClass, 0x100>
+    TextNormalizer::KANA_BLOCK_CLASSES = buildKanaBlockClasses();
+
+#define MARK_NONE           0x0
+#define MARK_VOICED         0x1
+#define MARK_SEMI_VOICED    0x2
+
+/**
+ * The full-width equivalent of a half-width character and the sound marks
+ * that can be combined with it.
+ */
+struct HalfWidthEntry
+{
+    char16_t full;
+    uint8_t marks;
+};
+
+/* Maps U+FF61 through U+FF9F to their full-width equivalents. Unicode does not
+ * order half-width katakana the same way as full-width katakana, and voiced
+ * half-width katakana are written with a separate sound mark (ｶﾞ), so this
+ * can't be done with offsets alone. */
+static constexpr HalfWidthEntry HALFWIDTH_TABLE[] = {
+    {u'。', MARK_NONE},        /* ｡ */
+    {u'「', MARK_NONE},        /* ｢ */
+    {u'」', MARK_NONE},        /* ｣ */
+    {u'、', MARK_NONE},        /* ､ */
+    {u'・', MARK_NONE},        /* ･ */
+    {u'ヲ', MARK_NONE},        /* ｦ */
+    {u'ァ', MARK_NONE},        /* ｧ */
+    {u'ィ', MARK_NONE},        /* ｨ */
+    {u'ゥ', MARK_NONE},        /* ｩ */
+    {u'ェ', MARK_NONE},        /* ｪ */
+    {u'ォ', MARK_NONE},        /* ｫ */
+    {u'ャ', MARK_NONE},        /* ｬ */
+    {u'ュ', MARK_NONE},        /* ｭ */
+    {u'ョ', MARK_NONE},        /* ｮ */
+    {u'ッ', MARK_NONE},        /* ｯ */
+    {u'ー', MARK_NONE},        /* ｰ */
+    {u'ア', MARK_NONE},        /* ｱ */
+    {u'イ', MARK_NONE},        /* ｲ */
+    {u'ウ', MARK_VOICED},      /* ｳ */
+    {u'エ', MARK_NONE},        /* ｴ */
+    {u'オ', MARK_NONE},        /* ｵ */
+    {u'カ', MARK_VOICED},      /* ｶ */
+    {u'キ', MARK_VOICED},      /* ｷ */
+    {u'ク', MARK_VOICED},      /* ｸ */
+    {u'ケ', MARK_VOICED},      /* ｹ */
+    {u'コ', MARK_VOICED},      /* ｺ */
+    {u'サ', MARK_VOICED},      /* ｻ */
+    {u'シ', MARK_VOICED},      /* ｼ */
+    {u'ス', MARK_VOICED},      /* ｽ */
+    {u'セ', MARK_VOICED},      /* ｾ */
+    {u'ソ', MARK_VOICED},      /* ｿ */
+    {u'タ', MARK_VOICED},      /* ﾀ */
+    {u'チ', MARK_VOICED},      /* ﾁ */
+    {u'ツ', MARK_VOICED},      /* ﾂ */
+    {u'テ', MARK_VOICED},      /* ﾃ */
+    {u'ト', MARK_VOICED},      /* ﾄ */
+    {u'ナ', MARK_NONE},        /* ﾅ */
+    {u'ニ', MARK_NONE},        /* ﾆ */
+    {u'ヌ', MARK_NONE},        /* ﾇ */
+    {u'ネ', MARK_NONE},        /* ﾈ */
+    {u'ノ', MARK_NONE},        /* ﾉ */
+    {u'ハ', MARK_VOICED | MARK_SEMI_VOICED}, /* ﾊ */
+    {u'ヒ', MARK_VOICED | MARK_SEMI_VOICED}, /* ﾋ */
+    {u'フ', MARK_VOICED | MARK_SEMI_VOICED}, /* ﾌ */
+    {u'ヘ', MARK_VOICED | MARK_SEMI_VOICED}, /* ﾍ */
+    {u'ホ', MARK_VOICED | MARK_SEMI_VOICED}, /* ﾎ */
+    {u'マ', MARK_NONE},        /* ﾏ */
+    {u'ミ', MARK_NONE},        /* ﾐ */
+    {u'ム', MARK_NONE},        /* ﾑ */
+    {u'メ', MARK_NONE},        /* ﾒ */
+    {u'モ', MARK_NONE},        /* ﾓ */
+    {u'ヤ', MARK_NONE},        /* ﾔ */
+    {u'ユ', MARK_NONE},        /* ﾕ */
+    {u'ヨ', MARK_NONE},        /* ﾖ */
+    {u'ラ', MARK_NONE},        /* ﾗ */
+    {u'リ', MARK_NONE},        /* ﾘ */
+    {u'ル', MARK_NONE},        /* ﾙ */
+    {u'レ', MARK_NONE},        /* ﾚ */
+    {u'ロ', MARK_NONE},        /* ﾛ */
+    {u'ワ', MARK_NONE},        /* ﾜ */
+    {u'ン', MARK_NONE},        /* ﾝ */
+    {u'゛', MARK_NONE},        /* ﾞ */
+    {u'゜', MARK_NONE},        /* ﾟ */
+};
+
+/* End Tables */
+/* Begin Classification */
+
+#define KANJI_COMMON_LOW        0x4E00
+#define KANJI_COMMON_HIGH       0x9FAF
+#define KANJI_RARE_LOW          0x3400
+#define KANJI_RARE_HIGH         0x4DBF
+#define HALFWIDTH_KANA_LOW      0xFF66
+#define HALFWIDTH_KANA_HIGH     0xFF9F
+
+TextNormalizer::CharacterClass TextNormalizer::classifySlow(char16_t code)
+{
+    if ((KANJI_COMMON_LOW <= code && code <= KANJI_COMMON_HIGH) ||
+        (KANJI_RARE_LOW <= code && code <= KANJI_RARE_HIGH))
+    {
+        return CharacterClass::kanji;
+    }
+    else if (HALFWIDTH_KANA_LOW <= code && code <= HALFWIDTH_KANA_HIGH)
+    {
+        return CharacterClass::katakana;
+    }
+    else if (QChar::isSpace(code))
+    {
+        return CharacterClass::space;
+    }
+    return CharacterClass::other;
+}
+
+#undef KANJI_COMMON_LOW
+#undef KANJI_COMMON_HIGH
+#undef KANJI_RARE_LOW
+#undef KANJI_RARE_HIGH
+#undef HALFWIDTH_KANA_LOW
+#undef HALFWIDTH_KANA_HIGH
+
+void TextNormalizer::classify(QStringView text, CharacterClass *classes)
+{
+    for (qsizetype i = 0; i < text.size(); ++i)
+    {
+        classes[i] = classify(text[i]);
+    }
+}
+
+/* End Classification */
+/* Begin Normalization */
+
+/* Masks that test four UTF-16 code units at once */
+#define ASCII_MASK              0xFF80FF80FF80FF80ULL
+#define BLOCK_MASK              0xFF00FF00FF00FF00ULL
+#define KANA_BLOCK              0x3000300030003000ULL
+#define UNITS_PER_BLOCK         4
+
+/* The most UTF-8 bytes a single UTF-16 code unit can encode to */
+#define MAX_UTF8_PER_UNIT       3
+
+#define HALFWIDTH_LOW           0xFF61
+#define HALFWIDTH_HIGH          0xFF9F
+#define HALFWIDTH_VOICED        0xFF9E
+#define HALFWIDTH_SEMI_VOICED   0xFF9F
+#define KATAKANA_U              0x30A6
+#define KATAKANA_VU             0x30F4
+#define KATAKANA_CONVERT_LOW    0x30A1
+#define KATAKANA_CONVERT_HIGH   0x30F6
+#define KATAKANA_TO_HIRAGANA    0x60
+#define REPLACEMENT_CHARACTER   0xFFFD
+
+/**
+ * Writes a code point in the Basic Multilingual Plane as UTF-8.
+ * @param dst  The buffer to write to.
+ * @param code The code point to write.
+ * @return A pointer to the byte after the last byte written.
+ */
+static inline char *writeUtf8(char *dst, char16_t code)
+{
+    if (code < 0x80)
+    {
+        *dst++ = static_cast<char>(code);
+    }
+    else if (code < 0x800)
+    {
+        *dst++ = static_cast<char>(0xC0 | (code >> 6));
+        *dst++ = static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else
+    {
+        *dst++ = static_cast<char>(0xE0 | (code >> 12));
+        *dst++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        *dst++ = static_cast<char>(0x80 | (code & 0x3F));
+    }
+    return dst;
+}
+
+/**
+ * Writes a code point outside of the Basic Multilingual Plane as UTF-8.
+ * @param dst  The buffer to write to.
+ * @param code The code point to write.
+ * @return A pointer to the byte after the last byte written.
+ */
+static inline char *writeUtf8(char *dst, char32_t code)
+{
+    *dst++ = static_cast<char>(0xF0 | (code >> 18));
+    *dst++ = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+    *dst++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+    *dst++ = static_cast<char>(0x80 | (code & 0x3F));
+    return dst;
+}
+
+/**
+ * Converts full-width katakana to hiragana.
+ * @param code The code unit to convert.
+ * @return The hiragana if code is convertible katakana, code otherwise.
+ */
+static inline char16_t toHiragana(char16_t code)
+{
+    if (KATAKANA_CONVERT_LOW <= code && code <= KATAKANA_CONVERT_HIGH)
+    {
+        return code - KATAKANA_TO_HIRAGANA;
+    }
+    return code;
+}
+
+void TextNormalizer::normalize(
+    QStringView text,
+    Variants &out,
+    CharacterClass *classes)
+{
+    const qsizetype size = text.size();
+    const char16_t *src = text.utf16();
+
+    out.exact.resize(size * MAX_UTF8_PER_UNIT);
+    out.katakana.resize(size * MAX_UTF8_PER_UNIT);
+    out.hiragana.resize(size * MAX_UTF8_PER_UNIT);
+    char *exact = out.exact.data();
+    char *katakana = out.katakana.data();
+    char *hiragana = out.hiragana.data();
+    bool containsHalfWidth = false;
+    bool containsKatakana = false;
+
+    qsizetype i = 0;
+    while (i < size)
+    {
+        /* Copy whole blocks of ASCII or kana without checking for half-width
+         * or surrogates. These make up almost all Japanese subtitles. */
+        if (i + UNITS_PER_BLOCK <= size)
+        {
+            uint64_t block;
+            std::memcpy(&block, src + i, sizeof(block));
+            if ((block & ASCII_MASK) == 0)
+            {
+                for (int j = 0; j < UNITS_PER_BLOCK; ++j)
+                {
+                    const char ch = static_cast<char>(src[i + j]);
+                    exact[j] = ch;
+                    katakana[j] = ch;
+                    hiragana[j] = ch;
+                }
+                if (classes)
+                {
+                    for (int j = 0; j < UNITS_PER_BLOCK; ++j)
+                    {
+                        classes[i + j] = classify(QChar(src[i + j]));
+                    }
+                }
+                exact += UNITS_PER_BLOCK;
+                katakana += UNITS_PER_BLOCK;
+                hiragana += UNITS_PER_BLOCK;
+                i += UNITS_PER_BLOCK;
+                continue;
+            }
+            else if ((block & BLOCK_MASK) == KANA_BLOCK)
+            {
+                for (int j = 0; j < UNITS_PER_BLOCK; ++j)
+                {
+                    const char16_t code = src[i + j];
+                    const char16_t hira = toHiragana(code);
+                    containsKatakana |= hira != code;
+                    exact = writeUtf8(exact, code);
+                    katakana = writeUtf8(katakana, code);
+                    hiragana = writeUtf8(hiragana, hira);
+                    if (classes)
+                    {
+                        classes[i + j] = KANA_BLOCK_CLASSES[code & 0xFF];
+                    }
+                }
+                i += UNITS_PER_BLOCK;
+                continue;
+            }
+        }
+
+        const char16_t code = src[i];
+        if (classes)
+        {
+            classes[i] = classify(QChar(code));
+        }
+
+        /* Surrogate pairs are copied to every variant as is */
+        if (QChar::isSurrogate(code))
+        {
+            if (QChar::isHighSurrogate(code) &&
+                i + 1 < size &&
+                QChar::isLowSurrogate(src[i + 1]))
+            {
+                const char32_t full = QChar::surrogateToUcs4(code, src[i + 1]);
+                exact = writeUtf8(exact, full);
+                katakana = writeUtf8(katakana, full);
+                hiragana = writeUtf8(hiragana, full);
+                if (classes)
+                {
+                    classes[i + 1] = classify(QChar(src[i + 1]));
+                }
+                i += 2;
+            }
+            else
+            {
+                const char16_t replacement = REPLACEMENT_CHARACTER;
+                exact = writeUtf8(exact, replacement);
+                katakana = writeUtf8(katakana, replacement);
+                hiragana = writeUtf8(hiragana, replacement);
+                ++i;
+            }
+            continue;
+        }
+
+        exact = writeUtf8(exact, code);
+        char16_t full = code;
+        if (HALFWIDTH_LOW <= code && code <= HALFWIDTH_HIGH)
+        {
+            containsHalfWidth = true;
+
+            const HalfWidthEntry &entry = HALFWIDTH_TABLE[code - HALFWIDTH_LOW];
+            full = entry.full;
+            const char16_t next = i + 1 < size ? src[i + 1] : 0;
+            bool combined = false;
+            if (next == HALFWIDTH_VOICED && (entry.marks & MARK_VOICED))
+            {
+                full = full == KATAKANA_U ? KATAKANA_VU : full + 1;
+                combined = true;
+            }
+            else if (next == HALFWIDTH_SEMI_VOICED &&
+                     (entry.marks & MARK_SEMI_VOICED))
+            {
+                full = full + 2;
+                combined = true;
+            }
+
+            /* The sound mark is part of the same character */
+            if (combined)
+            {
+                ++i;
+                exact = writeUtf8(exact, next);
+                if (classes)
+                {
+                    classes[i] = classify(QChar(next));
+                }
+            }
+        }
+        const char16_t hira = toHiragana(full);
+        containsKatakana |= hira != full;
+        katakana = writeUtf8(katakana, full);
+        hiragana = writeUtf8(hiragana, hira);
+        ++i;
+    }
+
+    out.exact.truncate(exact - out.exact.constData());
+    out.katakana.truncate(katakana - out.katakana.constData());
+    out.hiragana.truncate(hiragana - out.hiragana.constData());
+    out.containsHalfWidth = containsHalfWidth;
+    out.containsKatakana = containsKatakana;
+}
+
+QString TextNormalizer::fold(QStringView text)
+{
+    QString folded = text.toString().toCaseFolded();
+    char16_t *data = reinterpret_cast<char16_t *>(folded.data());
+    for (qsizetype i = 0; i < folded.size(); ++i)
+    {
+        data[i] = toHiragana(data[i]);
+    }
+    return folded;
+}
+
+#undef ASCII_MASK
+#undef BLOCK_MASK
+#undef KANA_BLOCK
+#undef UNITS_PER_BLOCK
+
+#undef MAX_UTF8_PER_UNIT
+
+#undef HALFWIDTH_LOW
+#undef HALFWIDTH_HIGH
+#undef HALFWIDTH_VOICED
+#undef HALFWIDTH_SEMI_VOICED
+#undef KATAKANA_U
+#undef KATAKANA_VU
+#undef KATAKANA_CONVERT_LOW
+#undef KATAKANA_CONVERT_HIGH
+#undef KATAKANA_TO_HIRAGANA
+#undef REPLACEMENT_CHARACTER
+
+#undef MARK_NONE
+#undef MARK_VOICED
+#undef MARK_SEMI_VOICED
+
+/* End Normalization */
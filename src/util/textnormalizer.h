@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026 Ripose
+//
+// This file is part of Memento.
+//
+// Memento is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2 of the License.
+//
+// Memento is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Memento.  If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TEXTNORMALIZER_H
+#define TEXTNORMALIZER_H
+
+#include <QByteArray>
+#include <QChar>
+#include <QString>
+#include <QStringView>
+
+#include <array>
+
+/**
+ * Table driven Japanese text processing. Converts, classifies, and encodes
+ * text in a single pass without building intermediate strings.
+ */
+class TextNormalizer
+{
+public:
+    /**
+     * The script a UTF-16 code unit belongs to.
+     */
+    enum class CharacterClass : uint8_t
+    {
+        other,
+        space,
+        kanji,
+        hiragana,
+        katakana,
+    };
+
+    /**
+     * The UTF-8 encoded variants of a piece of text that are searched for in
+     * the dictionary. Buffers are reused between calls, so keeping one of these
+     * around avoids allocating for every query.
+     */
+    struct Variants
+    {
+        /* The text as is */
+        QByteArray exact;
+
+        /* The text with half-width katakana converted to full-width */
+        QByteArray katakana;
+
+        /* The full-width text with katakana converted to hiragana */
+        QByteArray hiragana;
+
+        /* true if katakana differs from exact, false otherwise */
+        bool containsHalfWidth = false;
+
+        /* true if hiragana differs from katakana, false otherwise */
+        bool containsKatakana = false;
+    };
+
+    /**
+     * Builds every variant of a piece of text in one pass.
+     * @param      text    The text to normalize.
+     * @param[out] out     The variants of the text. Existing buffers are
+     *                     overwritten.
+     * @param[out] classes If not nullptr, must point to text.size() elements.
+     *                     Filled with the class of every code unit in text.
+     */
+    static void normalize(
+        QStringView text,
+        Variants &out,
+        CharacterClass *classes = nullptr);
+
+    /**
+     * Folds a piece of text for case and kana insensitive matching. Text is
+     * case folded and full-width katakana is converted to hiragana.
+     * @param text The text to fold.
+     * @return The folded text.
+     */
+    [[nodiscard]]
+    static QString fold(QStringView text);
+
+    /**
+     * Classifies every code unit in a piece of text.
+     * @param      text    The text to classify.
+     * @param[out] classes Must point to text.size() elements.
+     */
+    static void classify(QStringView text, CharacterClass *classes);
+
+    /**
+     * Classifies a single UTF-16 code unit.
+     * @param ch The code unit to classify.
+     * @return The class of the code unit.
+     */
+    [[nodiscard]]
+    static inline CharacterClass classify(QChar ch)
+    {
+        const char16_t code = ch.unicode();
+        if (code < 0x80)
+        {
+            return code == ' ' || (code >= '\t' && code <= '\r') ?
+                CharacterClass::space : CharacterClass::other;
+        }
+        else if ((code & 0xFF00) == 0x3000)
+        {
+            return KANA_BLOCK_CLASSES[code & 0xFF];
+        }
+        return classifySlow(code);
+    }
+
+private:
+    TextNormalizer() {}
+
+    /**
+     * Classifies a code unit outside of ASCII and the kana block.
+     * @param code The code unit to classify.
+     * @return The class of the code unit.
+     */
+    [[nodiscard]]
+    static CharacterClass classifySlow(char16_t code);
+
+    /* The classes of the code units from U+3000 to U+30FF */
+    static const std::array<CharacterClass, 0x100> KANA_BLOCK_CLASSES;
+};
+
+#endif // TEXTNORMALIZER_H
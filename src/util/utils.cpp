@@ -38,6 +38,7 @@
 
 #include "constants.h"
 #include "globalmediator.h"
+#include "textnormalizer.h"
 #include "version.h"
 
 /* Begin Directory Utils */
@@ -80,6 +81,25 @@ QString DirectoryUtils::getDictionaryDB()
     return getConfigDir() + DICT_DB_FILE;
 }
 
+QString DirectoryUtils::getDictionaryPack()
+{
+    return getConfigDir() + DICT_PACK_FILE;
+}
+
+QString DirectoryUtils::getSubtitleCacheDir()
+{
+    const QString path = getConfigDir() + SUBTITLE_CACHE_DIR + SLASH;
+    QDir().mkpath(path);
+    return path;
+}
+
+QString DirectoryUtils::getVocabularyCacheDir()
+{
+    const QString path = getConfigDir() + VOCABULARY_CACHE_DIR + SLASH;
+    QDir().mkpath(path);
+    return path;
+}
+
 QString DirectoryUtils::getMpvInputConfig()
 {
     return getConfigDir() + MPV_INPUT_CONF_FILE;
@@ -452,21 +472,10 @@ QString GraphicUtils::generatePitchGraph(
 /* End GraphicUtils */
 /* Begin CharacterUtils */
 
-#define KANJI_UNICODE_LOWER_COMMON  "\u4e00"
-#define KANJI_UNICODE_UPPER_COMMON  "\u9faf"
-#define KANJI_UNICODE_LOWER_RARE    "\u3400"
-#define KANJI_UNICODE_UPPER_RARE    "\u4dbf"
-
-bool CharacterUtils::isKanji(const QString &ch)
+bool CharacterUtils::isKanji(QChar ch)
 {
-    return
-        (ch >= KANJI_UNICODE_LOWER_COMMON && ch <= KANJI_UNICODE_UPPER_COMMON) ||
-        (ch >= KANJI_UNICODE_LOWER_RARE   && ch <= KANJI_UNICODE_UPPER_RARE);
+    return TextNormalizer::classify(ch) ==
+        TextNormalizer::CharacterClass::kanji;
 }
 
-#undef KANJI_UNICODE_LOWER_COMMON
-#undef KANJI_UNICODE_UPPER_COMMON
-#undef KANJI_UNICODE_LOWER_RARE
-#undef KANJI_UNICODE_UPPER_RARE
-
 /* End CharacterUtils */
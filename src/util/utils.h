@@ -42,6 +42,15 @@ namespace Constants
 /* Dictionary database file name. */
 #define DICT_DB_FILE        "dictionaries.sqlite"
 
+/* Compiled dictionary term pack file name. */
+#define DICT_PACK_FILE      "dictionaries.pack"
+
+/* Parsed subtitle cache directory name. */
+#define SUBTITLE_CACHE_DIR  "subtitle-cache"
+
+/* Precomputed episode vocabulary cache directory name. */
+#define VOCABULARY_CACHE_DIR "vocabulary-cache"
+
 /* mpv input configuration file name. */
 #define MPV_INPUT_CONF_FILE "input.conf"
 
@@ -76,6 +85,26 @@ public:
      */
     static QString getDictionaryDB();
 
+    /**
+     * Gets the path to the compiled dictionary term pack.
+     * @return Path to the term pack.
+     */
+    static QString getDictionaryPack();
+
+    /**
+     * Gets the directory parsed subtitles are cached in. Creates it if it
+     * doesn't exist.
+     * @return Path to the subtitle cache directory.
+     */
+    static QString getSubtitleCacheDir();
+
+    /**
+     * Gets the directory precomputed episode vocabulary is cached in. Creates
+     * it if it doesn't exist.
+     * @return Path to the vocabulary cache directory.
+     */
+    static QString getVocabularyCacheDir();
+
     /**
      * Gets the path to the mpv input.conf.
      * @return Path to mpv's input.conf.
@@ -168,7 +197,7 @@ public:
      * @param ch The character to check.
      * @return true if the character is kanji, false otherwise.
      */
-    static bool isKanji(const QString &ch);
+    static bool isKanji(QChar ch);
 
 private:
     CharacterUtils() {}